@@ -40,6 +40,15 @@ using systems::OutputVector;
 
 static const int SPACE_DIM = 3;
 
+typedef std::chrono::steady_clock my_clock;
+
+// Add the time since *lap to *total, and restart *lap
+static void AddLap(double* total, my_clock::time_point* lap) {
+  const my_clock::time_point now = my_clock::now();
+  *total += std::chrono::duration<double>(now - *lap).count();
+  *lap = now;
+}
+
 CassieStateEstimator::CassieStateEstimator(
     const MultibodyPlant<double>& plant,
     const KinematicEvaluatorSet<double>* fourbar_evaluator,
@@ -414,7 +423,10 @@ void CassieStateEstimator::AssignNonFloatingBaseStateToOutputVector(
     }
     q[0] = 1;
   }
+  my_clock::time_point lap;
+  if (timings_) lap = my_clock::now();
   solveFourbarLinkage(q, &left_heel_spring, &right_heel_spring);
+  if (timings_) AddLap(&timings_->fourbar, &lap);
   output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_left"),
                              left_heel_spring);
   output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_right"),
@@ -666,8 +678,11 @@ EventStatus CassieStateEstimator::Update(
   // This step is done in AssignNonFloatingBaseStateToOutputVector()
 
   // Step 2 - EKF (Propagate step)
+  my_clock::time_point lap;
+  if (timings_) lap = my_clock::now();
   auto& ekf = state->get_mutable_abstract_state<inekf::InEKF>(ekf_idx_);
   ekf.Propagate(context.get_discrete_state(prev_imu_idx_).get_value(), dt);
+  if (timings_) AddLap(&timings_->ekf_propagate, &lap);
 
   // Print for debugging
   if (print_info_to_terminal_) {
@@ -711,11 +726,18 @@ EventStatus CassieStateEstimator::Update(
       ekf.getState().getVelocity() + omega_global.cross(r_imu_to_pelvis_global);
 
   // Estimated robot output
+  if (timings_) lap = my_clock::now();
+  const double fourbar_time = timings_ ? timings_->fourbar : 0;
   OutputVector<double> filtered_output(n_q_, n_v_, n_u_);
   AssignImuValueToOutputVector(cassie_out, &filtered_output);
   AssignActuationFeedbackToOutputVector(cassie_out, &filtered_output);
   AssignNonFloatingBaseStateToOutputVector(cassie_out, &filtered_output);
   AssignFloatingBaseStateToOutputVector(estimated_fb_state, &filtered_output);
+  if (timings_) {
+    AddLap(&timings_->kinematics, &lap);
+    // The four-bar solve is timed on its own
+    timings_->kinematics -= timings_->fourbar - fourbar_time;
+  }
 
   // Step 3 - Estimate which foot/feet are in contact with the ground
   // Estimate feet contacts
@@ -732,6 +754,7 @@ EventStatus CassieStateEstimator::Update(
   }
   state->get_mutable_discrete_state(contact_forces_idx_).get_mutable_value()
       << lambda_est;
+  if (timings_) AddLap(&timings_->contact, &lap);
 
   // Override hardware_test_mode_ if test mode is 2 and we detect contact
   // Useful for preventing drift when the feet are not fully in contact - i.e
@@ -835,7 +858,9 @@ EventStatus CassieStateEstimator::Update(
            << rear_covariance.block<3, 3>(3, 3) << endl;
     }
   }
+  if (timings_) AddLap(&timings_->kinematics, &lap);
   ekf.CorrectKinematics(measured_kinematics);
+  if (timings_) AddLap(&timings_->ekf_correct, &lap);
 
   if (print_info_to_terminal_) {
     // Print for debugging
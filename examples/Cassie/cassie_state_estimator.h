@@ -47,6 +47,16 @@ namespace systems {
 ///   frame.
 class CassieStateEstimator : public drake::systems::LeafSystem<double> {
  public:
+  /// Time (s) spent in each stage of Update(), summed over the updates
+  struct UpdateTimings {
+    /// Joint state, excluding the four-bar solve, and foot kinematics
+    double kinematics = 0;
+    double fourbar = 0;
+    double ekf_propagate = 0;
+    double contact = 0;
+    double ekf_correct = 0;
+  };
+
   /// Constructor
   /// @param plant MultibodyPlant of the robot
   /// @param test_with_ground_truth_state a flag indicating whether or not the
@@ -122,6 +132,16 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   // because we want the discrete update to happen before Publish
   void set_next_message_time(double t) { next_message_time_ = t; };
 
+  // Estimate the state from the cassie_out_t input, as the update event does.
+  // Public so that logs can be replayed without the Simulator.
+  drake::systems::EventStatus Update(
+      const drake::systems::Context<double>& context,
+      drake::systems::State<double>* state) const;
+
+  // Add the time spent in each stage of the following updates to timings, or
+  // stop timing them if nullptr
+  void set_update_timings(UpdateTimings* timings) { timings_ = timings; }
+
  private:
   void AssignImuValueToOutputVector(const cassie_out_t& cassie_out,
       systems::OutputVector<double>* output) const;
@@ -130,10 +150,6 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   void AssignFloatingBaseStateToOutputVector(const Eigen::VectorXd& state_est,
       systems::OutputVector<double>* output) const;
 
-  drake::systems::EventStatus Update(
-      const drake::systems::Context<double>& context,
-      drake::systems::State<double>* state) const;
-
   void CopyStateOut(const drake::systems::Context<double>& context,
                     systems::OutputVector<double>* output) const;
   void CopyContact(const drake::systems::Context<double>& context,
@@ -230,6 +246,8 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   double next_message_time_ = -std::numeric_limits<double>::infinity();
   double eps_ = 1e-12;
 
+  UpdateTimings* timings_ = nullptr;
+
   // Contacts
   const int num_contacts_ = 2;
   const std::vector<std::string> contact_names_ = {"left", "right"};
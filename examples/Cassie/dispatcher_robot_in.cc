@@ -37,6 +37,9 @@ using std::string;
 DEFINE_string(address, "127.0.0.1", "IPv4 address to publish to (UDP).");
 DEFINE_int64(port, 25000, "Port to publish to (UDP).");
 DEFINE_double(pub_rate, .02, "Network LCM pubishing period (s).");
+DEFINE_int32(udp_io_cpu, -1,
+             "CPU to pin the thread sending UDP to Cassie to. Negative keeps "
+             "the default affinity.");
 DEFINE_string(
     cassie_out_channel, "CASSIE_OUTPUT_ECHO",
     "The name of the channel to receive the cassie out structure from.");
@@ -54,6 +57,9 @@ DEFINE_string(control_channel_name_2, "OSC_STANDING",
               "The name of the lcm channel that sends Cassie's state");
 DEFINE_string(control_channel_name_3, "OSC_WALKING",
               "The name of the lcm channel that sends Cassie's state");
+DEFINE_string(trace_channel, "",
+              "LCM channel to publish pipeline latency traces on. Empty "
+              "disables tracing.");
 
 // Cassie model parameter
 DEFINE_bool(floating_base, true, "Fixed or floating base model");
@@ -124,8 +130,12 @@ int do_main(int argc, char* argv[]) {
                   input_translator->get_input_port(0));
 
   // Create and connect input publisher.
+  systems::RealtimeOptions udp_io_options;
+  if (FLAGS_udp_io_cpu >= 0) {
+    udp_io_options.cpus.push_back(FLAGS_udp_io_cpu);
+  }
   auto input_pub = builder.AddSystem(systems::CassieUDPPublisher::Make(
-      FLAGS_address, FLAGS_port, {TriggerType::kForced}));
+      FLAGS_address, FLAGS_port, {TriggerType::kForced}, 0, udp_io_options));
   builder.Connect(*input_translator, *input_pub);
 
   // Create and connect LCM command echo to network
@@ -155,6 +165,9 @@ int do_main(int argc, char* argv[]) {
                          dairlib::lcmt_controller_switch>
       loop(&lcm_local, std::move(owned_diagram), command_receiver,
            input_channels, FLAGS_control_channel_name_1, switch_channel, true);
+  if (!FLAGS_trace_channel.empty()) {
+    loop.EnableTracing("dispatcher_robot_in", FLAGS_trace_channel);
+  }
   loop.Simulate();
 
   return 0;
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <memory>
 
 #include <gflags/gflags.h>
@@ -14,6 +15,7 @@
 #include "multibody/multibody_solvers.h"
 #include "multibody/multibody_utils.h"
 #include "systems/framework/output_vector.h"
+#include "systems/framework/pipeline_tracer.h"
 #include "systems/primitives/subvector_pass_through.h"
 #include "systems/robot_lcm_systems.h"
 
@@ -40,7 +42,9 @@ using Eigen::Matrix3d;
 using Eigen::Vector3d;
 
 // Simulation parameters.
-DEFINE_string(address, "127.0.0.1", "IPv4 address to receive on.");
+DEFINE_string(address, "",
+              "IPv4 address to receive on. Empty receives on every "
+              "interface.");
 DEFINE_int64(port, 25001, "Port to receive on.");
 DEFINE_double(pub_rate, 0.02, "Network LCM pubishing period (s).");
 DEFINE_bool(simulation, false,
@@ -48,6 +52,9 @@ DEFINE_bool(simulation, false,
 DEFINE_bool(test_with_ground_truth_state, false,
             "Get floating base from ground truth state for testing");
 DEFINE_bool(print_ekf_info, false, "Print ekf information to the terminal");
+DEFINE_string(trace_channel, "",
+              "LCM channel to publish pipeline latency traces on. Empty "
+              "disables tracing.");
 
 // TODO(yminchen): delete the flag state_channel_name after finishing testing
 // cassie_state_estimator
@@ -294,6 +301,12 @@ int do_main(int argc, char* argv[]) {
   drake::systems::Simulator<double> simulator(std::move(owned_diagram));
   auto& diagram_context = simulator.get_mutable_context();
 
+  std::unique_ptr<systems::PipelineTracer> tracer;
+  if (!FLAGS_trace_channel.empty()) {
+    tracer = std::make_unique<systems::PipelineTracer>(
+        &lcm_local, "dispatcher_robot_out", FLAGS_trace_channel);
+  }
+
   if (FLAGS_simulation) {
     auto& input_receiver_context =
         diagram.GetMutableSubsystemContext(*input_receiver, &diagram_context);
@@ -331,6 +344,10 @@ int do_main(int argc, char* argv[]) {
       // Write the lcmt_robot_input message into the context and advance.
       input_value.GetMutableData()->set_value(input_sub.message());
       const double time = input_sub.message().utime * 1e-6;
+      if (tracer != nullptr) {
+        // Traced by the utime of the published lcmt_robot_output
+        tracer->Receive(std::llround(time * 1e6));
+      }
 
       // Check if we are very far ahead or behind
       // (likely due to a restart of the driving clock)
@@ -348,6 +365,9 @@ int do_main(int argc, char* argv[]) {
       simulator.AdvanceTo(time);
       // Force-publish via the diagram
       diagram.Publish(diagram_context);
+      if (tracer != nullptr) {
+        tracer->Publish();
+      }
     }
   } else {
     auto& output_sender_context =
@@ -379,6 +399,10 @@ int do_main(int argc, char* argv[]) {
       output_sender_value.GetMutableData()->set_value(udp_sub.message());
       state_estimator_value.GetMutableData()->set_value(udp_sub.message());
       const double time = udp_sub.message_time();
+      if (tracer != nullptr) {
+        // Traced by the utime of the published lcmt_robot_output
+        tracer->Receive(std::llround(time * 1e6));
+      }
 
       // Check if we are very far ahead or behind
       // (likely due to a restart of the driving clock)
@@ -396,6 +420,9 @@ int do_main(int argc, char* argv[]) {
       simulator.AdvanceTo(time);
       // Force-publish via the diagram
       diagram.Publish(diagram_context);
+      if (tracer != nullptr) {
+        tracer->Publish();
+      }
     }
   }
   return 0;
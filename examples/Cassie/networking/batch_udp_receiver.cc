@@ -0,0 +1,156 @@
+#include "examples/Cassie/networking/batch_udp_receiver.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/drake_throw.h"
+
+namespace dairlib {
+
+using std::chrono::steady_clock;
+using std::chrono::system_clock;
+
+namespace {
+
+const int kControlSize = CMSG_SPACE(sizeof(timespec));
+
+// Whether the datagram with sequence number a is newer than, or the same as,
+// the one with b, allowing for wrapping
+bool IsNewer(uint8_t a, uint8_t b) {
+  return static_cast<int8_t>(a - b) >= 0;
+}
+
+}  // namespace
+
+BatchUdpReceiver::BatchUdpReceiver(const std::string& address, int port,
+                                   int payload_size)
+    : packet_size_(kHeaderSize + payload_size),
+      buffers_((kBatchSize + 1) * packet_size_),
+      iovecs_(kBatchSize),
+      controls_(kBatchSize * kControlSize),
+      headers_(kBatchSize) {
+  DRAKE_DEMAND(payload_size > 0);
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  DRAKE_THROW_UNLESS(socket_ >= 0);
+  const int enable = 1;
+  DRAKE_THROW_UNLESS(setsockopt(socket_, SOL_SOCKET, SO_TIMESTAMPNS, &enable,
+                                sizeof(enable)) == 0);
+
+  sockaddr_in server_address;
+  memset(&server_address, 0, sizeof(server_address));
+  if (address.empty()) {
+    server_address.sin_addr.s_addr = htonl(INADDR_ANY);
+  } else {
+    DRAKE_THROW_UNLESS(
+        inet_aton(address.c_str(), &server_address.sin_addr) != 0);
+  }
+  server_address.sin_family = AF_INET;
+  server_address.sin_port = htons(port);
+  DRAKE_THROW_UNLESS(bind(socket_,
+                          reinterpret_cast<const sockaddr*>(&server_address),
+                          sizeof(server_address)) == 0);
+
+  for (int i = 0; i < kBatchSize; i++) {
+    iovecs_[i].iov_base = &buffers_[i * packet_size_];
+    iovecs_[i].iov_len = packet_size_;
+    msghdr& header = headers_[i].msg_hdr;
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = &iovecs_[i];
+    header.msg_iovlen = 1;
+    header.msg_control = &controls_[i * kControlSize];
+  }
+  current_ = &buffers_[kBatchSize * packet_size_];
+  receive_time_ = steady_clock::now();
+}
+
+BatchUdpReceiver::~BatchUdpReceiver() { close(socket_); }
+
+bool BatchUdpReceiver::Receive(int timeout_ms) {
+  bool received = false;
+  while (true) {
+    for (mmsghdr& header : headers_) {
+      header.msg_hdr.msg_controllen = kControlSize;
+    }
+    const int num_messages = recvmmsg(socket_, headers_.data(), kBatchSize,
+                                      MSG_DONTWAIT, nullptr);
+    if (num_messages < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        throw std::runtime_error(std::string("recvmmsg failed: ") +
+                                 strerror(errno));
+      }
+      if (received) {
+        break;
+      }
+      pollfd fd = {socket_, POLLIN, 0};
+      if (poll(&fd, 1, timeout_ms) <= 0) {
+        return false;
+      }
+      continue;
+    }
+
+    auto sequence_number = [this](int i) {
+      return static_cast<const uint8_t*>(iovecs_[i].iov_base)[0];
+    };
+    int newest = -1;
+    for (int i = 0; i < num_messages; i++) {
+      if (static_cast<int>(headers_[i].msg_len) != packet_size_ ||
+          (headers_[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+        num_discarded_++;
+        continue;
+      }
+      num_received_++;
+      if (newest < 0 || IsNewer(sequence_number(i), sequence_number(newest))) {
+        newest = i;
+      }
+    }
+    if (newest >= 0) {
+      uint8_t* buffer = static_cast<uint8_t*>(iovecs_[newest].iov_base);
+      if (!received || IsNewer(buffer[0], current_[0])) {
+        receive_time_ = ReadReceiveTime(headers_[newest].msg_hdr);
+        iovecs_[newest].iov_base = current_;
+        current_ = buffer;
+      }
+      received = true;
+    }
+    // A partial batch emptied the socket
+    if (received && num_messages < kBatchSize) {
+      break;
+    }
+  }
+  num_returned_++;
+  return true;
+}
+
+steady_clock::time_point BatchUdpReceiver::ReadReceiveTime(
+    const msghdr& header) {
+  const steady_clock::time_point now = steady_clock::now();
+  for (cmsghdr* control = CMSG_FIRSTHDR(&header); control != nullptr;
+       control = CMSG_NXTHDR(const_cast<msghdr*>(&header), control)) {
+    if (control->cmsg_level == SOL_SOCKET &&
+        control->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec stamp;
+      memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+      const auto received = system_clock::time_point(
+          std::chrono::duration_cast<system_clock::duration>(
+              std::chrono::seconds(stamp.tv_sec) +
+              std::chrono::nanoseconds(stamp.tv_nsec)));
+      // The kernel stamps with the real-time clock, so convert by the age
+      return now - std::chrono::duration_cast<steady_clock::duration>(
+                       system_clock::now() - received);
+    }
+  }
+  return now;
+}
+
+}  // namespace dairlib
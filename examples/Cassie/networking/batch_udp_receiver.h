@@ -0,0 +1,93 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Receives fixed-size UDP datagrams that start with the two byte header of
+/// the Cassie UDP protocol, whose first byte is the wrapping sequence number
+/// of the sender.
+///
+/// Receive() drains every queued datagram with recvmmsg, up to kBatchSize per
+/// system call, and keeps only the newest one by sequence number, so that a
+/// slow reader catches up in one call instead of reading one stale datagram
+/// at a time. Datagrams of the wrong size are discarded. The kernel receive
+/// time of the datagrams is recorded with SO_TIMESTAMPNS, so that it does not
+/// include the time the datagram waited in the socket. Nothing is allocated
+/// after construction.
+class BatchUdpReceiver final {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(BatchUdpReceiver)
+
+  static constexpr int kHeaderSize = 2;
+  static constexpr int kBatchSize = 16;
+
+  /// Binds a socket to address, or to every interface if address is empty,
+  /// and port, receiving datagrams of kHeaderSize + payload_size bytes
+  BatchUdpReceiver(const std::string& address, int port, int payload_size);
+
+  ~BatchUdpReceiver();
+
+  /// Waits for at most timeout_ms, or indefinitely if negative, for a valid
+  /// datagram, then drains the socket. Returns whether a datagram was
+  /// received, which is then the current one, or false on timeout or signal.
+  bool Receive(int timeout_ms = -1);
+
+  /// Payload of the current datagram, following its header
+  const uint8_t* payload() const { return current_ + kHeaderSize; }
+  int payload_size() const { return packet_size_ - kHeaderSize; }
+
+  /// Sequence number in the header of the current datagram
+  uint8_t sequence_number() const { return current_[0]; }
+
+  /// Time at which the kernel received the current datagram, converted to
+  /// std::chrono::steady_clock, or the time it was read if the kernel did not
+  /// provide one
+  std::chrono::steady_clock::time_point receive_time() const {
+    return receive_time_;
+  }
+
+  /// Number of valid datagrams received, including skipped ones
+  int64_t num_received() const { return num_received_; }
+
+  /// Number of valid datagrams that were superseded by a newer one before
+  /// Receive() returned them
+  int64_t num_skipped() const { return num_received_ - num_returned_; }
+
+  /// Number of datagrams discarded for their size
+  int64_t num_discarded() const { return num_discarded_; }
+
+  int socket() const { return socket_; }
+
+ private:
+  // Reads the receive time of the datagram in header, as steady_clock
+  static std::chrono::steady_clock::time_point ReadReceiveTime(
+      const msghdr& header);
+
+  int socket_;
+  const int packet_size_;
+
+  // kBatchSize + 1 buffers, of which kBatchSize are given to recvmmsg through
+  // iovecs_ and one holds the current datagram. The buffer of the newest
+  // datagram of a batch is swapped with the current one instead of copied.
+  std::vector<uint8_t> buffers_;
+  std::vector<iovec> iovecs_;
+  std::vector<uint8_t> controls_;
+  std::vector<mmsghdr> headers_;
+  uint8_t* current_;
+
+  std::chrono::steady_clock::time_point receive_time_;
+  int64_t num_received_ = 0;
+  int64_t num_returned_ = 0;
+  int64_t num_discarded_ = 0;
+};
+
+}  // namespace dairlib
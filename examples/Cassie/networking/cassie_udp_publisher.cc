@@ -18,10 +18,10 @@ const int kPortIndex = 0;
 
 CassieUDPPublisher::CassieUDPPublisher(const std::string& address,
       const int port, const UDPTriggerTypes& publish_triggers,
-      double publish_period)
+      double publish_period, const RealtimeOptions& io_thread_options)
     : address_(address),
       port_(port),
-      serializer_(std::make_unique<CassieUDPInSerializer>()) {
+      sender_(address, port, io_thread_options) {
   DRAKE_DEMAND(publish_period >= 0.0);
   DRAKE_DEMAND(!publish_triggers.empty());
 
@@ -32,16 +32,6 @@ CassieUDPPublisher::CassieUDPPublisher(const std::string& address,
         (trigger == TriggerType::kPerStep));
   }
 
-  // Creating socket file descriptor
-  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
-
-  memset(&server_address_, 0, sizeof(server_address_));
-
-  // Filling server information
-  inet_aton(address_.c_str(), &server_address_.sin_addr);
-  server_address_.sin_family = AF_INET;  // IPv4
-  server_address_.sin_port = htons(port);
-
   // Declare a forced publish so that any time Publish(.) is called on this
   // system (or a Diagram containing it), a message is emitted.
   if (publish_triggers.find(TriggerType::kForced) != publish_triggers.end()) {
@@ -49,8 +39,9 @@ CassieUDPPublisher::CassieUDPPublisher(const std::string& address,
       &CassieUDPPublisher::PublishInputAsUDPMessage);
   }
 
+  // Value-initialized, so that the POD fields are zeroed
   DeclareAbstractInputPort("cassie_user_in_t",
-      *serializer_->CreateDefaultValue());
+      drake::Value<cassie_user_in_t>(cassie_user_in_t{}));
 
   set_name(make_name(address, port));
 
@@ -97,18 +88,12 @@ drake::systems::EventStatus CassieUDPPublisher::PublishInputAsUDPMessage(
     const drake::systems::Context<double>& context) const {
   SPDLOG_TRACE(drake::log(), "Publishing UDP {} message", address_);
 
-  // Converts the input into message bytes.
-  const drake::AbstractValue* const input_value =
-      this->EvalAbstractInput(context, kPortIndex);
-  DRAKE_ASSERT(input_value != nullptr);
-  std::vector<uint8_t> message_bytes;
-
-  serializer_->Serialize(*input_value, &message_bytes);
-
-  int result = sendto(socket_, message_bytes.data(),
-      message_bytes.size(), 0,
-      (struct sockaddr *)&server_address_, sizeof(server_address_));
-  DRAKE_THROW_UNLESS(result >= 0);
+  // Packs the input into the next queued packet.
+  const auto& message = this->EvalAbstractInput(context, kPortIndex)
+                            ->get_value<cassie_user_in_t>();
+  if (!sender_.Send(message)) {
+    SPDLOG_TRACE(drake::log(), "Dropped UDP {} message", address_);
+  }
   return drake::systems::EventStatus::Succeeded();
 }
 
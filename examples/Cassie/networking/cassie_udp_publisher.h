@@ -14,7 +14,7 @@
 #include "drake/common/drake_deprecated.h"
 #include "drake/common/drake_throw.h"
 #include "drake/systems/framework/leaf_system.h"
-#include "examples/Cassie/networking/udp_serializer.h"
+#include "examples/Cassie/networking/cassie_udp_sender.h"
 
 
 namespace dairlib {
@@ -30,6 +30,10 @@ using UDPTriggerTypes =
  * Publishing "by force", through
  * `CassieUDPPublisher::Publish(const Context&)`, is also enabled.
  *
+ * Publishing only packs the input into a preallocated packet, which a
+ * CassieUdpSender sends from its own I/O thread, so that it neither
+ * allocates nor blocks on the socket.
+ *
  * @ingroup message_passing
  */
 class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
@@ -50,14 +54,18 @@ class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
    * If the publish period is zero, CassieUDPPublisher will use per-step
    * publishing instead; see LeafSystem::DeclarePerStepPublishEvent().
    *
+   * @param io_thread_options Configuration of the thread that sends the
+   * messages, e.g. to pin it to a CPU (optional).
+   *
    * @pre publish_period is non-negative.
    * @pre publish_period > iff publish_triggers contains kPeriodic
    */
   static std::unique_ptr<CassieUDPPublisher> Make(const std::string& address,
       const int port, const UDPTriggerTypes& publish_triggers,
-      double publish_period = 0.0) {
+      double publish_period = 0.0,
+      const RealtimeOptions& io_thread_options = {}) {
     return std::make_unique<CassieUDPPublisher>(address, port, publish_triggers,
-        publish_period);
+        publish_period, io_thread_options);
   }
 
 /**
@@ -94,10 +102,14 @@ class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
    * If the publish period is zero, CassieUDPPublisher will use per-step
    * publishing instead; see LeafSystem::DeclarePerStepPublishEvent().
    *
+   * @param io_thread_options Configuration of the thread that sends the
+   * messages, e.g. to pin it to a CPU (optional).
+   *
    * @pre publish_period is non-negative.
    */
   CassieUDPPublisher(const std::string& address, const int port,
-      const UDPTriggerTypes& publish_triggers, double publish_period = 0.0);
+      const UDPTriggerTypes& publish_triggers, double publish_period = 0.0,
+      const RealtimeOptions& io_thread_options = {});
 
 
   /**
@@ -145,11 +157,9 @@ class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
   // The IP address to which to publish UDP messages.
   const std::string address_;
   const int port_;
-  struct sockaddr_in server_address_;
-  int socket_;
 
-  // Converts Value<cassie_user_in_t> objects into UDP message bytes.
-  std::unique_ptr<CassieUDPInSerializer> serializer_;
+  // Packs the cassie_user_in_t inputs and sends them.
+  mutable CassieUdpSender sender_;
 };
 
 }  // namespace systems
@@ -0,0 +1,127 @@
+#include "examples/Cassie/networking/cassie_udp_sender.h"
+
+#include <arpa/inet.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "drake/common/drake_throw.h"
+#include "drake/common/text_logging.h"
+
+namespace dairlib {
+namespace systems {
+
+namespace {
+
+void Futex(std::atomic<uint32_t>* address, int operation, uint32_t value) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), operation, value,
+          nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+CassieUdpSender::CassieUdpSender(const std::string& address, int port,
+                                 const RealtimeOptions& io_thread_options) {
+  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+  DRAKE_THROW_UNLESS(socket_ >= 0);
+  memset(&address_, 0, sizeof(address_));
+  DRAKE_THROW_UNLESS(inet_aton(address.c_str(), &address_.sin_addr) != 0);
+  address_.sin_family = AF_INET;
+  address_.sin_port = htons(port);
+  memset(packets_, 0, sizeof(packets_));
+
+  thread_ = std::thread(&CassieUdpSender::Run, this, io_thread_options);
+}
+
+CassieUdpSender::~CassieUdpSender() {
+  stop_.store(true);
+  doorbell_.fetch_add(1);
+  Futex(&doorbell_, FUTEX_WAKE_PRIVATE, 1);
+  thread_.join();
+  close(socket_);
+}
+
+bool CassieUdpSender::Send(const cassie_user_in_t& message) {
+  const uint32_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == kQueueSize) {
+    num_dropped_++;
+    return false;
+  }
+  uint8_t* packet = packets_[tail % kQueueSize].data;
+  packet[0] = ++sequence_number_;
+  packet[1] = 0;
+  pack_cassie_user_in_t(&message, &packet[2]);
+  tail_.store(tail + 1);
+  // Either the I/O thread sees the new tail before sleeping, or this sees
+  // that it sleeps and rings the doorbell
+  if (waiting_.load()) {
+    doorbell_.fetch_add(1);
+    Futex(&doorbell_, FUTEX_WAKE_PRIVATE, 1);
+  }
+  return true;
+}
+
+void CassieUdpSender::Run(const RealtimeOptions& options) {
+  ConfigureRealtimeThread(options);
+
+  iovec iovecs[kQueueSize];
+  mmsghdr headers[kQueueSize];
+  memset(headers, 0, sizeof(headers));
+  for (int i = 0; i < kQueueSize; i++) {
+    iovecs[i].iov_len = kPacketSize;
+    headers[i].msg_hdr.msg_name = &address_;
+    headers[i].msg_hdr.msg_namelen = sizeof(address_);
+    headers[i].msg_hdr.msg_iov = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  uint32_t head = head_.load();
+  while (true) {
+    const uint32_t doorbell = doorbell_.load();
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (stop_.load()) {
+        break;
+      }
+      waiting_.store(true);
+      if (tail_.load() == head && !stop_.load()) {
+        Futex(&doorbell_, FUTEX_WAIT_PRIVATE, doorbell);
+      }
+      waiting_.store(false);
+      continue;
+    }
+
+    const int num_packets = tail - head;
+    for (int i = 0; i < num_packets; i++) {
+      iovecs[i].iov_base = packets_[(head + i) % kQueueSize].data;
+    }
+    const int num_sent = sendmmsg(socket_, headers, num_packets, MSG_DONTWAIT);
+    if (num_sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        pollfd fd = {socket_, POLLOUT, 0};
+        poll(&fd, 1, 100);
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      // Drop the first packet, which the socket refuses
+      if (num_failed_++ == 0) {
+        drake::log()->warn("Could not send to Cassie: {}", strerror(errno));
+      }
+      head++;
+    } else {
+      num_sent_ += num_sent;
+      head += num_sent;
+    }
+    head_.store(head, std::memory_order_release);
+  }
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "drake/common/drake_copyable.h"
+#include "examples/Cassie/datatypes/cassie_user_in_t.h"
+#include "systems/framework/realtime.h"
+
+namespace dairlib {
+namespace systems {
+
+/// Sends cassie_user_in_t packets to Cassie from a dedicated I/O thread, so
+/// that the thread calling Send() never blocks on the socket nor allocates.
+///
+/// Send() packs the message, after the two byte header of the Cassie UDP
+/// protocol, directly into the next packet of a single-producer
+/// single-consumer ring of preallocated, cache line aligned packets. The I/O
+/// thread sends every queued packet with a single sendmmsg call, and sleeps
+/// on a futex that Send() only wakes while the I/O thread sleeps. When the
+/// ring is full, Send() drops the message instead of waiting.
+class CassieUdpSender {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(CassieUdpSender)
+
+  static constexpr int kQueueSize = 16;
+  static constexpr int kPacketSize = 2 + CASSIE_USER_IN_T_LEN;
+
+  /// Sends to address and port. io_thread_options configures the I/O thread,
+  /// typically to pin it to a CPU that the control thread does not use.
+  CassieUdpSender(const std::string& address, int port,
+                  const RealtimeOptions& io_thread_options = {});
+
+  /// Sends the queued packets and stops the I/O thread
+  ~CassieUdpSender();
+
+  /// Queues message, numbered by the first header byte. Returns false if the
+  /// queue is full and the message is dropped. Only one thread may call it.
+  bool Send(const cassie_user_in_t& message);
+
+  /// Number of packets sent so far
+  int64_t num_sent() const { return num_sent_; }
+
+  /// Number of messages dropped because the queue was full
+  int64_t num_dropped() const { return num_dropped_; }
+
+  /// Number of packets that the socket failed to send
+  int64_t num_failed() const { return num_failed_; }
+
+ private:
+  struct alignas(64) Packet {
+    uint8_t data[kPacketSize];
+  };
+
+  void Run(const RealtimeOptions& options);
+
+  int socket_;
+  sockaddr_in address_;
+  Packet packets_[kQueueSize];
+  uint8_t sequence_number_ = 0;
+
+  // Numbers of packets queued, by Send(), and taken, by the I/O thread
+  alignas(64) std::atomic<uint32_t> tail_{0};
+  alignas(64) std::atomic<uint32_t> head_{0};
+  // Futex word that wakes the I/O thread, and whether it waits on it
+  std::atomic<uint32_t> doorbell_{0};
+  std::atomic<bool> waiting_{false};
+  std::atomic<bool> stop_{false};
+
+  int64_t num_dropped_ = 0;
+  std::atomic<int64_t> num_sent_{0};
+  std::atomic<int64_t> num_failed_{0};
+
+  std::thread thread_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
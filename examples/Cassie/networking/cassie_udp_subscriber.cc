@@ -1,6 +1,4 @@
 #include "examples/Cassie/networking/cassie_udp_subscriber.h"
-#include <poll.h>
-#include <sys/ioctl.h>
 #include <functional>
 #include <iostream>
 #include <utility>
@@ -37,22 +35,9 @@ CassieUDPSubscriber::CassieUDPSubscriber(const std::string& address,
     const int port)
     : address_(address),
       port_(port),
+      received_message_(CASSIE_OUT_T_LEN),
+      receiver_(address, port, CASSIE_OUT_T_LEN),
       serializer_(make_unique<CassieUDPOutSerializer>()) {
-
-  // Creating socket file descriptor
-  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
-  DRAKE_THROW_UNLESS(socket_ >= 0);
-  std::cout << "Opened socket!" << std::endl;
-  memset(&server_address_, 0, sizeof(server_address_));
-
-  // Filling server information
-  inet_aton(address_.c_str(), &server_address_.sin_addr);
-  server_address_.sin_family = AF_INET;  // IPv4
-  server_address_.sin_port = htons(port);
-
-  // Bind the socket with the server address
-  DRAKE_THROW_UNLESS(bind(socket_, (const struct sockaddr*) &server_address_,
-      sizeof(server_address_)) >= 0);
   std::cout << "Bound socket!" << std::endl;
 
   // Use the "advanced" method to construct explicit non-member functors
@@ -75,18 +60,18 @@ CassieUDPSubscriber::CassieUDPSubscriber(const std::string& address,
 
 
   keep_polling_ = true;
-  
+  start_ = steady_clock::now();
+
   set_name(make_name(address, port));
   std::cout << "Starting polling thread!" << std::endl;
   polling_thread_ = std::thread(&CassieUDPSubscriber::Poll, this,
       [this](const void* buffer, int size) {
         this->HandleMessage(buffer, size);
       });
-
-  start_ = steady_clock::now();
 }
 
 CassieUDPSubscriber::~CassieUDPSubscriber() {
+  StopPolling();
   polling_thread_.join();
 }
 
@@ -95,32 +80,11 @@ void CassieUDPSubscriber::StopPolling() {
 }
 
 void CassieUDPSubscriber::Poll(HandlerFunction handler) {
-  // Create cassie input/output structs
-  char receive_buffer[2 + CASSIE_OUT_T_LEN];
-
-  ssize_t des_len = (sizeof receive_buffer);
-
-  // Poll for a new packet of the correct length
-  ssize_t nbytes = 0;
-  struct pollfd fd = {.fd = socket_, .events = POLLIN, .revents = 0};
   while (keep_polling_) {
-    do {
-        poll(&fd, 1, -1);
-        // Get newest valid packet in RX buffer
-        // Does not use sequence number for determining newest packet
-        ioctl(socket_, FIONREAD, &nbytes);
-        if (des_len <= nbytes) {
-          nbytes = recv(socket_, receive_buffer, des_len, 0);
-        } else {
-          recv(socket_, receive_buffer, 0, 0);  // Discard packet
-        }
-    } while (des_len != nbytes);
-
-    // Split header and data
-    const void *data_in =
-      reinterpret_cast<const unsigned char *>(&receive_buffer[2]);
-
-    handler(data_in, nbytes - 2);
+    // Wake up periodically to check whether to stop
+    if (receiver_.Receive(100)) {
+      handler(receiver_.payload(), receiver_.payload_size());
+    }
   }
 }
 
@@ -135,18 +99,16 @@ int CassieUDPSubscriber::get_message_utime(
 
 void CassieUDPSubscriber::ProcessMessageAndStoreToAbstractState(
     AbstractValues* abstract_state) const {
-  std::lock_guard<std::mutex> lock(received_message_mutex_);
-  if (!received_message_.empty()) {
+  const int message_count = received_message_.Take();
+  if (message_count > 0) {
     serializer_->Deserialize(
         received_message_.data(), received_message_.size(),
         &abstract_state->get_mutable_value(kStateIndexMessage));
   }
   abstract_state->get_mutable_value(kStateIndexMessageCount)
-      .get_mutable_value<int>() = received_message_count_;
-  auto t = duration_cast<microseconds>(steady_clock::now() - start_);
+      .get_mutable_value<int>() = message_count;
   abstract_state->get_mutable_value(kStateIndexMessageUTime)
-      .get_mutable_value<int>() = t.count();
-  // std::cout << "time: " << t.count() << std::endl;
+      .get_mutable_value<int>() = received_message_.time() * 1e6;
 }
 
 int CassieUDPSubscriber::GetMessageCount(const Context<double>& context) const {
@@ -164,11 +126,7 @@ void CassieUDPSubscriber::DoCalcNextUpdateTime(
 
   // Do nothing unless we have a new message.
   const int last_message_count = GetMessageCount(context);
-  const int received_message_count = [this]() {
-    std::unique_lock<std::mutex> lock(received_message_mutex_);
-    return received_message_count_;
-  }();
-  if (last_message_count == received_message_count) {
+  if (last_message_count == received_message_.count()) {
     return;
   }
   // Schedule an update event at the current time.
@@ -200,44 +158,29 @@ void CassieUDPSubscriber::HandleMessage(const void* buffer, int size) {
   SPDLOG_TRACE(drake::log(), "Receiving CASSIE message");
   // std::cout << "Handling message!" << std::endl;
 
-  const uint8_t* const rbuf_begin = static_cast<const uint8_t*>(buffer);
-  const uint8_t* const rbuf_end = rbuf_begin + size;
-  std::lock_guard<std::mutex> lock(received_message_mutex_);
-  received_message_.clear();
-  received_message_.insert(received_message_.begin(), rbuf_begin, rbuf_end);
-  received_message_count_++;
-  received_message_condition_variable_.notify_all();
+  // Called from Poll(), so the receiver holds this message
+  auto t = duration_cast<microseconds>(receiver_.receive_time() - start_);
+  received_message_.Put(buffer, size, t.count() / 1.0e6);
 }
 
 int CassieUDPSubscriber::WaitForMessage(
     int old_message_count, AbstractValue* message) const {
-  // std::cout << "Waiting for message...";
   // The message buffer and counter are updated in HandleMessage(), which is
-  // a callback function invoked by a different thread owned by the
-  // drake::lcm::DrakeLcmInterface instance passed to the constructor. Thus,
-  // for thread safety, these need to be properly protected by a mutex.
-  std::unique_lock<std::mutex> lock(received_message_mutex_);
-
-  // This while loop is necessary to guard for spurious wakeup:
-  // https://en.wikipedia.org/wiki/Spurious_wakeup
-  while (old_message_count >= received_message_count_) {
-    // When wait returns, lock is atomically acquired. So it's thread safe to
-    // read received_message_count_.
-    received_message_condition_variable_.wait(lock);
-  }
-  int new_message_count = received_message_count_;
-  if (message) {
-      serializer_->Deserialize(
-          received_message_.data(), received_message_.size(), message);
+  // called by the polling thread. The mailbox lets this thread wait for and
+  // read the latest message without blocking the polling thread.
+  const int new_message_count = received_message_.Wait(old_message_count);
+  if (message == nullptr) {
+    return new_message_count;
   }
-  lock.unlock();
-  // std::cout << "received!" << std::endl;
-  return new_message_count;
+  // Returns the count of the message read, which may be newer
+  const int message_count = received_message_.Take();
+  serializer_->Deserialize(
+      received_message_.data(), received_message_.size(), message);
+  return message_count;
 }
 
 int CassieUDPSubscriber::GetInternalMessageCount() const {
-  std::unique_lock<std::mutex> lock(received_message_mutex_);
-  return received_message_count_;
+  return received_message_.count();
 }
 
 }  // namespace systems
@@ -5,9 +5,8 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 
-#include <condition_variable>
+#include <atomic>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 #include <thread>
@@ -16,6 +15,8 @@
 #include "drake/common/drake_deprecated.h"
 #include "drake/common/drake_throw.h"
 #include "drake/systems/framework/leaf_system.h"
+#include "examples/Cassie/networking/batch_udp_receiver.h"
+#include "examples/Cassie/networking/latest_message_mailbox.h"
 #include "examples/Cassie/networking/udp_serializer.h"
 
 namespace dairlib {
@@ -37,6 +38,11 @@ namespace systems {
  * all these operations are taken care of by the Simulator. On the other hand,
  * the user needs to manually replicate this process without the Simulator.
  *
+ * Messages are handed from the polling thread to the thread running the
+ * system through a LatestMessageMailbox, so that neither blocks the other,
+ * and the system (WaitForMessage(), CalcNextUpdateTime() and the update)
+ * must only be used from a single thread.
+ *
  * @ingroup message_passing
  */
 class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
@@ -79,7 +85,8 @@ class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
 
   void StopPolling();
 
-  /// Main polling function.
+  /// Main polling function. Hands the newest message queued in the socket to
+  /// handler, until StopPolling() is called.
   /// @param handler for handling received messages
   void Poll(HandlerFunction handler);
 
@@ -95,7 +102,8 @@ class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
   // This system has no input ports.
   void get_input_port(int) = delete;
 
-  // Gets the last time, in microseconds, of the most recently received message
+  // Gets the time, in microseconds, at which the kernel received the most
+  // recently processed message.
   // Counts from the time this subscriber was initialized, which seems
   // safe because there should only ever be one such subscriber in a process
   // Needed for UDPDrivenLoop
@@ -164,27 +172,17 @@ class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
   // The port on which to receive messages
   const int port_;
 
-  // The mutex that guards received_message_ and received_message_count_.
-  mutable std::mutex received_message_mutex_;
-
-  // A condition variable that's signaled every time the handler is called.
-  mutable std::condition_variable received_message_condition_variable_;
-
-  // The bytes of the most recently received LCM message.
-  std::vector<uint8_t> received_message_;
-
-  // A message counter that's incremented every time the handler is called.
-  int received_message_count_{0};
+  // The most recently received message, and the number of messages received
+  mutable LatestMessageMailbox received_message_;
 
-  int socket_;
-  struct sockaddr_in server_address_;
+  BatchUdpReceiver receiver_;
   std::thread polling_thread_;
 
   const std::unique_ptr<CassieUDPOutSerializer> serializer_;
 
   std::chrono::time_point<std::chrono::steady_clock> start_;
 
-  bool keep_polling_;
+  std::atomic<bool> keep_polling_;
 };
 
 }  // namespace systems
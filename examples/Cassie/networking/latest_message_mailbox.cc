@@ -0,0 +1,64 @@
+#include "examples/Cassie/networking/latest_message_mailbox.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+namespace systems {
+
+namespace {
+
+void Futex(std::atomic<uint32_t>* address, int operation, uint32_t value) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), operation, value,
+          nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+LatestMessageMailbox::LatestMessageMailbox(int max_size)
+    : max_size_(max_size), buffers_(3 * max_size) {
+  DRAKE_DEMAND(max_size > 0);
+}
+
+void LatestMessageMailbox::Put(const void* data, int size, double time) {
+  DRAKE_DEMAND(size >= 0 && size <= max_size_);
+  std::memcpy(buffer(back_), data, size);
+  sizes_[back_] = size;
+  times_[back_] = time;
+  counts_[back_] = count_.load(std::memory_order_relaxed) + 1;
+  back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) &
+          ~kFresh;
+  count_.fetch_add(1);
+  if (waiting_.load()) {
+    Futex(&count_, FUTEX_WAKE_PRIVATE, 1);
+  }
+}
+
+int LatestMessageMailbox::Wait(int old_count) const {
+  while (true) {
+    const uint32_t count = count_.load();
+    if (static_cast<int>(count) > old_count) {
+      return count;
+    }
+    // Publish the wait before sleeping, so that a message put meanwhile
+    // either sees it and wakes, or changes count_ so that the wait returns
+    waiting_.store(true);
+    Futex(&count_, FUTEX_WAIT_PRIVATE, count);
+    waiting_.store(false);
+  }
+}
+
+int LatestMessageMailbox::Take() {
+  if (middle_.load(std::memory_order_relaxed) & kFresh) {
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~kFresh;
+  }
+  return counts_[front_];
+}
+
+}  // namespace systems
+}  // namespace dairlib
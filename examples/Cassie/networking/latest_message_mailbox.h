@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+namespace systems {
+
+/// LatestMessageMailbox hands the latest of a stream of messages, of at most
+/// max_size bytes, from one producer thread to one consumer thread without
+/// locks or allocation.
+///
+/// It is a triple buffer: the producer copies each message into its back
+/// buffer and swaps it with the middle buffer, and the consumer swaps the
+/// middle buffer with its front buffer when the middle one holds a newer
+/// message. Neither thread ever waits for the other, and the consumer always
+/// reads a complete message. The consumer can also sleep until a new message
+/// is put, on a futex that the producer only wakes while the consumer waits.
+class LatestMessageMailbox {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(LatestMessageMailbox)
+
+  explicit LatestMessageMailbox(int max_size);
+
+  /// Copies a message of size bytes, received at time, into the mailbox.
+  /// Producer thread only.
+  void Put(const void* data, int size, double time = 0);
+
+  /// Number of messages put so far. Any thread.
+  int count() const { return count_.load(std::memory_order_acquire); }
+
+  /// Blocks until count() exceeds old_count, and returns count(). Consumer
+  /// thread only.
+  int Wait(int old_count) const;
+
+  /// Makes the latest message put the current one, and returns its count, or
+  /// 0 if no message was put. Consumer thread only.
+  int Take();
+
+  /// The current message, valid until the next Take(). Consumer thread only.
+  const uint8_t* data() const { return buffer(front_); }
+  int size() const { return sizes_[front_]; }
+  double time() const { return times_[front_]; }
+
+ private:
+  // Set in middle_ when it holds a message that the consumer did not take
+  static constexpr int kFresh = 4;
+
+  uint8_t* buffer(int index) { return buffers_.data() + index * max_size_; }
+  const uint8_t* buffer(int index) const {
+    return buffers_.data() + index * max_size_;
+  }
+
+  const int max_size_;
+  std::vector<uint8_t> buffers_;
+  int sizes_[3] = {0, 0, 0};
+  int counts_[3] = {0, 0, 0};
+  double times_[3] = {0, 0, 0};
+  // Indices of the buffers owned by the producer and by the consumer, and of
+  // the buffer in between
+  int back_ = 0;
+  std::atomic<int> middle_{1};
+  int front_ = 2;
+  // Futex word, as the number of messages put, and whether the consumer is
+  // waiting on it
+  mutable std::atomic<uint32_t> count_{0};
+  mutable std::atomic<bool> waiting_{false};
+};
+
+}  // namespace systems
+}  // namespace dairlib
@@ -88,9 +88,11 @@ int main(int argc, char **argv)
   cassie_out.leftLeg.shinJoint.position = 1.5;
   cassie_out.leftLeg.shinJoint.velocity = -1.2;
 	/*
-	 * check command line arguments
+	 * check command line arguments: an optional sending period, in
+	 * microseconds, which defaults to one second
 	 */
 	portno = 5000;
+	useconds_t period = argc > 1 ? atoi(argv[1]) : 1000000;
 
 	/*
 	 * socket: create the parent socket
@@ -130,12 +132,15 @@ int main(int argc, char **argv)
 		 * sendto: echo the input back to the client
 		 */
 		while(1){
-      sleep(1);
+      usleep(period);
+      // Sequence number, as used to find the newest queued packet
+      ++header_out[0];
       n = sendto(sockfd, sendbuf, sizeof(sendbuf), 0,
            (struct sockaddr *)&serveraddr, sizeof(serveraddr));
       if (n < 0)
         perror("ERROR in sendto");
-      printf("sent %d \n",n);
+      if (period >= 1000000)
+        printf("sent %d \n",n);
     }
 	}
 }
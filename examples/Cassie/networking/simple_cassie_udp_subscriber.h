@@ -1,12 +1,10 @@
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <arpa/inet.h>
-#include <netinet/in.h>
+#include <chrono>
 #include <string>
 
 #include "drake/common/drake_copyable.h"
 #include "drake/common/text_logging.h"
 #include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "examples/Cassie/networking/batch_udp_receiver.h"
 
 namespace dairlib {
 
@@ -26,13 +24,14 @@ class SimpleCassieUdpSubscriber final {
   DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SimpleCassieUdpSubscriber)
 
   /**
-   * Subscribes to the given address and port
+   * Subscribes to the given address, or to every interface if address is
+   * empty, and port
    */
   SimpleCassieUdpSubscriber(const std::string& address, const int port);
 
   /**
-   * Receives and stores the next message. This method will block until a
-   * message is received. 
+   * Receives and stores the newest message, skipping older queued ones. This
+   * method will block until a message is received.
    */
   void Poll();
 
@@ -45,18 +44,17 @@ class SimpleCassieUdpSubscriber final {
   /** Returns the total number of received messages. */
   int64_t count() const { return count_; }
 
-  /** 
-   * Returns the time that the last message was received, relative to when
-   * this class was constructed
-  */
+  /** Returns the number of messages skipped for newer ones. */
+  int64_t num_skipped() const { return receiver_.num_skipped(); }
+
+  /**
+   * Returns the time that the kernel received the last message, relative to
+   * when this class was constructed
+   */
   double message_time() const { return time_; }
 
  private:
-  // The channel on which to receive messages.
-  const std::string address_;
-
-  int socket_;
-  struct sockaddr_in server_address_;
+  BatchUdpReceiver receiver_;
   cassie_out_t data_;
   int64_t count_;
   double time_;
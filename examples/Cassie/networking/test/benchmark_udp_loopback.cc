@@ -0,0 +1,351 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "dairlib/lcmt_cassie_out.hpp"
+#include "examples/Cassie/cassie_utils.h"
+#include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "examples/Cassie/datatypes/cassie_user_in_t.h"
+#include "examples/Cassie/networking/cassie_input_translator.h"
+#include "examples/Cassie/networking/cassie_output_sender.h"
+#include "examples/Cassie/networking/cassie_udp_publisher.h"
+#include "examples/Cassie/networking/cassie_udp_subscriber.h"
+#include "systems/framework/realtime.h"
+#include "systems/framework/timestamped_vector.h"
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/drake_throw.h"
+#include "drake/multibody/plant/multibody_plant.h"
+#include "drake/systems/framework/diagram_builder.h"
+#include "drake/systems/framework/leaf_system.h"
+
+DEFINE_string(rates, "2000,4000,8000",
+              "Comma-separated rates (Hz) at which the simulated Cassie "
+              "sends, one run each");
+DEFINE_double(duration, 5, "Duration (s) of each run");
+DEFINE_int32(cassie_port, 25000, "Port of the simulated Cassie");
+DEFINE_int32(controller_port, 25001, "Port of the controller");
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::systems::BasicVector;
+using drake::systems::Context;
+using drake::systems::DiagramBuilder;
+using drake::systems::LeafSystem;
+using systems::CassieInputTranslator;
+using systems::CassieOutputSender;
+using systems::CassieUDPPublisher;
+using systems::CassieUDPSubscriber;
+using systems::LatencyHistogram;
+using systems::TimestampedVector;
+
+typedef std::chrono::steady_clock my_clock;
+
+static const char LOCALHOST[] = "127.0.0.1";
+
+// Number of packets in flight that the simulated Cassie keeps track of
+static const int HISTORY = 1 << 16;
+
+// Packet numbers are sent as floats, so they stay below 2^24
+static const int64_t MAX_PACKETS = 1 << 24;
+
+double CpuTime(clockid_t clock) {
+  timespec time;
+  clock_gettime(clock, &time);
+  return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+
+double Now() {
+  return std::chrono::duration<double>(my_clock::now().time_since_epoch())
+      .count();
+}
+
+sockaddr_in MakeAddress(int port) {
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  inet_aton(LOCALHOST, &address.sin_addr);
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  return address;
+}
+
+/// The controller under test: echoes the packet number, which the simulated
+/// Cassie sends as leftLeg.hipRollDrive.position, as every motor torque
+class EchoController : public LeafSystem<double> {
+ public:
+  EchoController() {
+    this->DeclareAbstractInputPort("lcmt_cassie_out",
+                                   drake::Value<lcmt_cassie_out>{});
+    this->DeclareVectorOutputPort(TimestampedVector<double>(10),
+                                  &EchoController::Output);
+  }
+
+ private:
+  void Output(const Context<double>& context,
+              TimestampedVector<double>* output) const {
+    const auto& cassie_out =
+        EvalAbstractInput(context, 0)->get_value<lcmt_cassie_out>();
+    output->SetDataVector(Eigen::VectorXd::Constant(
+        10, cassie_out.leftLeg.hipRollDrive.position));
+    output->set_timestamp(context.get_time());
+  }
+};
+
+/// A simulated Cassie, modeled on run_udp_dummy_server.c, that sends
+/// numbered cassie_out_t packets at a fixed rate and records the round trip
+/// time of the cassie_user_in_t packets echoing their numbers
+class SimulatedCassie {
+ public:
+  SimulatedCassie(double rate, double duration)
+      : period_(1 / rate),
+        num_packets_(std::llround(rate * duration)),
+        send_times_(HISTORY),
+        answered_(HISTORY),
+        round_trip_(1e-6, 100000) {
+    DRAKE_DEMAND(num_packets_ < MAX_PACKETS);
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    DRAKE_THROW_UNLESS(socket_ >= 0);
+    const sockaddr_in address = MakeAddress(FLAGS_cassie_port);
+    DRAKE_THROW_UNLESS(bind(socket_,
+                            reinterpret_cast<const sockaddr*>(&address),
+                            sizeof(address)) == 0);
+  }
+
+  ~SimulatedCassie() { close(socket_); }
+
+  /// Sends the packets, then a stop packet until controller_done
+  void Run(const std::atomic<bool>& controller_done) {
+    const double cpu_start = CpuTime(CLOCK_THREAD_CPUTIME_ID);
+    cassie_out_t cassie_out{};
+    cassie_out.isCalibrated = true;
+    double next = Now();
+    for (int64_t i = 1; i <= num_packets_; i++) {
+      next += period_;
+      ReceiveUntil(next);
+      Send(&cassie_out, i);
+    }
+    while (!controller_done) {
+      Send(&cassie_out, -1);
+      ReceiveUntil(Now() + 0.01);
+    }
+    cpu_time_ = CpuTime(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+  }
+
+  int64_t num_packets() const { return num_packets_; }
+  int64_t num_answered() const { return num_answered_; }
+  const LatencyHistogram& round_trip() const { return round_trip_; }
+  double cpu_time() const { return cpu_time_; }
+
+ private:
+  void Send(cassie_out_t* cassie_out, int64_t number) {
+    cassie_out->leftLeg.hipRollDrive.position = number;
+    send_buffer_[0]++;
+    pack_cassie_out_t(cassie_out, &send_buffer_[2]);
+    if (number > 0) {
+      send_times_[number % HISTORY] = Now();
+      answered_[number % HISTORY] = false;
+    }
+    const sockaddr_in address = MakeAddress(FLAGS_controller_port);
+    sendto(socket_, send_buffer_, sizeof(send_buffer_), 0,
+           reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  }
+
+  // Receives the answers until time, as seconds of my_clock
+  void ReceiveUntil(double time) {
+    pollfd fd = {socket_, POLLIN, 0};
+    double remaining;
+    while ((remaining = time - Now()) > 0) {
+      const timespec timeout = {
+          static_cast<time_t>(remaining),
+          static_cast<long>(1e9 * (remaining - std::floor(remaining)))};
+      if (ppoll(&fd, 1, &timeout, nullptr) <= 0) {
+        continue;
+      }
+      int size;
+      while ((size = recv(socket_, receive_buffer_, sizeof(receive_buffer_),
+                          MSG_DONTWAIT)) >= 0) {
+        if (size != static_cast<int>(sizeof(receive_buffer_))) {
+          continue;
+        }
+        cassie_user_in_t cassie_in;
+        unpack_cassie_user_in_t(&receive_buffer_[2], &cassie_in);
+        const int64_t number = std::llround(cassie_in.torque[0]);
+        if (number > 0 && !answered_[number % HISTORY]) {
+          answered_[number % HISTORY] = true;
+          round_trip_.Add(Now() - send_times_[number % HISTORY]);
+          num_answered_++;
+        }
+      }
+    }
+  }
+
+  const double period_;
+  const int64_t num_packets_;
+  int socket_;
+  unsigned char send_buffer_[2 + CASSIE_OUT_T_LEN] = {0};
+  unsigned char receive_buffer_[2 + CASSIE_USER_IN_T_LEN];
+  std::vector<double> send_times_;
+  std::vector<bool> answered_;
+  int64_t num_answered_ = 0;
+  LatencyHistogram round_trip_;
+  double cpu_time_ = 0;
+};
+
+/// CPU time of one component of the controller loop
+struct Component {
+  std::string name;
+  double cpu_time = 0;
+};
+
+/// Runs the controller on loopback against a simulated Cassie sending at
+/// rate, and reports the round trip latency, the packet loss and the CPU
+/// usage of each component
+void Run(const MultibodyPlant<double>& plant, double rate) {
+  DiagramBuilder<double> builder;
+  auto subscriber = builder.AddSystem(
+      CassieUDPSubscriber::Make(LOCALHOST, FLAGS_controller_port));
+  auto output_sender = builder.AddSystem<CassieOutputSender>();
+  auto controller = builder.AddSystem<EchoController>();
+  auto input_translator = builder.AddSystem<CassieInputTranslator>(plant);
+  auto publisher = builder.AddSystem(
+      CassieUDPPublisher::Make(LOCALHOST, FLAGS_cassie_port));
+  builder.Connect(subscriber->get_output_port(),
+                  output_sender->get_input_port(0));
+  builder.Connect(output_sender->get_output_port(0),
+                  controller->get_input_port(0));
+  builder.Connect(controller->get_output_port(0),
+                  input_translator->get_input_port(0));
+  builder.Connect(input_translator->get_output_port(0),
+                  publisher->get_input_port());
+  auto diagram = builder.Build();
+  auto diagram_context = diagram->CreateDefaultContext();
+  auto& subscriber_context =
+      diagram->GetMutableSubsystemContext(*subscriber, diagram_context.get());
+  const auto& output_sender_context =
+      diagram->GetSubsystemContext(*output_sender, *diagram_context);
+  const auto& controller_context =
+      diagram->GetSubsystemContext(*controller, *diagram_context);
+  const auto& input_translator_context =
+      diagram->GetSubsystemContext(*input_translator, *diagram_context);
+  const auto& publisher_context =
+      diagram->GetSubsystemContext(*publisher, *diagram_context);
+
+  SimulatedCassie cassie(rate, FLAGS_duration);
+  std::atomic<bool> controller_done(false);
+  const double process_start = CpuTime(CLOCK_PROCESS_CPUTIME_ID);
+  const double loop_start = CpuTime(CLOCK_THREAD_CPUTIME_ID);
+  const double start = Now();
+  std::thread cassie_thread(&SimulatedCassie::Run, &cassie,
+                            std::cref(controller_done));
+
+  std::vector<Component> components = {
+      {"CassieUDPSubscriber update"}, {"CassieOutputSender"},
+      {"controller"}, {"CassieInputTranslator"}, {"CassieUDPPublisher"}};
+  int64_t num_processed = 0;
+  int count = 0;
+  while (true) {
+    count = subscriber->WaitForMessage(count);
+    double time = CpuTime(CLOCK_THREAD_CPUTIME_ID);
+    auto lap = [&time](Component* component) {
+      const double now = CpuTime(CLOCK_THREAD_CPUTIME_ID);
+      component->cpu_time += now - time;
+      time = now;
+    };
+    subscriber->CopyLatestMessageInto(&subscriber_context.get_mutable_state());
+    lap(&components[0]);
+    const auto& cassie_out =
+        output_sender->get_output_port(0).Eval<lcmt_cassie_out>(
+            output_sender_context);
+    lap(&components[1]);
+    if (cassie_out.leftLeg.hipRollDrive.position < 0) {
+      break;
+    }
+    controller->get_output_port(0).Eval<BasicVector<double>>(
+        controller_context);
+    lap(&components[2]);
+    input_translator->get_output_port(0).Eval<cassie_user_in_t>(
+        input_translator_context);
+    lap(&components[3]);
+    publisher->Publish(publisher_context);
+    lap(&components[4]);
+    num_processed++;
+  }
+  controller_done = true;
+  cassie_thread.join();
+  const double wall_time = Now() - start;
+  const double loop_time = CpuTime(CLOCK_THREAD_CPUTIME_ID) - loop_start;
+  const double process_time =
+      CpuTime(CLOCK_PROCESS_CPUTIME_ID) - process_start;
+
+  double components_time = 0;
+  for (const auto& component : components) {
+    components_time += component.cpu_time;
+  }
+  components.insert(components.begin(),
+                    {{"simulated Cassie", cassie.cpu_time()},
+                     {"UDP receive thread",
+                      process_time - loop_time - cassie.cpu_time()}});
+  components.push_back({"waiting and waking", loop_time - components_time});
+
+  const int64_t num_packets = cassie.num_packets();
+  std::cout << rate << " Hz for " << wall_time << " s: " << num_packets
+            << " packets sent, " << num_packets - num_processed
+            << " skipped or lost before the controller, "
+            << num_processed - cassie.num_answered()
+            << " lost after the controller" << std::endl;
+  cassie.round_trip().PrintSummary("  round trip", std::cout);
+  std::cout << "  CPU per component, as % of a core and us per packet"
+            << std::endl;
+  for (const auto& component : components) {
+    std::cout << "    " << std::left << std::setw(28) << component.name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(6) << 100 * component.cpu_time / wall_time << " %"
+              << std::setw(8)
+              << 1e6 * component.cpu_time / std::max<int64_t>(num_processed, 1)
+              << " us" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+  }
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::SetUsageMessage(
+      "Runs CassieUDPSubscriber, CassieOutputSender, CassieInputTranslator "
+      "and CassieUDPPublisher against a simulated Cassie on loopback.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant);
+  plant.Finalize();
+
+  std::stringstream rates(FLAGS_rates);
+  std::string rate;
+  while (std::getline(rates, rate, ',')) {
+    Run(plant, std::stod(rate));
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
@@ -0,0 +1,166 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "examples/Cassie/networking/batch_udp_receiver.h"
+#include "systems/framework/realtime.h"
+
+DEFINE_string(address, "127.0.0.1", "IPv4 address to receive on");
+DEFINE_int32(port, 5000, "Port to receive on");
+DEFINE_int32(messages, 4000, "Number of messages to send per receive path");
+DEFINE_double(rate, 2000, "Sending rate (Hz)");
+DEFINE_int32(work_us, 0,
+             "Work (us) simulated after each message, e.g. 700 to fall "
+             "behind a 2 kHz sender");
+DEFINE_bool(send, true,
+            "Whether to send the messages from a child process. Otherwise, "
+            "receives for --messages from run_udp_dummy_sender, without "
+            "latencies, since its messages are not stamped.");
+
+namespace dairlib {
+namespace {
+
+using systems::LatencyHistogram;
+
+typedef std::chrono::steady_clock my_clock;
+
+const int kPacketSize = 2 + CASSIE_OUT_T_LEN;
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             my_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Sends sequence numbered Cassie output packets, holding their send time
+/// after the header, as run_udp_dummy_sender does at a higher rate
+void Send() {
+  int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  inet_aton(FLAGS_address.c_str(), &address.sin_addr);
+  address.sin_family = AF_INET;
+  address.sin_port = htons(FLAGS_port);
+  unsigned char packet[kPacketSize] = {0};
+
+  auto next = my_clock::now();
+  const auto period = std::chrono::duration_cast<my_clock::duration>(
+      std::chrono::duration<double>(1 / FLAGS_rate));
+  for (int i = 0; i < FLAGS_messages; i++) {
+    next += period;
+    std::this_thread::sleep_until(next);
+    packet[0]++;
+    const int64_t now = Now();
+    memcpy(&packet[2], &now, sizeof(now));
+    sendto(socket, packet, sizeof(packet), 0,
+           reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  }
+  close(socket);
+}
+
+/// The receive path that the Cassie UDP subscribers used before
+/// BatchUdpReceiver: a poll, ioctl and recv per packet, in arrival order
+class LegacyReceiver {
+ public:
+  explicit LegacyReceiver(const BatchUdpReceiver& receiver)
+      : socket_(receiver.socket()) {}
+
+  bool Receive(int timeout_ms) {
+    ssize_t des_len = (sizeof receive_buffer_);
+    ssize_t nbytes = 0;
+    struct pollfd fd = {.fd = socket_, .events = POLLIN, .revents = 0};
+    do {
+      if (poll(&fd, 1, timeout_ms) <= 0) {
+        return false;
+      }
+      ioctl(socket_, FIONREAD, &nbytes);
+      if (des_len <= nbytes) {
+        nbytes = recv(socket_, receive_buffer_, des_len, 0);
+      } else {
+        recv(socket_, receive_buffer_, 0, 0);  // Discard packet
+      }
+    } while (des_len != nbytes);
+    return true;
+  }
+
+  const uint8_t* payload() const { return &receive_buffer_[2]; }
+
+ private:
+  int socket_;
+  uint8_t receive_buffer_[kPacketSize];
+};
+
+/// Receives with receiver (a BatchUdpReceiver or LegacyReceiver) until the
+/// sender is done, recording how old each received message is
+template <typename Receiver>
+void Run(const std::string& name, BatchUdpReceiver* batch_receiver,
+         Receiver* receiver) {
+  // Flush messages left over from the previous run
+  while (batch_receiver->Receive(0)) {}
+
+  pid_t pid = FLAGS_send ? fork() : -1;
+  if (pid == 0) {
+    Send();
+    _exit(0);
+  }
+
+  LatencyHistogram latency(1e-6, 100000);
+  int received = 0;
+  const int timeout_ms = FLAGS_send ? 1000 : 10000;
+  while (received < FLAGS_messages && receiver->Receive(timeout_ms)) {
+    received++;
+    if (FLAGS_send) {
+      int64_t sent;
+      memcpy(&sent, receiver->payload(), sizeof(sent));
+      latency.Add(1e-9 * (Now() - sent));
+    }
+    if (FLAGS_work_us > 0) {
+      // Busy, as a controller would be
+      const auto end =
+          my_clock::now() + std::chrono::microseconds(FLAGS_work_us);
+      while (my_clock::now() < end) {}
+    }
+  }
+  if (pid > 0) {
+    waitpid(pid, nullptr, 0);
+  }
+
+  std::cout << name << ": " << received << " messages received" << std::endl;
+  if (FLAGS_send) {
+    latency.PrintSummary("  age when received", std::cout);
+  }
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  std::cout << kPacketSize << " byte packets at " << FLAGS_rate << " Hz, "
+            << FLAGS_work_us << " us of work per message" << std::endl;
+
+  BatchUdpReceiver batch_receiver(FLAGS_address, FLAGS_port, CASSIE_OUT_T_LEN);
+  LegacyReceiver legacy_receiver(batch_receiver);
+  Run("poll, ioctl and recv", &batch_receiver, &legacy_receiver);
+  Run("recvmmsg", &batch_receiver, &batch_receiver);
+  std::cout << "  " << batch_receiver.num_skipped() << " stale messages skipped"
+            << std::endl;
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
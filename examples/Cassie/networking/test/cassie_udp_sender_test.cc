@@ -0,0 +1,94 @@
+#include "examples/Cassie/networking/cassie_udp_sender.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+class CassieUdpSenderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Receives on an ephemeral loopback port
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(socket_, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    inet_aton("127.0.0.1", &address.sin_addr);
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    ASSERT_EQ(bind(socket_, reinterpret_cast<sockaddr*>(&address),
+                   sizeof(address)), 0);
+    socklen_t length = sizeof(address);
+    getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+  }
+
+  void TearDown() override { close(socket_); }
+
+  /// Receives a packet, returning its size, or -1 after a second
+  int Receive(unsigned char* packet, int size) {
+    pollfd fd = {socket_, POLLIN, 0};
+    if (poll(&fd, 1, 1000) <= 0) {
+      return -1;
+    }
+    return recv(socket_, packet, size, 0);
+  }
+
+  int socket_;
+  int port_;
+};
+
+TEST_F(CassieUdpSenderTest, SendsNumberedPackets) {
+  const int num_messages = 10;
+  {
+    CassieUdpSender sender("127.0.0.1", port_);
+    for (int i = 0; i < num_messages; i++) {
+      cassie_user_in_t message{};
+      message.torque[3] = i;
+      // Wait for the queue to drain, so that no message is dropped
+      while (!sender.Send(message)) {
+        usleep(100);
+      }
+    }
+  }
+
+  for (int i = 0; i < num_messages; i++) {
+    unsigned char packet[CassieUdpSender::kPacketSize + 1];
+    ASSERT_EQ(Receive(packet, sizeof(packet)), CassieUdpSender::kPacketSize);
+    EXPECT_EQ(packet[0], i + 1);
+    cassie_user_in_t message;
+    unpack_cassie_user_in_t(&packet[2], &message);
+    EXPECT_EQ(message.torque[3], i);
+  }
+}
+
+TEST_F(CassieUdpSenderTest, NeverBlocks) {
+  CassieUdpSender sender("127.0.0.1", port_);
+  cassie_user_in_t message{};
+  int num_queued = 0;
+  const int num_messages = 100000;
+  for (int i = 0; i < num_messages; i++) {
+    num_queued += sender.Send(message);
+  }
+  EXPECT_EQ(num_queued + sender.num_dropped(), num_messages);
+
+  // Every queued message is eventually sent
+  for (int i = 0; i < 1000 && sender.num_sent() < num_queued; i++) {
+    usleep(1000);
+  }
+  EXPECT_EQ(sender.num_sent(), num_queued);
+  EXPECT_EQ(sender.num_failed(), 0);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,150 @@
+#include "examples/Cassie/networking/latest_message_mailbox.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "systems/framework/realtime.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+static const int NUM_HANDOFFS = 2000;
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             my_clock::now().time_since_epoch())
+      .count();
+}
+
+/// A message of CASSIE_OUT_T_LEN bytes, all equal to value
+std::vector<uint8_t> MakeMessage(int value) {
+  return std::vector<uint8_t>(CASSIE_OUT_T_LEN, value % 256);
+}
+
+/// Puts NUM_HANDOFFS messages holding their send time, one every 200 us, and
+/// records the time until the consumer has taken each one
+template <typename Put, typename WaitAndTake>
+LatencyHistogram MeasureHandoff(Put put, WaitAndTake wait_and_take) {
+  std::thread producer([&put]() {
+    std::vector<uint8_t> message(CASSIE_OUT_T_LEN);
+    for (int i = 0; i < NUM_HANDOFFS; i++) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      const int64_t now = Now();
+      std::memcpy(message.data(), &now, sizeof(now));
+      put(message);
+    }
+  });
+  LatencyHistogram latency(1e-7, 100000);
+  int count = 0;
+  while (count < NUM_HANDOFFS) {
+    int64_t sent;
+    count = wait_and_take(count, &sent);
+    latency.Add(1e-9 * (Now() - sent));
+  }
+  producer.join();
+  return latency;
+}
+
+GTEST_TEST(LatestMessageMailboxTest, TakesLatest) {
+  LatestMessageMailbox mailbox(CASSIE_OUT_T_LEN);
+  EXPECT_EQ(mailbox.count(), 0);
+  EXPECT_EQ(mailbox.Take(), 0);
+  EXPECT_EQ(mailbox.size(), 0);
+
+  for (int i = 1; i <= 3; i++) {
+    mailbox.Put(MakeMessage(i).data(), CASSIE_OUT_T_LEN);
+  }
+  EXPECT_EQ(mailbox.count(), 3);
+  EXPECT_EQ(mailbox.Wait(0), 3);
+  EXPECT_EQ(mailbox.Take(), 3);
+  ASSERT_EQ(mailbox.size(), CASSIE_OUT_T_LEN);
+  EXPECT_EQ(std::vector<uint8_t>(mailbox.data(),
+                                 mailbox.data() + CASSIE_OUT_T_LEN),
+            MakeMessage(3));
+
+  // Without new messages, the current message stays
+  EXPECT_EQ(mailbox.Take(), 3);
+  EXPECT_EQ(mailbox.data()[0], 3);
+}
+
+GTEST_TEST(LatestMessageMailboxTest, ConcurrentMessagesAreComplete) {
+  const int num_messages = 200000;
+  LatestMessageMailbox mailbox(CASSIE_OUT_T_LEN);
+  std::thread producer([&mailbox]() {
+    for (int i = 1; i <= num_messages; i++) {
+      mailbox.Put(MakeMessage(i).data(), CASSIE_OUT_T_LEN);
+    }
+  });
+  int count = 0;
+  int num_taken = 0;
+  while (count < num_messages) {
+    const int new_count = mailbox.Take();
+    ASSERT_GE(new_count, count);
+    if (new_count > count) {
+      num_taken++;
+      const uint8_t* data = mailbox.data();
+      ASSERT_EQ(data[0], new_count % 256);
+      ASSERT_TRUE(std::all_of(data, data + CASSIE_OUT_T_LEN,
+                              [data](uint8_t x) { return x == data[0]; }));
+    }
+    count = new_count;
+  }
+  producer.join();
+  EXPECT_GT(num_taken, 0);
+}
+
+GTEST_TEST(LatestMessageMailboxTest, HandoffLatency) {
+  LatestMessageMailbox mailbox(CASSIE_OUT_T_LEN);
+  LatencyHistogram mailbox_latency = MeasureHandoff(
+      [&mailbox](const std::vector<uint8_t>& message) {
+        mailbox.Put(message.data(), message.size());
+      },
+      [&mailbox](int old_count, int64_t* sent) {
+        mailbox.Wait(old_count);
+        const int count = mailbox.Take();
+        std::memcpy(sent, mailbox.data(), sizeof(*sent));
+        return count;
+      });
+
+  // The mutex and condition variable that CassieUDPSubscriber used before
+  std::mutex mutex;
+  std::condition_variable condition_variable;
+  std::vector<uint8_t> received;
+  int received_count = 0;
+  LatencyHistogram mutex_latency = MeasureHandoff(
+      [&](const std::vector<uint8_t>& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.clear();
+        received.insert(received.begin(), message.begin(), message.end());
+        received_count++;
+        condition_variable.notify_all();
+      },
+      [&](int old_count, int64_t* sent) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (old_count >= received_count) {
+          condition_variable.wait(lock);
+        }
+        std::memcpy(sent, received.data(), sizeof(*sent));
+        return received_count;
+      });
+
+  // Latencies depend on the load of the machine, so they are only printed
+  mailbox_latency.PrintSummary("mailbox handoff", std::cout);
+  mutex_latency.PrintSummary("mutex handoff", std::cout);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
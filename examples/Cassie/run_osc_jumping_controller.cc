@@ -13,6 +13,7 @@
 #include "systems/controllers/osc/operational_space_control.h"
 #include "systems/controllers/osc/osc_tracking_data.h"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/realtime_flags.h"
 #include "systems/primitives/gaussian_noise_pass_through.h"
 #include "systems/robot_lcm_systems.h"
 
@@ -77,6 +78,9 @@ DEFINE_bool(add_noise, false,
             "Whether to add gaussian noise to state "
             "inputted to controller");
 DEFINE_int32(init_fsm_state, BALANCE, "Initial state of the FSM");
+DEFINE_string(trace_channel, "",
+              "LCM channel to publish pipeline latency traces on. Empty "
+              "disables tracing.");
 
 int DoMain(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -393,6 +397,12 @@ int DoMain(int argc, char* argv[]) {
   // Run lcm-driven simulation
   systems::LcmDrivenLoop<dairlib::lcmt_robot_output> loop(
       &lcm, std::move(owned_diagram), state_receiver, FLAGS_channel_x, true);
+  if (!FLAGS_trace_channel.empty()) {
+    loop.EnableTracing("osc_jumping_controller", FLAGS_trace_channel);
+  }
+  if (auto realtime_options = systems::RealtimeOptionsFromFlags()) {
+    loop.set_realtime_options(*realtime_options);
+  }
   loop.Simulate();
 
   return 0;
@@ -10,6 +10,7 @@
 #include "multibody/multibody_utils.h"
 #include "systems/controllers/osc/operational_space_control.h"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/realtime_flags.h"
 #include "systems/robot_lcm_systems.h"
 #include "yaml-cpp/yaml.h"
 #include "drake/common/yaml/yaml_read_archive.h"
@@ -51,6 +52,9 @@ DEFINE_string(
     cassie_out_channel, "CASSIE_OUTPUT_ECHO",
     "The name of the channel to receive the cassie out structure from.");
 DEFINE_bool(print_osc, false, "whether to print the osc debug message or not");
+DEFINE_string(trace_channel, "",
+              "LCM channel to publish pipeline latency traces on. Empty "
+              "disables tracing.");
 DEFINE_double(cost_weight_multiplier, 0.001,
               "A cosntant times with cost weight of OSC traj tracking");
 DEFINE_double(height, .8, "The initial COM height (m)");
@@ -312,7 +316,12 @@ int DoMain(int argc, char* argv[]) {
   systems::LcmDrivenLoop<dairlib::lcmt_robot_output> loop(
       &lcm_local, std::move(owned_diagram), state_receiver, FLAGS_channel_x,
       true);
-
+  if (!FLAGS_trace_channel.empty()) {
+    loop.EnableTracing("osc_standing_controller", FLAGS_trace_channel);
+  }
+  if (auto realtime_options = systems::RealtimeOptionsFromFlags()) {
+    loop.set_realtime_options(*realtime_options);
+  }
   loop.Simulate();
 
   return 0;
@@ -18,6 +18,7 @@
 #include "systems/controllers/swing_ft_traj_gen.h"
 #include "systems/controllers/time_based_fsm.h"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/realtime_flags.h"
 #include "systems/robot_lcm_systems.h"
 
 #include "drake/common/yaml/yaml_read_archive.h"
@@ -68,7 +69,9 @@ DEFINE_string(gains_filename, "examples/Cassie/osc/osc_walking_gains.yaml",
 DEFINE_bool(publish_osc_data, true,
             "whether to publish lcm messages for OscTrackData");
 DEFINE_bool(print_osc, false, "whether to print the osc debug message or not");
-
+DEFINE_string(trace_channel, "",
+              "LCM channel to publish pipeline latency traces on. Empty "
+              "disables tracing.");
 DEFINE_bool(is_two_phase, false,
             "true: only right/left single support"
             "false: both double and single support");
@@ -506,6 +509,12 @@ int DoMain(int argc, char* argv[]) {
   systems::LcmDrivenLoop<dairlib::lcmt_robot_output> loop(
       &lcm_local, std::move(owned_diagram), state_receiver, FLAGS_channel_x,
       true);
+  if (!FLAGS_trace_channel.empty()) {
+    loop.EnableTracing("osc_walking_controller", FLAGS_trace_channel);
+  }
+  if (auto realtime_options = systems::RealtimeOptionsFromFlags()) {
+    loop.set_realtime_options(*realtime_options);
+  }
   loop.Simulate();
 
   return 0;
@@ -0,0 +1,161 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/multibody_utils.h"
+#include "systems/framework/output_vector.h"
+#include "systems/robot_lcm_systems.h"
+
+#include "drake/multibody/plant/multibody_plant.h"
+
+DEFINE_int32(reps, 100000, "Number of messages to decode per benchmark");
+DEFINE_bool(floating_base, true, "Whether Cassie has a floating base");
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using Eigen::VectorXd;
+using std::map;
+using std::string;
+using systems::OutputVector;
+
+typedef std::chrono::steady_clock my_clock;
+
+/// Copies the message through a name lookup per element, as
+/// RobotOutputReceiver did before caching layouts
+void CopyWithMaps(const lcmt_robot_output& state_msg,
+                  const map<string, int>& position_map,
+                  const map<string, int>& velocity_map,
+                  const map<string, int>& effort_map,
+                  OutputVector<double>* output) {
+  VectorXd positions = VectorXd::Zero(position_map.size());
+  for (int i = 0; i < state_msg.num_positions; i++) {
+    positions(position_map.at(state_msg.position_names[i])) =
+        state_msg.position[i];
+  }
+  VectorXd velocities = VectorXd::Zero(velocity_map.size());
+  for (int i = 0; i < state_msg.num_velocities; i++) {
+    velocities(velocity_map.at(state_msg.velocity_names[i])) =
+        state_msg.velocity[i];
+  }
+  VectorXd efforts = VectorXd::Zero(effort_map.size());
+  for (int i = 0; i < state_msg.num_efforts; i++) {
+    efforts(effort_map.at(state_msg.effort_names[i])) = state_msg.effort[i];
+  }
+  output->SetPositions(positions);
+  output->SetVelocities(velocities);
+  output->SetEfforts(efforts);
+  output->set_timestamp(state_msg.utime * 1.0e-6);
+}
+
+template <typename F>
+void Time(const string& name, F function) {
+  auto start = my_clock::now();
+  for (int i = 0; i < FLAGS_reps; i++) {
+    function(i);
+  }
+  auto stop = my_clock::now();
+  std::cout << name << ": "
+            << 1e9 * std::chrono::duration<double>(stop - start).count() /
+                   FLAGS_reps
+            << " ns per message" << std::endl;
+}
+
+/// Times the LCM decoding of an encoded message of type T
+template <typename T>
+void TimeDecode(const string& name, const T& msg) {
+  std::vector<uint8_t> bytes(msg.getEncodedSize());
+  msg.encode(bytes.data(), 0, bytes.size());
+  std::cout << name << " message: " << bytes.size() << " bytes" << std::endl;
+  T decoded;
+  Time("  lcm decode", [&](int) {
+    decoded.decode(bytes.data(), 0, bytes.size());
+  });
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant, nullptr, FLAGS_floating_base,
+                     "examples/Cassie/urdf/cassie_v2.urdf",
+                     true /*spring model*/, false /*loop closure*/);
+  plant.Finalize();
+
+  const int nq = plant.num_positions();
+  const int nv = plant.num_velocities();
+  const int nu = plant.num_actuators();
+  lcmt_robot_schema schema = systems::MakeRobotSchema(plant);
+
+  // Messages as sent by RobotOutputSender, with efforts
+  lcmt_robot_output full_msg;
+  full_msg.utime = 1;
+  full_msg.num_positions = nq;
+  full_msg.num_velocities = nv;
+  full_msg.num_efforts = nu;
+  full_msg.position_names = schema.position_names;
+  full_msg.velocity_names = schema.velocity_names;
+  full_msg.effort_names = schema.effort_names;
+  full_msg.position.resize(nq);
+  full_msg.velocity.resize(nv);
+  full_msg.effort.resize(nu);
+  for (int i = 0; i < nq; i++) {
+    full_msg.position[i] = i;
+  }
+  for (int i = 0; i < nv; i++) {
+    full_msg.velocity[i] = nq + i;
+  }
+  for (int i = 0; i < nu; i++) {
+    full_msg.effort[i] = nq + nv + i;
+  }
+
+  lcmt_robot_output_compact compact_msg;
+  compact_msg.utime = full_msg.utime;
+  compact_msg.schema = schema.fingerprint;
+  compact_msg.num_positions = nq;
+  compact_msg.num_velocities = nv;
+  compact_msg.num_efforts = nu;
+  compact_msg.position = full_msg.position;
+  compact_msg.velocity = full_msg.velocity;
+  compact_msg.effort = full_msg.effort;
+
+  TimeDecode("lcmt_robot_output", full_msg);
+  OutputVector<double> output(nq, nv, nu);
+  auto position_map = multibody::makeNameToPositionsMap(plant);
+  auto velocity_map = multibody::makeNameToVelocitiesMap(plant);
+  auto effort_map = multibody::makeNameToActuatorsMap(plant);
+  Time("  name lookups (before)", [&](int i) {
+    full_msg.utime = i;
+    CopyWithMaps(full_msg, position_map, velocity_map, effort_map, &output);
+  });
+
+  systems::RobotOutputReceiver receiver(plant);
+  auto context = receiver.CreateDefaultContext();
+  auto value = receiver.get_output_port(0).Allocate();
+  receiver.get_input_port(0).FixValue(context.get(), full_msg);
+  Time("  RobotOutputReceiver", [&](int) {
+    receiver.get_output_port(0).Calc(*context, value.get());
+  });
+
+  TimeDecode("lcmt_robot_output_compact", compact_msg);
+  systems::RobotOutputReceiver compact_receiver(
+      plant, systems::RobotMessageFormat::kCompact);
+  auto compact_context = compact_receiver.CreateDefaultContext();
+  compact_receiver.get_input_port(0).FixValue(compact_context.get(),
+                                              compact_msg);
+  Time("  RobotOutputReceiver", [&](int) {
+    compact_receiver.get_output_port(0).Calc(*compact_context, value.get());
+  });
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
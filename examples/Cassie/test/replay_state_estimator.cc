@@ -0,0 +1,341 @@
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include "lcm/lcm-cpp.hpp"
+
+#include "dairlib/lcmt_cassie_out.hpp"
+#include "dairlib/lcmt_robot_output.hpp"
+#include "examples/Cassie/cassie_state_estimator.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "examples/Cassie/networking/udp_lcm_translator.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "systems/framework/output_vector.h"
+#include "systems/framework/realtime.h"
+
+#include "drake/common/drake_throw.h"
+
+DEFINE_string(file, "", "LCM log holding the Cassie output messages to replay");
+DEFINE_string(channel, "CASSIE_OUTPUT", "Channel of the lcmt_cassie_out");
+DEFINE_string(output_channel, "CASSIE_STATE_DISPATCHER",
+              "Channel of the lcmt_robot_output that dispatcher_robot_out "
+              "published from them, to compare against");
+DEFINE_string(pcap, "",
+              "Replays the Cassie UDP packets of a pcap capture instead of "
+              "--file. Their capture times are not the times of the logged "
+              "outputs, so these are not compared.");
+DEFINE_int32(udp_port, 25001, "Destination port of the captured packets");
+DEFINE_int64(max_count, 1000000, "Max number of messages to replay");
+DEFINE_bool(floating_base, true, "Fixed or floating base model");
+DEFINE_int64(test_mode, -1, "hardware_test_mode of the estimator");
+DEFINE_double(tolerance, 1e-9,
+              "Largest position or velocity difference from the logged "
+              "outputs for the replay to pass");
+DEFINE_bool(compare_floating_base, true,
+            "Whether to compare the floating base state. It only matches if "
+            "the log starts with dispatcher_robot_out, since the replay "
+            "starts the EKF from the first logged output.");
+
+// Replays Cassie output messages through CassieStateEstimator::Update, as
+// fast as possible and without LCM or the Simulator, to benchmark the
+// estimator and check it for regressions against the outputs logged by
+// dispatcher_robot_out.
+namespace dairlib {
+namespace {
+
+using drake::systems::BasicVector;
+using systems::CassieStateEstimator;
+using systems::LatencyHistogram;
+using systems::OutputVector;
+
+typedef std::chrono::steady_clock my_clock;
+
+struct Message {
+  double time;
+  cassie_out_t cassie_out;
+};
+
+/// Reads the messages on FLAGS_channel, and the outputs on
+/// FLAGS_output_channel keyed by utime, from an LCM log
+void ReadLog(std::vector<Message>* messages,
+             std::map<int64_t, lcmt_robot_output>* outputs) {
+  lcm::LogFile log(FLAGS_file, "r");
+  DRAKE_THROW_UNLESS(log.good());
+  for (const lcm::LogEvent* event = log.readNextEvent();
+       event != nullptr && (int64_t)messages->size() < FLAGS_max_count;
+       event = log.readNextEvent()) {
+    if (event->channel == FLAGS_channel) {
+      lcmt_cassie_out message;
+      message.decode(event->data, 0, event->datalen);
+      messages->push_back({message.utime * 1e-6, {}});
+      cassieOutFromLcm(message, &messages->back().cassie_out);
+    } else if (event->channel == FLAGS_output_channel) {
+      lcmt_robot_output output;
+      output.decode(event->data, 0, event->datalen);
+      (*outputs)[output.utime] = output;
+    }
+  }
+}
+
+/// Reads the Cassie output packets sent to FLAGS_udp_port from a pcap
+/// capture of Ethernet or Linux cooked frames
+void ReadCapture(std::vector<Message>* messages) {
+  std::ifstream file(FLAGS_pcap, std::ios::binary);
+  DRAKE_THROW_UNLESS(file.good());
+  uint32_t header[6];
+  file.read(reinterpret_cast<char*>(header), sizeof(header));
+  // Only captures written in the byte order of this machine are read
+  const bool nanoseconds = header[0] == 0xa1b23c4d;
+  DRAKE_THROW_UNLESS(header[0] == 0xa1b2c3d4 || nanoseconds);
+  const uint32_t link_type = header[5];
+  DRAKE_THROW_UNLESS(link_type == 1 || link_type == 113);
+  const int link_header_size = link_type == 1 ? 14 : 16;
+
+  uint32_t record[4];
+  std::vector<uint8_t> frame;
+  while ((int64_t)messages->size() < FLAGS_max_count &&
+         file.read(reinterpret_cast<char*>(record), sizeof(record))) {
+    frame.resize(record[2]);
+    if (!file.read(reinterpret_cast<char*>(frame.data()), frame.size())) {
+      break;
+    }
+    // IPv4 and UDP headers, after the link layer one
+    if ((int)frame.size() < link_header_size + 20) {
+      continue;
+    }
+    uint16_t ether_type;
+    memcpy(&ether_type, &frame[link_header_size - 2], sizeof(ether_type));
+    if (ntohs(ether_type) != 0x0800) {
+      continue;
+    }
+    const uint8_t* ip = &frame[link_header_size];
+    const int ip_header_size = 4 * (ip[0] & 0x0f);
+    const uint8_t* udp = ip + ip_header_size;
+    const uint8_t* payload = udp + 8;
+    if (ip[9] != IPPROTO_UDP ||
+        payload + 2 + CASSIE_OUT_T_LEN != frame.data() + frame.size()) {
+      continue;
+    }
+    uint16_t port;
+    memcpy(&port, &udp[2], sizeof(port));
+    if (ntohs(port) != FLAGS_udp_port) {
+      continue;
+    }
+    const double time = record[0] + record[1] * (nanoseconds ? 1e-9 : 1e-6);
+    messages->push_back({time, {}});
+    unpack_cassie_out_t(&payload[2], &messages->back().cassie_out);
+  }
+}
+
+/// Largest difference between the values of a logged output and those of
+/// the same coordinates in an estimated one, over either the floating base
+/// coordinates or the joint ones
+double MaxDifference(const std::vector<std::string>& names,
+                     const std::vector<double>& logged,
+                     const std::map<std::string, int>& index_map,
+                     const Eigen::VectorXd& estimated, bool floating_base) {
+  double difference = 0;
+  for (size_t i = 0; i < names.size(); i++) {
+    if (floating_base == (names[i].find("base_") == 0)) {
+      difference = std::max(
+          difference, std::abs(estimated(index_map.at(names[i])) - logged[i]));
+    }
+  }
+  return difference;
+}
+
+double Seconds(my_clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<Message> messages;
+  std::map<int64_t, lcmt_robot_output> outputs;
+  if (!FLAGS_pcap.empty()) {
+    ReadCapture(&messages);
+  } else {
+    ReadLog(&messages, &outputs);
+  }
+  std::cout << "Read " << messages.size() << " messages and "
+            << outputs.size() << " outputs" << std::endl;
+  if (messages.size() < 2) {
+    return 1;
+  }
+
+  // Build Cassie MBP and the estimator, as dispatcher_robot_out does
+  drake::multibody::MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant, nullptr, FLAGS_floating_base /*floating base*/,
+                     "examples/Cassie/urdf/cassie_v2.urdf",
+                     true /*spring model*/, false /*loop closure*/);
+  plant.Finalize();
+
+  multibody::KinematicEvaluatorSet<double> fourbar_evaluator(plant);
+  auto left_loop = LeftLoopClosureEvaluator(plant);
+  auto right_loop = RightLoopClosureEvaluator(plant);
+  fourbar_evaluator.add_evaluator(&left_loop);
+  fourbar_evaluator.add_evaluator(&right_loop);
+  multibody::KinematicEvaluatorSet<double> left_contact_evaluator(plant);
+  auto left_toe = LeftToeFront(plant);
+  auto left_heel = LeftToeRear(plant);
+  auto left_toe_evaluator = multibody::WorldPointEvaluator(
+      plant, left_toe.first, left_toe.second, Eigen::Matrix3d::Identity(),
+      Eigen::Vector3d::Zero(), {1, 2});
+  auto left_heel_evaluator = multibody::WorldPointEvaluator(
+      plant, left_heel.first, left_heel.second, Eigen::Matrix3d::Identity(),
+      Eigen::Vector3d::Zero(), {0, 1, 2});
+  left_contact_evaluator.add_evaluator(&left_toe_evaluator);
+  left_contact_evaluator.add_evaluator(&left_heel_evaluator);
+  multibody::KinematicEvaluatorSet<double> right_contact_evaluator(plant);
+  auto right_toe = RightToeFront(plant);
+  auto right_heel = RightToeRear(plant);
+  auto right_toe_evaluator = multibody::WorldPointEvaluator(
+      plant, right_toe.first, right_toe.second, Eigen::Matrix3d::Identity(),
+      Eigen::Vector3d::Zero(), {1, 2});
+  auto right_heel_evaluator = multibody::WorldPointEvaluator(
+      plant, right_heel.first, right_heel.second, Eigen::Matrix3d::Identity(),
+      Eigen::Vector3d::Zero(), {0, 1, 2});
+  right_contact_evaluator.add_evaluator(&right_toe_evaluator);
+  right_contact_evaluator.add_evaluator(&right_heel_evaluator);
+
+  CassieStateEstimator estimator(plant, &fourbar_evaluator,
+                                 &left_contact_evaluator,
+                                 &right_contact_evaluator, false, false,
+                                 FLAGS_test_mode);
+  auto context = estimator.CreateDefaultContext();
+  auto& input_value = estimator.get_input_port(0).FixValue(
+      context.get(), messages[0].cassie_out);
+
+  const auto position_map = multibody::makeNameToPositionsMap(plant);
+  const auto velocity_map = multibody::makeNameToVelocitiesMap(plant);
+
+  // dispatcher_robot_out initializes the EKF from the first message, and
+  // only updates on the following ones. Start from the first logged pose.
+  if (FLAGS_floating_base) {
+    Eigen::Vector4d quaternion(1, 0, 0, 0);
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+    const auto first_output =
+        outputs.lower_bound(std::llround(messages[0].time * 1e6));
+    if (first_output != outputs.end()) {
+      Eigen::VectorXd q = Eigen::VectorXd::Zero(plant.num_positions());
+      for (int i = 0; i < first_output->second.num_positions; i++) {
+        q(position_map.at(first_output->second.position_names[i])) =
+            first_output->second.position[i];
+      }
+      quaternion = q.head(4);
+      position = q.segment<3>(4);
+    }
+    estimator.setPreviousTime(context.get(), messages[0].time);
+    estimator.setInitialPelvisPose(context.get(), quaternion, position);
+    Eigen::VectorXd imu_value(6);
+    imu_value << 0, 0, 0, 0, 0, 9.81;
+    estimator.setPreviousImuMeasurement(context.get(), imu_value);
+  }
+  // Update writes the next state, as the Simulator's unrestricted updates do
+  auto next_state = context->CloneState();
+
+  CassieStateEstimator::UpdateTimings timings;
+  estimator.set_update_timings(&timings);
+  LatencyHistogram update_times;
+  LatencyHistogram output_times;
+  LatencyHistogram kinematics_times;
+  LatencyHistogram fourbar_times;
+  LatencyHistogram propagate_times;
+  LatencyHistogram contact_times;
+  LatencyHistogram correct_times;
+
+  int num_compared = 0;
+  double joint_difference = 0;
+  double floating_base_difference = 0;
+
+  const auto start = my_clock::now();
+  for (size_t i = 1; i < messages.size(); i++) {
+    input_value.GetMutableData()->set_value(messages[i].cassie_out);
+    context->SetTime(messages[i].time);
+
+    if (FLAGS_floating_base) {
+      // Recorded before evaluating the output, whose four-bar solve also adds
+      // to the timings
+      timings = CassieStateEstimator::UpdateTimings();
+      const auto update_start = my_clock::now();
+      estimator.Update(*context, next_state.get());
+      context->get_mutable_state().SetFrom(*next_state);
+      update_times.Add(Seconds(my_clock::now() - update_start));
+      kinematics_times.Add(timings.kinematics);
+      fourbar_times.Add(timings.fourbar);
+      propagate_times.Add(timings.ekf_propagate);
+      contact_times.Add(timings.contact);
+      correct_times.Add(timings.ekf_correct);
+    }
+    const auto output_start = my_clock::now();
+    const auto& output = dynamic_cast<const OutputVector<double>&>(
+        estimator.get_robot_output_port().Eval<BasicVector<double>>(
+            *context));
+    output_times.Add(Seconds(my_clock::now() - output_start));
+
+    const auto logged = outputs.find(std::llround(messages[i].time * 1e6));
+    if (logged == outputs.end()) {
+      continue;
+    }
+    num_compared++;
+    for (bool floating_base : {false, true}) {
+      double& difference =
+          floating_base ? floating_base_difference : joint_difference;
+      difference = std::max(
+          {difference,
+           MaxDifference(logged->second.position_names,
+                         logged->second.position, position_map,
+                         output.GetPositions(), floating_base),
+           MaxDifference(logged->second.velocity_names,
+                         logged->second.velocity, velocity_map,
+                         output.GetVelocities(), floating_base)});
+    }
+  }
+  const double elapsed = Seconds(my_clock::now() - start);
+
+  const int num_updates = messages.size() - 1;
+  std::cout << num_updates << " messages replayed in " << elapsed << " s, "
+            << num_updates / elapsed << " messages/s" << std::endl;
+  if (FLAGS_floating_base) {
+    update_times.PrintSummary("Update", std::cout);
+    kinematics_times.PrintSummary("  kinematics", std::cout);
+    fourbar_times.PrintSummary("  four-bar solve", std::cout);
+    propagate_times.PrintSummary("  EKF propagate", std::cout);
+    contact_times.PrintSummary("  contact estimation", std::cout);
+    correct_times.PrintSummary("  EKF correct", std::cout);
+  }
+  output_times.PrintSummary("Output port", std::cout);
+
+  if (num_compared == 0) {
+    std::cout << "No logged output to compare against" << std::endl;
+    return 0;
+  }
+  std::cout << num_compared << " outputs compared, largest difference "
+            << joint_difference << " in the joints and "
+            << floating_base_difference << " in the floating base"
+            << std::endl;
+  const bool passed = joint_difference <= FLAGS_tolerance &&
+                      (!FLAGS_compare_floating_base ||
+                       floating_base_difference <= FLAGS_tolerance);
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return passed ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
@@ -30,6 +30,8 @@
 #include "common/file_utils.h"
 #include "lcm/dircon_saved_trajectory.h"
 #include "solvers/optimization_utils.h"
+#include "solvers/program_profiler.h"
+#include "systems/trajectory_optimization/dircon/continuation_pipeline.h"
 
 #include "examples/Spirit/spirit_utils.h"
 
@@ -41,8 +43,11 @@ DEFINE_double(tol, 2e-1, "Optimization Tolerance");
 DEFINE_double(mu, 1, "coefficient of friction");
 
 DEFINE_string(data_directory, "/home/shane/Drake_ws/dairlib/examples/Spirit/saved_trajectories/",
-              "directory to save/read data");
+              "directory to save/read data. It also caches the solution of "
+              "every stage as <stage>_<key>, and stale ones are removed "
+              "after each run.");
 DEFINE_bool(skipInitialOptimization, true, "skip first optimizations?");
+DEFINE_bool(profile, false, "print the evaluation time of each constraint");
 
 using drake::AutoDiffXd;
 using drake::multibody::MultibodyPlant;
@@ -724,8 +729,16 @@ void runSpiritJump(
   auto start = std::chrono::high_resolution_clock::now();
   auto solver = drake::solvers::MakeSolver(solver_id);
   drake::solvers::MathematicalProgramResult result;
-  solver->Solve(trajopt, trajopt.initial_guess(), trajopt.solver_options(),
-                &result);  auto finish = std::chrono::high_resolution_clock::now();
+  std::unique_ptr<solvers::ProgramProfiler> profiler;
+  if (FLAGS_profile) {
+    profiler = std::make_unique<solvers::ProgramProfiler>(trajopt);
+  }
+  solver->Solve(profiler ? profiler->get_prog() : trajopt,
+                trajopt.initial_guess(), trajopt.solver_options(), &result);
+  auto finish = std::chrono::high_resolution_clock::now();
+  if (profiler) {
+    profiler->PrintReport();
+  }
   std::chrono::duration<double> elapsed = finish - start;
   std::cout << "Solve time: " << elapsed.count() <<std::endl;
   std::cout << "Cost: " << result.get_optimal_cost() <<std::endl;
@@ -809,115 +822,135 @@ int main(int argc, char* argv[]) {
 
   std::string distance_name = std::to_string(int(floor(100*FLAGS_foreAftDisplacement)))+"cm";
 
-  if(!FLAGS_skipInitialOptimization){
-    std::cout<<"Running 1st optimization"<<std::endl;
-    //Hopping correct distance, but heavily constrained
-    dairlib::badInplaceBound(*plant, x_traj, u_traj, l_traj, lc_traj, vc_traj);
+  using dairlib::systems::trajectory_optimization::ContinuationParameters;
+  using dairlib::systems::trajectory_optimization::ContinuationPipeline;
+
+  // Every optimization in the continuation is a runSpiritJump call, with its
+  // numeric arguments given by the stage parameters.
+  auto solve_bound = [&](const ContinuationParameters& p,
+                         const std::string& file_in,
+                         const std::string& file_out) {
+    if (file_in.empty()) {
+      dairlib::badInplaceBound(*plant, x_traj, u_traj, l_traj, lc_traj, vc_traj);
+    }
     dairlib::runSpiritJump<double>(
         *plant,
         x_traj, u_traj, l_traj,
         lc_traj, vc_traj,
-        false,
-        true,
-        {7, 7, 7, 7, 7, 7} ,
+        false,  // The final trajectory is animated after the pipeline
+        p.at("ipopt") > 0,
+        std::vector<int>(6, static_cast<int>(p.at("knot_points"))),
         FLAGS_standHeight,
-        0.6,
-        0.1,
+        p.at("pitch_magnitude_lo"),
+        p.at("pitch_magnitude_apex"),
         FLAGS_apexGoal,       // Ignored if small
-        0,
-        1.8,
-        3,
-        10,
-        10/5.0,
-        5/5.0,
-        1000,
-        0,
-        100,
-        1e-3,
-        1e-2,
-        FLAGS_data_directory+"in_place_bound");
+        p.at("fore_aft_displacement"),
+        p.at("max_duration"),
+        p.at("cost_actuation"),
+        p.at("cost_velocity"),
+        p.at("cost_velocity_legs_flight"),
+        p.at("cost_actuation_legs_flight"),
+        p.at("cost_time"),
+        p.at("cost_work"),
+        p.at("mu"),
+        p.at("eps"),
+        p.at("tol"),
+        file_out,
+        file_in);
+  };
+
+  // Flags and solve inputs shared by all stages are part of every stage's
+  // cache key, so that changing any of them re-solves the stages
+  const ContinuationParameters common = {
+      {"stand_height", FLAGS_standHeight},
+      {"apex_goal", FLAGS_apexGoal},
+      {"knot_points", 7},
+      {"max_duration", 1.8},
+      {"cost_velocity_legs_flight", 10/5.0},
+      {"cost_actuation_legs_flight", 5/5.0},
+      {"ipopt", 1},
+  };
+  auto with_common = [&](ContinuationParameters p) {
+    p.insert(common.begin(), common.end());
+    return p;
+  };
+
+  // Edits to the constraints or costs of runSpiritJump are not in the
+  // parameters, so they should bump the version to invalidate the cache
+  ContinuationPipeline pipeline(FLAGS_data_directory, "spirit_bound_1");
+  if(!FLAGS_skipInitialOptimization){
+    //Hopping correct distance, but heavily constrained
+    pipeline.AddStage("in_place_bound_stage",
+                      with_common({{"pitch_magnitude_lo", 0.6},
+                                   {"pitch_magnitude_apex", 0.1},
+                                   {"fore_aft_displacement", 0},
+                                   {"cost_actuation", 3},
+                                   {"cost_velocity", 10},
+                                   {"cost_time", 1000},
+                                   {"cost_work", 0},
+                                   {"mu", 100},
+                                   {"eps", 1e-3},
+                                   {"tol", 1e-2}}),
+                      solve_bound, FLAGS_data_directory+"in_place_bound");
+  } else {
+    pipeline.SetInitialGuessFile(FLAGS_data_directory+"in_place_bound");
   }
 
-  std::cout<<"Running 2nd optimization"<<std::endl;
-
-  dairlib::runSpiritJump<double>(
-      *plant,
-      x_traj, u_traj, l_traj,
-      lc_traj, vc_traj,
-      false,
-      true,
-      {7, 7, 7, 7, 7, 7} ,
-      FLAGS_standHeight,
-      1.0,
-      0.3,
-      FLAGS_apexGoal,       // Ignored if small
-      FLAGS_foreAftDisplacement,
-      1.8,
-      3,
-      10,
-      10/5.0,
-      5/5.0,
-      1000,
-      0,
-      10,
-      1e-3,
-      1e0,
-      FLAGS_data_directory+"bound_"+distance_name,
-      FLAGS_data_directory+"in_place_bound");
-
-  std::cout<<"Running 3rd optimization"<<std::endl;
-
-  dairlib::runSpiritJump<double>(
-      *plant,
-      x_traj, u_traj, l_traj,
-      lc_traj, vc_traj,
-      false,
-      true,
-      {7, 7, 7, 7, 7, 7} ,
-      FLAGS_standHeight,
-      1.0,
-      0.3,
-      FLAGS_apexGoal,       // Ignored if small
-      FLAGS_foreAftDisplacement,
-      1.8,
-      3,
-      10,
-      10/5.0,
-      5/5.0,
-      1000,
-      0,
-      FLAGS_mu,
-      1e-3,
-      1e0,
-      FLAGS_data_directory+"bound_"+distance_name+"low_mu",
-      FLAGS_data_directory+"bound_"+distance_name);
-
-  std::cout<<"Running 4th optimization"<<std::endl;
-
-  dairlib::runSpiritJump<double>(
-      *plant,
-      x_traj, u_traj, l_traj,
-      lc_traj, vc_traj,
-      true,
-      true,
-      {7, 7, 7, 7, 7, 7} ,
-      FLAGS_standHeight,
-      1.0,
-      0.3,
-      FLAGS_apexGoal,       // Ignored if small
-      FLAGS_foreAftDisplacement,
-      1.8,
-      3/100.0,
-      10/100.0,
-      10/5.0,
-      5/5.0,
-      0,
-      100,
-      FLAGS_mu,
-      FLAGS_eps,
-      FLAGS_tol,
-      FLAGS_data_directory+"bound_"+distance_name+"min_work",
-      FLAGS_data_directory+"bound_"+distance_name+"low_mu");
+  pipeline.AddStage("bound_stage",
+                    with_common({{"pitch_magnitude_lo", 1.0},
+                                 {"pitch_magnitude_apex", 0.3},
+                                 {"fore_aft_displacement", FLAGS_foreAftDisplacement},
+                                 {"cost_actuation", 3},
+                                 {"cost_velocity", 10},
+                                 {"cost_time", 1000},
+                                 {"cost_work", 0},
+                                 {"mu", 10},
+                                 {"eps", 1e-3},
+                                 {"tol", 1e0}}),
+                    solve_bound, FLAGS_data_directory+"bound_"+distance_name);
+
+  pipeline.AddStage("low_mu_stage",
+                    with_common({{"pitch_magnitude_lo", 1.0},
+                                 {"pitch_magnitude_apex", 0.3},
+                                 {"fore_aft_displacement", FLAGS_foreAftDisplacement},
+                                 {"cost_actuation", 3},
+                                 {"cost_velocity", 10},
+                                 {"cost_time", 1000},
+                                 {"cost_work", 0},
+                                 {"mu", FLAGS_mu},
+                                 {"eps", 1e-3},
+                                 {"tol", 1e0}}),
+                    solve_bound,
+                    FLAGS_data_directory+"bound_"+distance_name+"low_mu");
+
+  ContinuationParameters min_work =
+      with_common({{"pitch_magnitude_lo", 1.0},
+                   {"pitch_magnitude_apex", 0.3},
+                   {"fore_aft_displacement", FLAGS_foreAftDisplacement},
+                   {"cost_actuation", 3/100.0},
+                   {"cost_velocity", 10/100.0},
+                   {"cost_time", 0},
+                   {"cost_work", 100},
+                   {"mu", FLAGS_mu},
+                   {"eps", FLAGS_eps},
+                   {"tol", FLAGS_tol}});
+  pipeline.AddStage("min_work_stage", min_work, solve_bound,
+                    FLAGS_data_directory+"bound_"+distance_name+"min_work");
+
+  pipeline.Run();
+  std::cout << "Solved " << pipeline.num_solved() << " of "
+            << pipeline.get_stage_files().size() << " stages" << std::endl;
+  // Solutions of earlier parameters would otherwise accumulate in the data
+  // directory
+  std::cout << "Removed " << pipeline.PruneCache() << " stale cached files"
+            << std::endl;
+
+  // Animate the final trajectory, once it is in the cache, since the
+  // animation never returns
+  dairlib::DirconTrajectory final_traj(pipeline.get_stage_files().back());
+  dairlib::runAnimate(std::move(plant), plant_vis.get(),
+                      std::move(scene_graph),
+                      final_traj.ReconstructStateTrajectory(), 0.25);
 }
 
 
@@ -0,0 +1,453 @@
+#include "lcm/compact_trajectory_encoding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace dairlib {
+
+namespace {
+
+const char kMagic[8] = {'D', 'A', 'I', 'R', 'C', 'T', 'R', 'J'};
+const uint64_t kVersion = 1;
+
+/// Row encodings
+const uint8_t kLossless = 0;
+const uint8_t kQuantized = 1;
+
+/// Block encodings
+const uint8_t kRaw = 0;
+const uint8_t kRans = 1;
+
+/// rANS parameters: 12 bit probabilities, 32 bit state, byte-wise output
+const int kProbabilityBits = 12;
+const uint32_t kProbabilityScale = 1u << kProbabilityBits;
+const uint32_t kRansLowerBound = 1u << 23;
+
+void WriteVarint(uint64_t value, vector<uint8_t>* bytes) {
+  while (value >= 0x80) {
+    bytes->push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  bytes->push_back(static_cast<uint8_t>(value));
+}
+
+void WriteString(const string& value, vector<uint8_t>* bytes) {
+  WriteVarint(value.size(), bytes);
+  bytes->insert(bytes->end(), value.begin(), value.end());
+}
+
+void WriteDouble(double value, vector<uint8_t>* bytes) {
+  uint8_t raw[sizeof(double)];
+  memcpy(raw, &value, sizeof(double));
+  bytes->insert(bytes->end(), raw, raw + sizeof(double));
+}
+
+uint64_t ZigZag(uint64_t value) {
+  return (value << 1) ^ (0 - (value >> 63));
+}
+
+uint64_t UnZigZag(uint64_t value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+/// Appends the second-order differences of the sequence. Arithmetic is modulo
+/// 2^64, so that any sequence, including bit patterns, round-trips exactly.
+void WriteResiduals(const vector<uint64_t>& sequence, vector<uint8_t>* bytes) {
+  for (size_t i = 0; i < sequence.size(); i++) {
+    uint64_t prediction = 0;
+    if (i == 1) {
+      prediction = sequence[0];
+    } else if (i > 1) {
+      prediction = 2 * sequence[i - 1] - sequence[i - 2];
+    }
+    WriteVarint(ZigZag(sequence[i] - prediction), bytes);
+  }
+}
+
+/// Appends one row, quantized if step > 0 and every value is then within
+/// step / 2 of the original, and losslessly otherwise
+void WriteRow(const double* values, int size, double step,
+              vector<uint8_t>* bytes) {
+  vector<uint64_t> sequence(size);
+  bool quantized = step > 0;
+  for (int i = 0; i < size && quantized; i++) {
+    double scaled = std::round(values[i] / step);
+    // Integers up to 9e15 are exact in double precision
+    quantized = std::abs(scaled) < 9e15 &&
+                std::abs(scaled * step - values[i]) <= 0.5 * step;
+    if (quantized) {
+      sequence[i] = static_cast<uint64_t>(static_cast<int64_t>(scaled));
+    }
+  }
+  if (!quantized) {
+    for (int i = 0; i < size; i++) {
+      memcpy(&sequence[i], &values[i], sizeof(double));
+    }
+  }
+  bytes->push_back(quantized ? kQuantized : kLossless);
+  WriteResiduals(sequence, bytes);
+}
+
+/// Normalizes the symbol counts to frequencies summing to kProbabilityScale,
+/// keeping every occurring symbol representable
+bool NormalizeFrequencies(const vector<uint64_t>& counts,
+                          vector<uint32_t>* frequencies) {
+  uint64_t total = 0;
+  for (uint64_t count : counts) {
+    total += count;
+  }
+  frequencies->assign(256, 0);
+  int64_t sum = 0;
+  int largest = 0;
+  for (int s = 0; s < 256; s++) {
+    if (counts[s] > 0) {
+      (*frequencies)[s] = std::max<uint64_t>(
+          1, counts[s] * kProbabilityScale / total);
+      sum += (*frequencies)[s];
+    }
+    if (counts[s] > counts[largest]) {
+      largest = s;
+    }
+  }
+  int64_t corrected = (*frequencies)[largest] + kProbabilityScale - sum;
+  if (corrected < 1) {
+    return false;
+  }
+  (*frequencies)[largest] = corrected;
+  return true;
+}
+
+/// Order-0 rANS encoding of data. The output is read front to back by
+/// RansDecode.
+bool RansEncode(const vector<uint8_t>& data, vector<uint32_t>* frequencies,
+                vector<uint8_t>* encoded) {
+  vector<uint64_t> counts(256, 0);
+  for (uint8_t symbol : data) {
+    counts[symbol]++;
+  }
+  if (!NormalizeFrequencies(counts, frequencies)) {
+    return false;
+  }
+  vector<uint32_t> cumulative(257, 0);
+  for (int s = 0; s < 256; s++) {
+    cumulative[s + 1] = cumulative[s] + (*frequencies)[s];
+  }
+
+  // rANS is last in, first out: encode backwards, then reverse the output
+  encoded->clear();
+  uint32_t state = kRansLowerBound;
+  for (auto it = data.rbegin(); it != data.rend(); ++it) {
+    uint32_t frequency = (*frequencies)[*it];
+    uint32_t max_state =
+        ((kRansLowerBound >> kProbabilityBits) << 8) * frequency;
+    while (state >= max_state) {
+      encoded->push_back(state & 0xff);
+      state >>= 8;
+    }
+    state = ((state / frequency) << kProbabilityBits) + (state % frequency) +
+            cumulative[*it];
+  }
+  for (int i = 0; i < 4; i++) {
+    encoded->push_back(state & 0xff);
+    state >>= 8;
+  }
+  std::reverse(encoded->begin(), encoded->end());
+  return true;
+}
+
+/// Bounds-checked reader of a decoded block
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  uint8_t ReadByte() {
+    if (position_ >= size_) {
+      throw std::runtime_error("Corrupt compact trajectory block");
+    }
+    return data_[position_++];
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ReadByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    throw std::runtime_error("Corrupt compact trajectory block");
+  }
+
+  /// Reads a row written by WriteRow
+  void ReadRow(double step, double* values, int size) {
+    uint8_t encoding = ReadByte();
+    if (encoding != kLossless && encoding != kQuantized) {
+      throw std::runtime_error("Corrupt compact trajectory block");
+    }
+    uint64_t previous = 0;
+    uint64_t before_previous = 0;
+    for (int i = 0; i < size; i++) {
+      uint64_t prediction = 0;
+      if (i == 1) {
+        prediction = previous;
+      } else if (i > 1) {
+        prediction = 2 * previous - before_previous;
+      }
+      uint64_t value = prediction + UnZigZag(ReadVarint());
+      if (encoding == kQuantized) {
+        values[i] = static_cast<int64_t>(value) * step;
+      } else {
+        memcpy(&values[i], &value, sizeof(double));
+      }
+      before_previous = previous;
+      previous = value;
+    }
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+/// Stream reading helpers, throwing on truncated input
+void ReadBytes(std::istream* in, void* data, size_t size) {
+  if (!in->read(static_cast<char*>(data), size)) {
+    throw std::runtime_error("Truncated compact trajectory");
+  }
+}
+
+uint64_t ReadVarint(std::istream* in) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    ReadBytes(in, &byte, 1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Corrupt compact trajectory");
+}
+
+string ReadString(std::istream* in) {
+  string value(ReadVarint(in), '\0');
+  ReadBytes(in, &value[0], value.size());
+  return value;
+}
+
+double ReadDouble(std::istream* in) {
+  double value;
+  ReadBytes(in, &value, sizeof(double));
+  return value;
+}
+
+/// Reads a block payload written by EncodeCompactTrajectory into data
+void ReadPayload(std::istream* in, vector<uint8_t>* data) {
+  uint8_t encoding;
+  ReadBytes(in, &encoding, 1);
+  data->resize(ReadVarint(in));
+  if (encoding == kRaw) {
+    ReadBytes(in, data->data(), data->size());
+    return;
+  }
+  if (encoding != kRans) {
+    throw std::runtime_error("Corrupt compact trajectory");
+  }
+
+  vector<uint32_t> frequencies(256);
+  vector<uint32_t> cumulative(257, 0);
+  for (int s = 0; s < 256; s++) {
+    frequencies[s] = ReadVarint(in);
+    cumulative[s + 1] = cumulative[s] + frequencies[s];
+  }
+  if (cumulative[256] != kProbabilityScale) {
+    throw std::runtime_error("Corrupt compact trajectory");
+  }
+  vector<uint8_t> symbols(kProbabilityScale);
+  for (int s = 0; s < 256; s++) {
+    std::fill(symbols.begin() + cumulative[s],
+              symbols.begin() + cumulative[s + 1], s);
+  }
+  vector<uint8_t> encoded(ReadVarint(in));
+  ReadBytes(in, encoded.data(), encoded.size());
+
+  ByteReader reader(encoded.data(), encoded.size());
+  uint32_t state = 0;
+  for (int i = 0; i < 4; i++) {
+    state = (state << 8) | reader.ReadByte();
+  }
+  for (auto& symbol : *data) {
+    uint32_t slot = state & (kProbabilityScale - 1);
+    symbol = symbols[slot];
+    state = frequencies[symbol] * (state >> kProbabilityBits) + slot -
+            cumulative[symbol];
+    while (state < kRansLowerBound) {
+      state = (state << 8) | reader.ReadByte();
+    }
+  }
+}
+
+}  // namespace
+
+void EncodeCompactTrajectory(const lcmt_saved_traj& traj,
+                             const CompactEncodingOptions& options,
+                             std::ostream& out) {
+  if (options.tolerance < 0) {
+    throw std::invalid_argument("Negative trajectory encoding tolerance");
+  }
+  const double step = 2 * options.tolerance;
+
+  vector<uint8_t> bytes(kMagic, kMagic + sizeof(kMagic));
+  WriteVarint(kVersion, &bytes);
+  bytes.push_back(traj.metadata.git_dirty_flag);
+  WriteString(traj.metadata.datetime, &bytes);
+  WriteString(traj.metadata.name, &bytes);
+  WriteString(traj.metadata.description, &bytes);
+  WriteString(traj.metadata.git_commit_hash, &bytes);
+  WriteVarint(traj.num_trajectories, &bytes);
+  out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+  vector<uint8_t> payload;
+  vector<uint8_t> encoded;
+  vector<uint32_t> frequencies;
+  for (int i = 0; i < traj.num_trajectories; i++) {
+    const lcmt_trajectory_block& block = traj.trajectories[i];
+    bytes.clear();
+    WriteString(traj.trajectory_names[i], &bytes);
+    WriteString(block.trajectory_name, &bytes);
+    WriteVarint(block.num_points, &bytes);
+    WriteVarint(block.num_datatypes, &bytes);
+    // 0 for a new list of datatypes, or 1 + the index of an earlier block
+    // with the same datatypes
+    int reference = 0;
+    for (int j = 0; j < i && reference == 0; j++) {
+      if (traj.trajectories[j].datatypes == block.datatypes) {
+        reference = j + 1;
+      }
+    }
+    WriteVarint(reference, &bytes);
+    if (reference == 0) {
+      for (const auto& datatype : block.datatypes) {
+        WriteString(datatype, &bytes);
+      }
+    }
+    WriteDouble(step, &bytes);
+
+    payload.clear();
+    WriteRow(block.time_vec.data(), block.num_points, 0, &payload);
+    for (const auto& row : block.datapoints) {
+      WriteRow(row.data(), block.num_points, step, &payload);
+    }
+
+    // Store the entropy coded payload only if it is smaller, including its
+    // frequency table
+    bool rans = options.entropy_code && payload.size() > 256 &&
+                RansEncode(payload, &frequencies, &encoded);
+    vector<uint8_t> table;
+    if (rans) {
+      for (uint32_t frequency : frequencies) {
+        WriteVarint(frequency, &table);
+      }
+      WriteVarint(encoded.size(), &table);
+      rans = table.size() + encoded.size() < payload.size();
+    }
+    bytes.push_back(rans ? kRans : kRaw);
+    WriteVarint(payload.size(), &bytes);
+    if (rans) {
+      bytes.insert(bytes.end(), table.begin(), table.end());
+      bytes.insert(bytes.end(), encoded.begin(), encoded.end());
+    } else {
+      bytes.insert(bytes.end(), payload.begin(), payload.end());
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+}
+
+bool IsCompactTrajectory(std::istream& in) {
+  char magic[sizeof(kMagic)];
+  auto position = in.tellg();
+  bool is_compact = in.read(magic, sizeof(magic)) &&
+                    memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  in.clear();
+  in.seekg(position);
+  return is_compact;
+}
+
+CompactTrajectoryReader::CompactTrajectoryReader(std::istream* in) : in_(in) {
+  char magic[sizeof(kMagic)];
+  ReadBytes(in_, magic, sizeof(magic));
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("Not a compact trajectory");
+  }
+  if (ReadVarint(in_) != kVersion) {
+    throw std::runtime_error("Unsupported compact trajectory version");
+  }
+  uint8_t git_dirty_flag;
+  ReadBytes(in_, &git_dirty_flag, 1);
+  metadata_.git_dirty_flag = git_dirty_flag;
+  metadata_.datetime = ReadString(in_);
+  metadata_.name = ReadString(in_);
+  metadata_.description = ReadString(in_);
+  metadata_.git_commit_hash = ReadString(in_);
+  num_trajectories_ = ReadVarint(in_);
+}
+
+bool CompactTrajectoryReader::ReadNext(string* trajectory_name,
+                                       lcmt_trajectory_block* block) {
+  if (num_read_ == num_trajectories_) {
+    return false;
+  }
+  *trajectory_name = ReadString(in_);
+  block->trajectory_name = ReadString(in_);
+  block->num_points = ReadVarint(in_);
+  block->num_datatypes = ReadVarint(in_);
+  uint64_t reference = ReadVarint(in_);
+  if (reference == 0) {
+    block->datatypes.resize(block->num_datatypes);
+    for (auto& datatype : block->datatypes) {
+      datatype = ReadString(in_);
+    }
+  } else if (reference <= datatypes_.size()) {
+    block->datatypes = datatypes_[reference - 1];
+  } else {
+    throw std::runtime_error("Corrupt compact trajectory");
+  }
+  if (static_cast<int>(block->datatypes.size()) != block->num_datatypes) {
+    throw std::runtime_error("Corrupt compact trajectory");
+  }
+  datatypes_.push_back(block->datatypes);
+  double step = ReadDouble(in_);
+
+  ReadPayload(in_, &buffer_);
+  ByteReader reader(buffer_.data(), buffer_.size());
+  block->time_vec.resize(block->num_points);
+  reader.ReadRow(0, block->time_vec.data(), block->num_points);
+  block->datapoints.resize(block->num_datatypes);
+  for (auto& row : block->datapoints) {
+    row.resize(block->num_points);
+    reader.ReadRow(step, row.data(), block->num_points);
+  }
+  num_read_++;
+  return true;
+}
+
+lcmt_saved_traj DecodeCompactTrajectory(std::istream& in) {
+  CompactTrajectoryReader reader(&in);
+  lcmt_saved_traj traj;
+  traj.metadata = reader.metadata();
+  traj.num_trajectories = reader.num_trajectories();
+  string trajectory_name;
+  lcmt_trajectory_block block;
+  while (reader.ReadNext(&trajectory_name, &block)) {
+    traj.trajectory_names.push_back(trajectory_name);
+    traj.trajectories.push_back(block);
+  }
+  return traj;
+}
+
+}  // namespace dairlib
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dairlib/lcmt_saved_traj.hpp"
+
+namespace dairlib {
+
+struct CompactEncodingOptions {
+  /// Maximum absolute error of each datapoint, or 0 to store the datapoints
+  /// losslessly. Time vectors are always stored losslessly.
+  double tolerance = 0;
+  /// Entropy codes each block, when that makes it smaller
+  bool entropy_code = true;
+};
+
+/// Compact file encoding of an lcmt_saved_traj, as an alternative to its LCM
+/// serialization for densely sampled trajectories and logs.
+///
+/// Every row of a block (the time vector, and each datatype) is turned into a
+/// sequence of integers: the bit patterns of the doubles when lossless, or the
+/// values rounded to multiples of 2 * tolerance otherwise. Each sequence is
+/// stored as its second-order differences (the error of a linear prediction
+/// from the two previous samples), which are small for smooth signals, as
+/// zigzag varints. The residuals of a block are then entropy coded with an
+/// order-0 rANS coder. Datatype names which are identical to those of an
+/// earlier block are stored as a reference to it.
+///
+/// Blocks are stored one after the other, each with its own header, so that
+/// CompactTrajectoryReader decodes them one at a time from a stream.
+void EncodeCompactTrajectory(const lcmt_saved_traj& traj,
+                             const CompactEncodingOptions& options,
+                             std::ostream& out);
+
+/// Returns true if the stream is positioned at the start of a compact
+/// encoding. Does not consume any input.
+bool IsCompactTrajectory(std::istream& in);
+
+/// Decodes a compact encoding block by block
+class CompactTrajectoryReader {
+ public:
+  /// Reads the metadata
+  /// @throws std::runtime_error if the stream is not a compact encoding
+  explicit CompactTrajectoryReader(std::istream* in);
+
+  const lcmt_metadata& metadata() const { return metadata_; }
+
+  int num_trajectories() const { return num_trajectories_; }
+
+  /// Decodes the next block into block, along with its name in
+  /// lcmt_saved_traj::trajectory_names
+  /// @return false, without reading, after the last block
+  /// @throws std::runtime_error if the stream is truncated or corrupt
+  bool ReadNext(std::string* trajectory_name, lcmt_trajectory_block* block);
+
+ private:
+  std::istream* in_;
+  lcmt_metadata metadata_;
+  int num_trajectories_ = 0;
+  int num_read_ = 0;
+  /// Datatypes of every block read so far, for references to them
+  std::vector<std::vector<std::string>> datatypes_;
+  std::vector<uint8_t> buffer_;
+};
+
+/// Decodes a whole compact encoding
+lcmt_saved_traj DecodeCompactTrajectory(std::istream& in);
+
+}  // namespace dairlib
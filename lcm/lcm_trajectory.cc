@@ -133,32 +133,48 @@ void LcmTrajectory::WriteToFile(const string& filepath) {
   }
 }
 
-void LcmTrajectory::LoadFromFile(const std::string& filepath) {
-  std::vector<uint8_t> bytes;
-  drake::systems::lcm::Serializer<lcmt_saved_traj> serializer;
-  try {
-    std::ifstream inFile(filepath, std::ios_base::binary);
-
-    // Determine size of buffer
-    inFile.seekg(0, std::ios_base::end);
-    size_t length = inFile.tellg();
-    inFile.seekg(0, std::ios_base::beg);
-
-    bytes.reserve(length);
-    std::copy(std::istreambuf_iterator<char>(inFile),
-              std::istreambuf_iterator<char>(), std::back_inserter(bytes));
-    inFile.close();
-  } catch (std::exception& e) {
-    std::cerr << "Could not open file: " << filepath
-              << "\nException: " << e.what() << std::endl;
-    throw e;
+void LcmTrajectory::WriteToFile(const string& filepath,
+                                const CompactEncodingOptions& options) {
+  std::ofstream fout(filepath, std::ios_base::binary);
+  if (!fout) {
+    std::cerr << "Could not open file: " << filepath << std::endl;
+    throw std::runtime_error("Could not open file: " + filepath);
   }
-  // Deserialization process
+  EncodeCompactTrajectory(GenerateLcmObject(), options, fout);
+}
+
+void LcmTrajectory::LoadFromFile(const std::string& filepath) {
   lcmt_saved_traj traj;
-  std::unique_ptr<AbstractValue> traj_value = AbstractValue::Make(traj);
-  serializer.Deserialize(reinterpret_cast<void*>(bytes.data()),
-                         static_cast<int>(bytes.size()), traj_value.get());
-  traj = traj_value->get_value<lcmt_saved_traj>();
+  std::ifstream compactFile(filepath, std::ios_base::binary);
+  if (compactFile && IsCompactTrajectory(compactFile)) {
+    // Decoded block by block, as the file is read
+    traj = DecodeCompactTrajectory(compactFile);
+  } else {
+    std::vector<uint8_t> bytes;
+    drake::systems::lcm::Serializer<lcmt_saved_traj> serializer;
+    try {
+      std::ifstream inFile(filepath, std::ios_base::binary);
+
+      // Determine size of buffer
+      inFile.seekg(0, std::ios_base::end);
+      size_t length = inFile.tellg();
+      inFile.seekg(0, std::ios_base::beg);
+
+      bytes.reserve(length);
+      std::copy(std::istreambuf_iterator<char>(inFile),
+                std::istreambuf_iterator<char>(), std::back_inserter(bytes));
+      inFile.close();
+    } catch (std::exception& e) {
+      std::cerr << "Could not open file: " << filepath
+                << "\nException: " << e.what() << std::endl;
+      throw e;
+    }
+    // Deserialization process
+    std::unique_ptr<AbstractValue> traj_value = AbstractValue::Make(traj);
+    serializer.Deserialize(reinterpret_cast<void*>(bytes.data()),
+                           static_cast<int>(bytes.size()), traj_value.get());
+    traj = traj_value->get_value<lcmt_saved_traj>();
+  }
 
   metadata_ = traj.metadata;
   trajectories_ = unordered_map<string, Trajectory>();
@@ -7,6 +7,7 @@
 #include <Eigen/Dense>
 
 #include "dairlib/lcmt_saved_traj.hpp"
+#include "lcm/compact_trajectory_encoding.h"
 
 #include "drake/systems/lcm/serializer.h"
 
@@ -54,8 +55,14 @@ class LcmTrajectory {
   /// the file
   void WriteToFile(const std::string& filepath);
 
+  /// Writes this LcmTrajectory object to a file in the compact encoding (see
+  /// EncodeCompactTrajectory), which LoadFromFile recognizes
+  /// @throws std::exception if unable to open the file
+  void WriteToFile(const std::string& filepath,
+                   const CompactEncodingOptions& options);
+
   /// Loads a previously saved LcmTrajectory object from the file specified by
-  /// filepath
+  /// filepath, in either the LCM or the compact encoding
   /// @throws std::exception along with the invalid filepath if error
   /// reading/opening the file
   virtual void LoadFromFile(const std::string& filepath);
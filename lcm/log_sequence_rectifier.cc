@@ -1,126 +1,435 @@
-#include <string.h>
-#include <inttypes.h>
-#include <lcm/lcm.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <iostream>
-#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
 
 /**
-  This is a simple program to fix any LCM messages that may be out of sequence
-  in a log file. The usage is:
+  This is a program to fix any LCM messages that may be out of sequence in a
+  log file, by sorting its events by timestamp. The usage is:
 
-    log_sequence_rectifier <file_in> <file_out>
+    log_sequence_rectifier [--window=1.0] <file_in> <file_out>
 
-  The program uses a max-length buffer, that must be large enough so that out of
-  sequence messages must appear at most kBufferLength-messages apart. An error
-  message will be generated if this assumption fails.
-*/
+  Events are streamed through a buffer holding the last --window seconds of
+  the log, a queue of the events in order and a min-heap of the late ones, so
+  that memory is bounded by the data rate of the log rather than its length.
+  An event is written once an event at least --window seconds newer has been
+  read. If an event arrives later than that, or the buffer outgrows
+  --max_memory_mb, the log is instead sorted externally: sorted runs of at
+  most --max_memory_mb are written to --tmp_dir and then merged.
 
-constexpr int kBufferLength = 20;
+  Events are copied as raw records, with only their timestamps decoded and
+  their event numbers renumbered, through large stdio buffers. Events with
+  equal timestamps keep their order.
+*/
 
-bool event_sorter(lcm_eventlog_event_t* const& lhs,
-    lcm_eventlog_event_t* const& rhs) {
-  return lhs->timestamp < rhs->timestamp;
-}
+DEFINE_double(window, 1.0,
+              "Maximum time, in seconds, by which an event may be logged out "
+              "of order before falling back to an external sort");
+DEFINE_int32(max_memory_mb, 1024,
+             "Maximum size of the buffered events, in MB");
+DEFINE_string(tmp_dir, "",
+              "Directory of the sorted runs of an external sort. Defaults to "
+              "the directory of the output file");
 
-int main(int argc, char **argv) {
-  int N = 0;
-  std::list<lcm_eventlog_event_t*> buffer;
+namespace dairlib {
+namespace {
 
-  lcm_eventlog_t *log, *log_out;
-  if (argc < 3) {
-    fprintf(stderr, "usage: log_sequence_rectifier <file_in> <file_out>\n");
-    return 1;
-  }
+typedef std::chrono::steady_clock my_clock;
 
-  log = lcm_eventlog_create(argv[1], "r");
+constexpr uint32_t kSyncWord = 0xEDA1DA01;
+/// Sync word, event number, timestamp, channel length and data length
+constexpr int kHeaderSize = 4 + 8 + 8 + 4 + 4;
+constexpr int kMaxChannelLength = 256;
+constexpr size_t kIoBufferSize = 1 << 22;
 
-  if (!log) {
-    fprintf(stderr, "couldn't open input log file\n");
-    return 1;
+uint64_t DecodeBigEndian(const char* bytes, int size) {
+  uint64_t value = 0;
+  for (int i = 0; i < size; i++) {
+    value = (value << 8) | static_cast<uint8_t>(bytes[i]);
   }
+  return value;
+}
 
-  log_out = lcm_eventlog_create(argv[2], "w");
-  if (!log_out) {
-    fprintf(stderr, "couldn't open output log file\n");
-    return 1;
+void EncodeBigEndian(uint64_t value, int size, char* bytes) {
+  for (int i = size - 1; i >= 0; i--) {
+    bytes[i] = static_cast<char>(value & 0xFF);
+    value >>= 8;
   }
+}
 
-  int64_t last_timestamp = 0;
-  int64_t last_write_timestamp = 0;
-  while (1) {
-    lcm_eventlog_event_t *event = lcm_eventlog_read_next_event(log);
+/// An event as it is stored in the log
+struct Record {
+  int64_t timestamp;
+  /// Position in the input log, which orders events of equal timestamps
+  int64_t sequence;
+  std::string bytes;
+};
 
+/// Orders a std heap so that the oldest record is at its front
+bool NewerThan(const Record& lhs, const Record& rhs) {
+  return lhs.timestamp > rhs.timestamp ||
+         (lhs.timestamp == rhs.timestamp && lhs.sequence > rhs.sequence);
+}
 
-    if (!event) {
-      break;
+bool OlderThan(const Record& lhs, const Record& rhs) {
+  return NewerThan(rhs, lhs);
+}
+
+class RecordReader {
+ public:
+  explicit RecordReader(const std::string& filepath,
+                        size_t buffer_size = kIoBufferSize)
+      : file_(fopen(filepath.c_str(), "rb")), buffer_(buffer_size) {
+    if (!file_) {
+      throw std::runtime_error("Could not open file: " + filepath);
     }
+    setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+  }
 
-    // Copy the event and add to the buffer
-    lcm_eventlog_event_t* e = new lcm_eventlog_event_t;
-    e->eventnum = event->eventnum;
-    e->timestamp = event->timestamp;
-    e->channellen = event->channellen;
-    e->datalen = event->datalen;
-    e->channel = strdup(event->channel);
-    e->data = malloc(e->datalen);
-    memcpy(e->data, event->data, e->datalen);
-    buffer.push_back(e);
-    N++;
-
-    // If buffer is long enough, sort and write oldest message
-    if (N == kBufferLength) {
-      buffer.sort(event_sorter);
-      lcm_eventlog_write_event(log_out, buffer.front());
-
-      int64_t timestamp = buffer.front()->timestamp;
-      if (timestamp < last_write_timestamp) {
-        std::cout <<
-            "ERROR: buffer size too small to capture out-of-order message!"
-            << std::endl;
+  ~RecordReader() { fclose(file_); }
+
+  /// Reads the next event, skipping garbage up to the next sync word as
+  /// lcm_eventlog does. Returns false at the end of the log or at a truncated
+  /// or invalid event.
+  bool Read(Record* record) {
+    char header[kHeaderSize];
+    if (fread(header, 1, 4, file_) != 4) {
+      return false;
+    }
+    while (DecodeBigEndian(header, 4) != kSyncWord) {
+      memmove(header, header + 1, 3);
+      if (fread(header + 3, 1, 1, file_) != 1) {
+        return false;
       }
-      last_write_timestamp = timestamp;
+    }
+    if (fread(header + 4, 1, kHeaderSize - 4, file_) != kHeaderSize - 4) {
+      return false;
+    }
+    int64_t channel_length = static_cast<int32_t>(DecodeBigEndian(
+        header + 20, 4));
+    int64_t data_length = static_cast<int32_t>(DecodeBigEndian(
+        header + 24, 4));
+    if (channel_length <= 0 || channel_length >= kMaxChannelLength ||
+        data_length < 0) {
+      std::cerr << "Stopping at an invalid event" << std::endl;
+      return false;
+    }
+    record->timestamp = static_cast<int64_t>(DecodeBigEndian(header + 12, 8));
+    record->sequence = sequence_++;
+    record->bytes.resize(kHeaderSize + channel_length + data_length);
+    memcpy(&record->bytes[0], header, kHeaderSize);
+    size_t body_size = channel_length + data_length;
+    if (fread(&record->bytes[kHeaderSize], 1, body_size, file_) != body_size) {
+      std::cerr << "Stopping at a truncated event" << std::endl;
+      return false;
+    }
+    bytes_read_ += record->bytes.size();
+    return true;
+  }
 
+  int64_t bytes_read() const { return bytes_read_; }
 
+ private:
+  FILE* file_;
+  std::vector<char> buffer_;
+  int64_t sequence_ = 0;
+  int64_t bytes_read_ = 0;
+};
 
-      // Free and remove message
-      free(buffer.front()->channel);
-      free(buffer.front()->data);
-      delete buffer.front();
-      buffer.pop_front();
-      N--;
+class RecordWriter {
+ public:
+  /// @param renumber Whether to number events in the order they are written,
+  ///   as lcm_eventlog_write_event does
+  RecordWriter(const std::string& filepath, bool renumber,
+               size_t buffer_size = kIoBufferSize)
+      : filepath_(filepath),
+        file_(fopen(filepath.c_str(), "wb")),
+        buffer_(buffer_size),
+        renumber_(renumber) {
+    if (!file_) {
+      throw std::runtime_error("Could not open file: " + filepath);
     }
+    setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+  }
 
-    if (event->timestamp < last_timestamp) {
-      std::cout << "Found a message out of order." << std::endl;
+  ~RecordWriter() {
+    if (file_) {
+      fclose(file_);
     }
+  }
 
-    last_timestamp = event->timestamp;
+  void Write(Record* record) {
+    if (renumber_) {
+      EncodeBigEndian(num_written_, 8, &record->bytes[4]);
+    }
+    if (fwrite(record->bytes.data(), 1, record->bytes.size(), file_) !=
+        record->bytes.size()) {
+      throw std::runtime_error("Could not write file: " + filepath_);
+    }
+    num_written_++;
+  }
 
-    lcm_eventlog_free_event(event);
+  void Close() {
+    int status = fclose(file_);
+    file_ = nullptr;
+    if (status != 0) {
+      throw std::runtime_error("Could not write file: " + filepath_);
+    }
   }
 
-  // Write remaining messages
-  buffer.sort(event_sorter);
-  while (N > 0) {
-    lcm_eventlog_write_event(log_out, buffer.front());
+  int64_t num_written() const { return num_written_; }
+
+ private:
+  std::string filepath_;
+  FILE* file_;
+  std::vector<char> buffer_;
+  bool renumber_;
+  int64_t num_written_ = 0;
+};
+
+struct Statistics {
+  int64_t num_events = 0;
+  int64_t num_out_of_order = 0;
+  /// Largest time by which an event trailed the newest event before it
+  int64_t max_lateness = 0;
+};
+
+/// Sorts the log through the events of the last window (in microseconds).
+/// Events at least as new as every event before them are queued in order, and
+/// only late events go through a heap. Returns false, leaving a partial
+/// output, if an event is later than the window or the buffered events
+/// outgrow max_memory.
+bool RectifyStreaming(const std::string& file_in, const std::string& file_out,
+                      int64_t window, size_t max_memory, Statistics* stats,
+                      int64_t* bytes_read) {
+  RecordReader reader(file_in);
+  RecordWriter writer(file_out, true);
+  std::deque<Record> in_order;
+  std::vector<Record> late;
+  // Written records, whose buffers are reused by the reader
+  std::vector<Record> spare;
+  size_t buffered_bytes = 0;
+  int64_t newest = INT64_MIN;
+  int64_t last_written = INT64_MIN;
+
+  auto write_oldest = [&]() {
+    const bool from_late =
+        !late.empty() &&
+        (in_order.empty() || !OlderThan(in_order.front(), late.front()));
+    if (from_late) {
+      std::pop_heap(late.begin(), late.end(), NewerThan);
+    }
+    Record* oldest = from_late ? &late.back() : &in_order.front();
+    last_written = oldest->timestamp;
+    buffered_bytes -= oldest->bytes.size();
+    writer.Write(oldest);
+    spare.push_back(std::move(*oldest));
+    if (from_late) {
+      late.pop_back();
+    } else {
+      in_order.pop_front();
+    }
+  };
+  auto oldest_timestamp = [&]() {
+    int64_t timestamp = INT64_MAX;
+    if (!in_order.empty()) {
+      timestamp = in_order.front().timestamp;
+    }
+    if (!late.empty()) {
+      timestamp = std::min(timestamp, late.front().timestamp);
+    }
+    return timestamp;
+  };
 
-      int64_t timestamp = buffer.front()->timestamp;
-      if (timestamp < last_write_timestamp) {
-        std::cout <<
-            "ERROR: buffer size too small to capture out-of-order message!"
-            << std::endl;
+  bool ok = true;
+  while (true) {
+    if (spare.empty()) {
+      spare.emplace_back();
+    }
+    Record& record = spare.back();
+    if (!reader.Read(&record)) {
+      break;
+    }
+    stats->num_events++;
+    if (record.timestamp < last_written) {
+      std::cout << "Found a message more than " << 1e-6 * window
+                << " s out of order." << std::endl;
+      ok = false;
+      break;
+    }
+    buffered_bytes += record.bytes.size();
+    if (record.timestamp >= newest) {
+      newest = record.timestamp;
+      in_order.push_back(std::move(record));
+    } else {
+      stats->num_out_of_order++;
+      stats->max_lateness =
+          std::max(stats->max_lateness, newest - record.timestamp);
+      late.push_back(std::move(record));
+      std::push_heap(late.begin(), late.end(), NewerThan);
+    }
+    spare.pop_back();
+
+    while (oldest_timestamp() <= newest - window) {
+      write_oldest();
+    }
+    if (buffered_bytes > max_memory) {
+      std::cout << "The events of the last " << 1e-6 * window
+                << " s exceed --max_memory_mb." << std::endl;
+      ok = false;
+      break;
+    }
+  }
+  while (ok && (!in_order.empty() || !late.empty())) {
+    write_oldest();
+  }
+  writer.Close();
+  *bytes_read = reader.bytes_read();
+  return ok;
+}
+
+/// Sorts the log by writing sorted runs of at most max_memory bytes to
+/// tmp_dir, and merging them
+void RectifyExternal(const std::string& file_in, const std::string& file_out,
+                     const std::string& tmp_dir, size_t max_memory,
+                     int64_t* bytes_read) {
+  RecordReader reader(file_in);
+  std::vector<std::string> runs;
+  std::vector<Record> chunk;
+  size_t chunk_bytes = 0;
+  bool done = false;
+  while (!done) {
+    Record record;
+    done = !reader.Read(&record);
+    if (!done) {
+      chunk_bytes += record.bytes.size();
+      chunk.push_back(std::move(record));
+    }
+    if ((chunk_bytes < max_memory && !done) ||
+        (chunk.empty() && !runs.empty())) {
+      continue;
+    }
+    std::sort(chunk.begin(), chunk.end(), OlderThan);
+    if (done && runs.empty()) {
+      // The log fits in memory
+      RecordWriter writer(file_out, true);
+      for (auto& sorted : chunk) {
+        writer.Write(&sorted);
       }
-      last_write_timestamp = timestamp;
+      writer.Close();
+      *bytes_read = reader.bytes_read();
+      return;
+    }
+    std::string run = tmp_dir + "/log_sequence_rectifier_run_XXXXXX";
+    int fd = mkstemp(&run[0]);
+    if (fd < 0) {
+      throw std::runtime_error("Could not create a run in " + tmp_dir);
+    }
+    close(fd);
+    runs.push_back(run);
+    RecordWriter writer(run, false);
+    for (auto& sorted : chunk) {
+      writer.Write(&sorted);
+    }
+    writer.Close();
+    chunk.clear();
+    chunk_bytes = 0;
+  }
+  *bytes_read = reader.bytes_read();
 
+  // The heap holds the timestamp and run of the head of every run. Runs are
+  // consecutive parts of the log, so ordering equal timestamps by run keeps
+  // their order.
+  std::vector<std::unique_ptr<RecordReader>> run_readers;
+  std::vector<Record> heads(runs.size());
+  std::vector<Record> heap;
+  for (size_t i = 0; i < runs.size(); i++) {
+    run_readers.push_back(std::make_unique<RecordReader>(
+        runs[i], std::max<size_t>(kIoBufferSize / runs.size(), 1 << 16)));
+    if (run_readers[i]->Read(&heads[i])) {
+      heap.push_back({heads[i].timestamp, static_cast<int64_t>(i), ""});
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), NewerThan);
+  RecordWriter writer(file_out, true);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), NewerThan);
+    int run = heap.back().sequence;
+    heap.pop_back();
+    writer.Write(&heads[run]);
+    if (run_readers[run]->Read(&heads[run])) {
+      heap.push_back({heads[run].timestamp, run, ""});
+      std::push_heap(heap.begin(), heap.end(), NewerThan);
+    }
+  }
+  writer.Close();
+  for (const auto& run : runs) {
+    std::remove(run.c_str());
+  }
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::SetUsageMessage(
+      "log_sequence_rectifier [--window=1.0] <file_in> <file_out>");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc < 3) {
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+  const std::string file_in = argv[1];
+  const std::string file_out = argv[2];
+  std::string tmp_dir = FLAGS_tmp_dir;
+  if (tmp_dir.empty()) {
+    size_t slash = file_out.rfind('/');
+    tmp_dir = (slash == std::string::npos) ? "." : file_out.substr(0, slash);
+  }
+  const size_t max_memory = static_cast<size_t>(FLAGS_max_memory_mb) << 20;
 
-    // Free and remove message
-    free(buffer.front()->channel);
-    free(buffer.front()->data);
-    delete buffer.front();
-    buffer.pop_front();
-    N--;
+  auto start = my_clock::now();
+  Statistics stats;
+  int64_t bytes_read = 0;
+  bool streamed = RectifyStreaming(file_in, file_out,
+                                   std::llround(1e6 * FLAGS_window),
+                                   max_memory, &stats, &bytes_read);
+  if (!streamed) {
+    std::cout << "Falling back to an external sort." << std::endl;
+    RectifyExternal(file_in, file_out, tmp_dir, max_memory, &bytes_read);
   }
+  double elapsed =
+      std::chrono::duration<double>(my_clock::now() - start).count();
 
-  lcm_eventlog_destroy(log);
+  std::cout << (streamed ? "Streamed " : "Sorted ") << bytes_read * 1e-6
+            << " MB in " << elapsed << " s (" << bytes_read * 1e-6 / elapsed
+            << " MB/s)" << std::endl;
+  if (streamed) {
+    std::cout << stats.num_events << " events, " << stats.num_out_of_order
+              << " out of order, by at most " << 1e-6 * stats.max_lateness
+              << " s" << std::endl;
+  }
   return 0;
 }
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  try {
+    return dairlib::DoMain(argc, argv);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,293 @@
+#include "lcm/mapped_trajectory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "drake/common/drake_assert.h"
+
+using Eigen::Map;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace dairlib {
+
+namespace {
+
+const char kMagic[8] = {'D', 'A', 'I', 'R', 'M', 'T', 'R', 'J'};
+const uint64_t kVersion = 2;
+const uint64_t kAlignment = 64;
+
+uint64_t Align(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void AppendUint64(uint64_t value, string* bytes) {
+  bytes->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(const string& value, string* bytes) {
+  AppendUint64(value.size(), bytes);
+  bytes->append(value);
+}
+
+/// Builds the header, up to and excluding the alignment padding, given the
+/// offsets of the time vector and datapoints of every trajectory. Its length
+/// does not depend on the offsets.
+string SerializeHeader(
+    const LcmTrajectory& traj,
+    const vector<std::pair<uint64_t, uint64_t>>& offsets) {
+  const lcmt_metadata metadata = traj.GetMetadata();
+  const auto& names = traj.GetTrajectoryNames();
+  string bytes(kMagic, sizeof(kMagic));
+  AppendUint64(kVersion, &bytes);
+  AppendUint64(metadata.git_dirty_flag, &bytes);
+  AppendString(metadata.datetime, &bytes);
+  AppendString(metadata.name, &bytes);
+  AppendString(metadata.description, &bytes);
+  AppendString(metadata.git_commit_hash, &bytes);
+  AppendUint64(names.size(), &bytes);
+  for (size_t i = 0; i < names.size(); i++) {
+    const auto& block = traj.GetTrajectory(names[i]);
+    AppendString(names[i], &bytes);
+    AppendUint64(block.time_vector.size(), &bytes);
+    AppendUint64(block.datatypes.size(), &bytes);
+    for (const auto& datatype : block.datatypes) {
+      AppendString(datatype, &bytes);
+    }
+    AppendUint64(offsets[i].first, &bytes);
+    AppendUint64(offsets[i].second, &bytes);
+  }
+  return bytes;
+}
+
+/// Bounds-checked reader of the header
+class HeaderReader {
+ public:
+  HeaderReader(const uint8_t* data, size_t size, const string& filepath)
+      : data_(data), size_(size), filepath_(filepath) {}
+
+  void Read(void* value, size_t length) {
+    if (position_ + length > size_) {
+      throw std::runtime_error("Truncated trajectory file: " + filepath_);
+    }
+    memcpy(value, data_ + position_, length);
+    position_ += length;
+  }
+
+  uint64_t ReadUint64() {
+    uint64_t value;
+    Read(&value, sizeof(value));
+    return value;
+  }
+
+  string ReadString() {
+    uint64_t length = ReadUint64();
+    if (length > size_ - position_) {
+      throw std::runtime_error("Truncated trajectory file: " + filepath_);
+    }
+    string value(reinterpret_cast<const char*>(data_ + position_), length);
+    position_ += length;
+    return value;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  const string& filepath_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+LcmTrajectory::Trajectory MappedLcmTrajectory::TrajectoryView::Copy() const {
+  LcmTrajectory::Trajectory traj;
+  traj.traj_name = traj_name;
+  traj.time_vector = time_vector;
+  traj.datapoints = datapoints;
+  traj.datatypes = datatypes;
+  return traj;
+}
+
+MappedLcmTrajectory::MappedLcmTrajectory(const string& filepath) {
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0) {
+    close(fd);
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  size_ = file_stat.st_size;
+  void* data = (size_ > 0)
+                   ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0)
+                   : MAP_FAILED;
+  // The mapping stays valid after the file is closed
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Could not map file: " + filepath);
+  }
+  data_ = static_cast<const uint8_t*>(data);
+
+  try {
+    ParseIndex(filepath);
+  } catch (...) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+    throw;
+  }
+}
+
+MappedLcmTrajectory::~MappedLcmTrajectory() {
+  munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+void MappedLcmTrajectory::ParseIndex(const string& filepath) {
+  HeaderReader reader(data_, size_, filepath);
+  char magic[sizeof(kMagic)];
+  reader.Read(magic, sizeof(magic));
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("Not a mapped trajectory file: " + filepath);
+  }
+  if (reader.ReadUint64() != kVersion) {
+    throw std::runtime_error("Unsupported trajectory file version: " +
+                             filepath);
+  }
+  metadata_.git_dirty_flag = reader.ReadUint64();
+  metadata_.datetime = reader.ReadString();
+  metadata_.name = reader.ReadString();
+  metadata_.description = reader.ReadString();
+  metadata_.git_commit_hash = reader.ReadString();
+
+  uint64_t num_trajectories = reader.ReadUint64();
+  for (uint64_t i = 0; i < num_trajectories; i++) {
+    string name = reader.ReadString();
+    Entry entry;
+    entry.num_points = reader.ReadUint64();
+    entry.num_datatypes = reader.ReadUint64();
+    for (int j = 0; j < entry.num_datatypes; j++) {
+      entry.datatypes.push_back(reader.ReadString());
+    }
+    entry.time_offset = reader.ReadUint64();
+    entry.datapoints_offset = reader.ReadUint64();
+    const uint64_t time_length =
+        sizeof(double) * static_cast<uint64_t>(entry.num_points);
+    const uint64_t datapoints_length = time_length * entry.num_datatypes;
+    for (auto [offset, length] :
+         {std::make_pair(entry.time_offset, time_length),
+          std::make_pair(entry.datapoints_offset, datapoints_length)}) {
+      if (offset % kAlignment != 0 || offset > size_ ||
+          length > size_ - offset) {
+        throw std::runtime_error("Invalid offset of trajectory " + name +
+                                 " in file: " + filepath);
+      }
+    }
+    trajectory_names_.push_back(name);
+    index_[name] = std::move(entry);
+  }
+}
+
+MappedLcmTrajectory::TrajectoryView MappedLcmTrajectory::GetTrajectory(
+    const string& trajectory_name) const {
+  auto it = index_.find(trajectory_name);
+  if (it == index_.end()) {
+    throw std::out_of_range("No trajectory named " + trajectory_name);
+  }
+  const Entry& entry = it->second;
+  const double* time =
+      reinterpret_cast<const double*>(data_ + entry.time_offset);
+  const double* datapoints =
+      reinterpret_cast<const double*>(data_ + entry.datapoints_offset);
+  return {it->first, Map<const VectorXd>(time, entry.num_points),
+          Map<const MatrixXd>(datapoints, entry.num_datatypes,
+                              entry.num_points),
+          entry.datatypes};
+}
+
+LcmTrajectory MappedLcmTrajectory::ToLcmTrajectory() const {
+  lcmt_saved_traj traj;
+  traj.metadata = metadata_;
+  traj.num_trajectories = trajectory_names_.size();
+  for (const string& name : trajectory_names_) {
+    TrajectoryView view = GetTrajectory(name);
+    lcmt_trajectory_block block;
+    block.trajectory_name = name;
+    block.num_points = view.time_vector.size();
+    block.num_datatypes = view.datatypes.size();
+    block.time_vec =
+        vector<double>(view.time_vector.data(),
+                       view.time_vector.data() + view.time_vector.size());
+    block.datapoints.resize(block.num_datatypes);
+    for (int i = 0; i < block.num_datatypes; i++) {
+      VectorXd row = view.datapoints.row(i);
+      block.datapoints[i] = vector<double>(row.data(), row.data() + row.size());
+    }
+    block.datatypes = view.datatypes;
+    traj.trajectories.push_back(block);
+    traj.trajectory_names.push_back(name);
+  }
+  return LcmTrajectory(traj);
+}
+
+void MappedLcmTrajectory::WriteToFile(const LcmTrajectory& traj,
+                                      const string& filepath) {
+  const auto& names = traj.GetTrajectoryNames();
+
+  // Offsets only depend on the (fixed) length of the header
+  vector<std::pair<uint64_t, uint64_t>> offsets(names.size(), {0, 0});
+  uint64_t offset = Align(SerializeHeader(traj, offsets).size());
+  for (size_t i = 0; i < names.size(); i++) {
+    const auto& block = traj.GetTrajectory(names[i]);
+    DRAKE_DEMAND(block.datapoints.cols() == block.time_vector.size());
+    DRAKE_DEMAND(block.datapoints.rows() ==
+                 static_cast<int>(block.datatypes.size()));
+    offsets[i].first = offset;
+    offset = Align(offset + sizeof(double) * block.time_vector.size());
+    offsets[i].second = offset;
+    offset = Align(offset + sizeof(double) * block.datapoints.size());
+  }
+  string header = SerializeHeader(traj, offsets);
+
+  std::ofstream fout(filepath, std::ios_base::binary);
+  if (!fout) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  const string padding(kAlignment, '\0');
+  fout.write(header.data(), header.size());
+  uint64_t position = header.size();
+  for (size_t i = 0; i < names.size(); i++) {
+    const auto& block = traj.GetTrajectory(names[i]);
+    fout.write(padding.data(), offsets[i].first - position);
+    fout.write(reinterpret_cast<const char*>(block.time_vector.data()),
+               sizeof(double) * block.time_vector.size());
+    position = offsets[i].first + sizeof(double) * block.time_vector.size();
+    // MatrixXd is column-major, so the datapoints are written as stored
+    fout.write(padding.data(), offsets[i].second - position);
+    fout.write(reinterpret_cast<const char*>(block.datapoints.data()),
+               sizeof(double) * block.datapoints.size());
+    position = offsets[i].second + sizeof(double) * block.datapoints.size();
+  }
+  fout.close();
+  if (!fout) {
+    throw std::runtime_error("Could not write file: " + filepath);
+  }
+}
+
+bool MappedLcmTrajectory::IsMappedFile(const string& filepath) {
+  std::ifstream fin(filepath, std::ios_base::binary);
+  char magic[sizeof(kMagic)];
+  if (!fin.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+}  // namespace dairlib
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "lcm/lcm_trajectory.h"
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Read-only, memory-mapped alternative to LcmTrajectory.
+///
+/// LcmTrajectory::LoadFromFile deserializes a whole lcmt_saved_traj and copies
+/// every block into its own matrix. A mapped trajectory file instead starts
+/// with a small header index (metadata, and the name, dimensions, datatypes
+/// and offsets of every trajectory), followed by the raw data of each
+/// trajectory as column-major doubles: the time vector, then the
+/// num_datatypes x num_points datapoints. The time vector and the datapoints
+/// each start on a 64 byte boundary, so that both can be read with aligned
+/// vector loads. Opening a file only parses the index; GetTrajectory returns Eigen::Map views into the mapping, so that
+/// only the pages of the blocks which are actually read are loaded, and
+/// processes mapping the same file share its memory.
+///
+/// Files round-trip with the LCM format:
+///   MappedLcmTrajectory::WriteToFile(LcmTrajectory(lcm_file), mapped_file);
+///   MappedLcmTrajectory(mapped_file).ToLcmTrajectory().WriteToFile(lcm_file);
+///
+/// The file is written in the byte order of the host, and is not meant to be
+/// moved between machines of different endianness.
+class MappedLcmTrajectory {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(MappedLcmTrajectory)
+
+  /// View of one trajectory, valid as long as the MappedLcmTrajectory
+  struct TrajectoryView {
+    const std::string& traj_name;
+    Eigen::Map<const Eigen::VectorXd> time_vector;
+    // Rows correspond to datatypes
+    // Cols correspond to different time indices
+    Eigen::Map<const Eigen::MatrixXd> datapoints;
+    const std::vector<std::string>& datatypes;
+
+    /// Copies the data into an LcmTrajectory::Trajectory
+    LcmTrajectory::Trajectory Copy() const;
+  };
+
+  /// Maps the file and parses its index
+  /// @throws std::runtime_error if the file cannot be opened or is not a
+  /// valid mapped trajectory file
+  explicit MappedLcmTrajectory(const std::string& filepath);
+
+  ~MappedLcmTrajectory();
+
+  /// Writes traj, with its metadata and trajectory order, as a mapped file
+  /// @throws std::runtime_error if unable to write the file
+  static void WriteToFile(const LcmTrajectory& traj,
+                          const std::string& filepath);
+
+  /// Returns true if the file starts with the mapped trajectory file marker
+  static bool IsMappedFile(const std::string& filepath);
+
+  const lcmt_metadata& GetMetadata() const { return metadata_; }
+
+  const std::vector<std::string>& GetTrajectoryNames() const {
+    return trajectory_names_;
+  }
+
+  bool HasTrajectory(const std::string& trajectory_name) const {
+    return index_.count(trajectory_name) > 0;
+  }
+
+  /// @throws std::out_of_range if there is no such trajectory
+  TrajectoryView GetTrajectory(const std::string& trajectory_name) const;
+
+  /// Copies every trajectory, and the metadata, into an LcmTrajectory
+  LcmTrajectory ToLcmTrajectory() const;
+
+ private:
+  struct Entry {
+    int num_points;
+    int num_datatypes;
+    std::vector<std::string> datatypes;
+    /// Byte offsets of the time vector and of the datapoints
+    uint64_t time_offset;
+    uint64_t datapoints_offset;
+  };
+
+  void ParseIndex(const std::string& filepath);
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  lcmt_metadata metadata_;
+  std::vector<std::string> trajectory_names_;
+  std::unordered_map<std::string, Entry> index_;
+};
+
+}  // namespace dairlib
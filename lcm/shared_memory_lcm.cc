@@ -0,0 +1,363 @@
+#include "lcm/shared_memory_lcm.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "drake/common/drake_throw.h"
+
+namespace dairlib {
+
+using drake::lcm::DrakeSubscriptionInterface;
+
+namespace {
+
+constexpr size_t kCacheLine = 64;
+
+/// Header of the segment of a channel, followed by its slots. A segment
+/// filled with zeros is an empty ring, so that creating it only requires
+/// sizing it.
+struct RingHeader {
+  // num_slots << 32 | slot_size, set by the first process mapping the ring
+  std::atomic<uint64_t> geometry;
+  alignas(kCacheLine) std::atomic<uint64_t> write_index;
+};
+
+/// Header of a slot, followed by slot_size bytes. The sequence of the slot of
+/// message i is 2 i + 1 while it is written and 2 i + 2 once written.
+struct SlotHeader {
+  std::atomic<uint64_t> sequence;
+  int32_t size;
+};
+
+const uint8_t* SlotData(const SlotHeader* slot) {
+  return reinterpret_cast<const uint8_t*>(slot) + sizeof(SlotHeader);
+}
+
+uint8_t* SlotData(SlotHeader* slot) {
+  return reinterpret_cast<uint8_t*>(slot) + sizeof(SlotHeader);
+}
+
+size_t RoundUp(size_t size) {
+  return (size + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+std::string SegmentPath(const std::string& name, const std::string& channel) {
+  std::string path = "/" + name + "_" + channel;
+  for (size_t i = 1; i < path.size(); i++) {
+    const unsigned char c = path[i];
+    if (!std::isalnum(c) && c != '_' && c != '-' && c != '.') {
+      path[i] = '_';
+    }
+  }
+  return path;
+}
+
+/// Maps the shared memory segment at path, creating it filled with zeros if
+/// it does not exist
+void* MapSegment(const std::string& path, size_t size) {
+  int fd = shm_open(path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open shared memory " + path + ": " +
+                             std::strerror(errno));
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      (status.st_size == 0 && ftruncate(fd, size) != 0)) {
+    int error = errno;
+    close(fd);
+    throw std::runtime_error("Could not size shared memory " + path + ": " +
+                             std::strerror(error));
+  }
+  if (status.st_size != 0 && static_cast<size_t>(status.st_size) != size) {
+    close(fd);
+    throw std::runtime_error("Shared memory " + path +
+                             " exists with another size");
+  }
+  void* memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error("Could not map shared memory " + path + ": " +
+                             std::strerror(errno));
+  }
+  return memory;
+}
+
+long Futex(std::atomic<uint32_t>* address, int operation, uint32_t value,
+           const timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), operation,
+                 value, timeout, nullptr, 0);
+}
+
+}  // namespace
+
+/// Shared by all channels of a name. Publishers increment sequence, and wake
+/// the processes waiting on it, if any.
+struct SharedMemoryLcm::Doorbell {
+  std::atomic<uint32_t> sequence;
+  std::atomic<uint32_t> num_waiters;
+};
+
+class SharedMemoryLcm::Subscription final : public DrakeSubscriptionInterface {
+ public:
+  Subscription(SharedMemoryLcm* owner, HandlerFunction handler)
+      : owner_(owner), handler_(std::move(handler)) {}
+
+  // Neither is marked override, as for get_lcm_url()
+  void set_unsubscribe_on_delete(bool enabled) {
+    if (enabled && owner_ != nullptr) {
+      owner_->Release(this);
+    }
+  }
+
+  void set_queue_capacity(int capacity) {
+    DRAKE_THROW_UNLESS(capacity >= 1);
+    queue_capacity_ = capacity;
+  }
+
+  int queue_capacity() const { return queue_capacity_; }
+
+  void Handle(const void* data, int size) const { handler_(data, size); }
+
+  void Detach() { owner_ = nullptr; }
+
+ private:
+  SharedMemoryLcm* owner_;
+  HandlerFunction handler_;
+  int queue_capacity_ = std::numeric_limits<int>::max();
+};
+
+/// The mapped ring of a channel, and the position of this process in it
+class SharedMemoryLcm::Channel {
+ public:
+  Channel(const std::string& path, const Options& options)
+      : num_slots_(options.num_slots),
+        slot_size_(options.slot_size),
+        slot_stride_(RoundUp(sizeof(SlotHeader) + options.slot_size)),
+        size_(RoundUp(sizeof(RingHeader)) + num_slots_ * slot_stride_),
+        buffer_(options.slot_size) {
+    header_ = static_cast<RingHeader*>(MapSegment(path, size_));
+    const uint64_t geometry =
+        (static_cast<uint64_t>(num_slots_) << 32) | slot_size_;
+    uint64_t expected = 0;
+    if (!header_->geometry.compare_exchange_strong(expected, geometry) &&
+        expected != geometry) {
+      munmap(header_, size_);
+      throw std::runtime_error("Shared memory " + path +
+                               " exists with another geometry");
+    }
+    next_index_ = header_->write_index.load(std::memory_order_acquire);
+  }
+
+  ~Channel() { munmap(header_, size_); }
+
+  void Publish(const void* data, int size) {
+    if (size > slot_size_) {
+      throw std::runtime_error(
+          "Message of " + std::to_string(size) +
+          " bytes does not fit in a shared memory slot of " +
+          std::to_string(slot_size_) + " bytes");
+    }
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    const uint64_t index =
+        header_->write_index.load(std::memory_order_relaxed);
+    SlotHeader* slot = GetSlot(index);
+    slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->size = size;
+    std::memcpy(SlotData(slot), data, size);
+    slot->sequence.store(2 * index + 2, std::memory_order_release);
+    header_->write_index.store(index + 1, std::memory_order_release);
+  }
+
+  /// Reads the messages published since the last call, and passes each to
+  /// the subscriptions whose queue capacity it is within. Returns the number
+  /// of messages read.
+  int Dispatch(int64_t* num_dropped) {
+    const uint64_t end = header_->write_index.load(std::memory_order_acquire);
+    if (end - next_index_ > static_cast<uint64_t>(num_slots_)) {
+      *num_dropped += end - next_index_ - num_slots_;
+      next_index_ = end - num_slots_;
+    }
+    int count = 0;
+    for (; next_index_ < end; next_index_++) {
+      const SlotHeader* slot = GetSlot(next_index_);
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const int size = slot->size;
+      if (sequence != 2 * next_index_ + 2 || size < 0 || size > slot_size_) {
+        (*num_dropped)++;
+        continue;
+      }
+      std::memcpy(buffer_.data(), SlotData(slot), size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+        (*num_dropped)++;
+        continue;
+      }
+      count++;
+      // Handlers may subscribe, so the vector can grow meanwhile
+      for (size_t i = 0; i < subscriptions_.size(); i++) {
+        auto subscription = subscriptions_[i].lock();
+        if (subscription != nullptr &&
+            end - next_index_ <=
+                static_cast<uint64_t>(subscription->queue_capacity())) {
+          subscription->Handle(buffer_.data(), size);
+        }
+      }
+    }
+    subscriptions_.erase(
+        std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                       [](const std::weak_ptr<Subscription>& subscription) {
+                         return subscription.expired();
+                       }),
+        subscriptions_.end());
+    return count;
+  }
+
+  void AddSubscription(std::weak_ptr<Subscription> subscription) {
+    if (subscriptions_.empty()) {
+      // Start from the messages published from now on
+      next_index_ = header_->write_index.load(std::memory_order_acquire);
+    }
+    subscriptions_.push_back(std::move(subscription));
+  }
+
+  bool has_subscriptions() const { return !subscriptions_.empty(); }
+
+ private:
+  SlotHeader* GetSlot(uint64_t index) const {
+    return reinterpret_cast<SlotHeader*>(
+        reinterpret_cast<char*>(header_) + RoundUp(sizeof(RingHeader)) +
+        (index % num_slots_) * slot_stride_);
+  }
+
+  const int num_slots_;
+  const int slot_size_;
+  const size_t slot_stride_;
+  const size_t size_;
+  RingHeader* header_;
+  std::mutex publish_mutex_;
+  uint64_t next_index_;
+  std::vector<uint8_t> buffer_;
+  std::vector<std::weak_ptr<Subscription>> subscriptions_;
+};
+
+SharedMemoryLcm::SharedMemoryLcm(const std::string& name)
+    : SharedMemoryLcm(name, Options()) {}
+
+SharedMemoryLcm::SharedMemoryLcm(const std::string& name,
+                                 const Options& options)
+    : name_(name), options_(options) {
+  DRAKE_THROW_UNLESS(options.num_slots > 0);
+  DRAKE_THROW_UNLESS(options.slot_size > 0);
+  doorbell_ = static_cast<Doorbell*>(
+      MapSegment(SegmentPath(name, ""), sizeof(Doorbell)));
+}
+
+SharedMemoryLcm::~SharedMemoryLcm() {
+  for (const auto& subscription : owned_subscriptions_) {
+    subscription->Detach();
+  }
+  munmap(doorbell_, sizeof(Doorbell));
+}
+
+std::string SharedMemoryLcm::get_lcm_url() const { return "shm://" + name_; }
+
+SharedMemoryLcm::Channel& SharedMemoryLcm::GetChannel(
+    const std::string& channel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = channels_.find(channel);
+  if (it == channels_.end()) {
+    it = channels_
+             .emplace(channel, std::make_unique<Channel>(
+                                   SegmentPath(name_, channel), options_))
+             .first;
+  }
+  return *it->second;
+}
+
+void SharedMemoryLcm::Publish(const std::string& channel, const void* data,
+                              int data_size, std::optional<double>) {
+  DRAKE_THROW_UNLESS(data_size >= 0);
+  GetChannel(channel).Publish(data, data_size);
+  doorbell_->sequence.fetch_add(1);
+  if (doorbell_->num_waiters.load() > 0) {
+    Futex(&doorbell_->sequence, FUTEX_WAKE, INT_MAX, nullptr);
+  }
+}
+
+std::shared_ptr<DrakeSubscriptionInterface> SharedMemoryLcm::Subscribe(
+    const std::string& channel, HandlerFunction handler) {
+  DRAKE_THROW_UNLESS(handler != nullptr);
+  Channel& ring = GetChannel(channel);
+  if (std::find(subscribed_channels_.begin(), subscribed_channels_.end(),
+                &ring) == subscribed_channels_.end()) {
+    subscribed_channels_.push_back(&ring);
+  }
+  auto subscription = std::make_shared<Subscription>(this, std::move(handler));
+  ring.AddSubscription(subscription);
+  owned_subscriptions_.push_back(subscription);
+  return subscription;
+}
+
+void SharedMemoryLcm::Release(const Subscription* subscription) {
+  owned_subscriptions_.erase(
+      std::remove_if(owned_subscriptions_.begin(), owned_subscriptions_.end(),
+                     [subscription](const std::shared_ptr<Subscription>& s) {
+                       return s.get() == subscription;
+                     }),
+      owned_subscriptions_.end());
+}
+
+int SharedMemoryLcm::DispatchPending() {
+  int count = 0;
+  // Handlers may subscribe to new channels meanwhile
+  for (size_t i = 0; i < subscribed_channels_.size(); i++) {
+    count += subscribed_channels_[i]->Dispatch(&num_dropped_);
+  }
+  return count;
+}
+
+int SharedMemoryLcm::HandleSubscriptions(int timeout_millis) {
+  DRAKE_THROW_UNLESS(timeout_millis >= 0);
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_millis);
+  while (true) {
+    // Read the doorbell before the rings, so that a message published after
+    // reading them changes it and the wait returns immediately
+    const uint32_t sequence = doorbell_->sequence.load();
+    const int count = DispatchPending();
+    const auto remaining = deadline - std::chrono::steady_clock::now();
+    if (count > 0 || remaining <= std::chrono::nanoseconds(0)) {
+      return count;
+    }
+    const auto nanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(remaining)
+            .count();
+    const timespec timeout = {static_cast<time_t>(nanoseconds / 1000000000),
+                              static_cast<long>(nanoseconds % 1000000000)};
+    doorbell_->num_waiters.fetch_add(1);
+    Futex(&doorbell_->sequence, FUTEX_WAIT, sequence, &timeout);
+    doorbell_->num_waiters.fetch_sub(1);
+  }
+}
+
+void SharedMemoryLcm::Unlink(const std::string& name,
+                             const std::string& channel) {
+  shm_unlink(SegmentPath(name, channel).c_str());
+}
+
+}  // namespace dairlib
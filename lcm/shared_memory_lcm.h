@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/lcm/drake_lcm_interface.h"
+
+namespace dairlib {
+
+/// SharedMemoryLcm is a DrakeLcmInterface that exchanges messages between
+/// processes of the same machine through shared memory, instead of UDP
+/// multicast. It can thus replace DrakeLcm for LcmPublisherSystem,
+/// LcmSubscriberSystem, drake::lcm::Subscriber and LcmDrivenLoop, as long as
+/// all processes exchanging a channel use it with the same name.
+///
+/// Every channel is a ring of fixed-size slots in a POSIX shared memory
+/// segment, /dev/shm/<name>_<channel>, created by the first process that
+/// publishes or subscribes to it. Slots are seqlocks: the publisher marks the
+/// slot as being written, copies the encoded message into it and marks it
+/// written, and readers copy the message out and check that the slot did not
+/// change meanwhile. Readers thus never block the publisher, and a message is
+/// copied twice, without any system call, instead of going through the
+/// kernel. Publishers ring a futex doorbell shared by all channels of name,
+/// on which HandleSubscriptions() sleeps when no message is pending.
+///
+/// As with LCM, subscribers receive the messages published after they
+/// subscribed, in order, including their own, and a message that a reader
+/// did not copy before its slot was reused is dropped (see num_dropped()).
+/// Unlike LCM, each channel must have a single publishing process, and its
+/// messages must fit in a slot. Messages are not seen by lcm-logger or by
+/// other machines.
+///
+/// Publish() may be called from any thread, while Subscribe() and
+/// HandleSubscriptions() must be called from a single thread.
+class SharedMemoryLcm : public drake::lcm::DrakeLcmInterface {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SharedMemoryLcm)
+
+  /// Geometry of the rings, which must be the same in every process
+  struct Options {
+    /// Number of messages of a channel that readers can fall behind by
+    int num_slots = 64;
+    /// Maximum size of an encoded message, in bytes
+    int slot_size = 16384;
+  };
+
+  /// @param name Prefix of the shared memory segments. Processes exchange
+  ///   messages only with processes using the same name.
+  /// @throws std::runtime_error if the shared memory cannot be mapped
+  explicit SharedMemoryLcm(const std::string& name = "dairlib_lcm");
+  SharedMemoryLcm(const std::string& name, const Options& options);
+
+  ~SharedMemoryLcm() override;
+
+  /// Returns shm://<name>. Not marked override, since only recent versions of
+  /// DrakeLcmInterface declare it.
+  std::string get_lcm_url() const;
+
+  /// @throws std::runtime_error if the message does not fit in a slot, or if
+  ///   the ring of channel exists with another geometry
+  void Publish(const std::string& channel, const void* data, int data_size,
+               std::optional<double> time_sec) override;
+
+  std::shared_ptr<drake::lcm::DrakeSubscriptionInterface> Subscribe(
+      const std::string& channel, HandlerFunction handler) override;
+
+  /// Handles the pending messages of all subscribed channels, waiting at most
+  /// timeout_millis for one if none is pending. Returns the number of
+  /// messages handled.
+  int HandleSubscriptions(int timeout_millis) override;
+
+  /// Number of messages that readers of this instance missed because their
+  /// slot was reused before being read
+  int64_t num_dropped() const { return num_dropped_; }
+
+  /// Removes the shared memory segment of channel, and of the doorbell if
+  /// channel is empty. Processes that mapped them keep their mapping.
+  static void Unlink(const std::string& name, const std::string& channel);
+
+ private:
+  class Channel;
+  class Subscription;
+  struct Doorbell;
+
+  Channel& GetChannel(const std::string& channel);
+  int DispatchPending();
+  void Release(const Subscription* subscription);
+
+  const std::string name_;
+  const Options options_;
+  Doorbell* doorbell_;
+  std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Channel>> channels_;
+  std::vector<Channel*> subscribed_channels_;
+  // Subscriptions that live as long as this object, unless they were set to
+  // unsubscribe on delete
+  std::vector<std::shared_ptr<Subscription>> owned_subscriptions_;
+  int64_t num_dropped_ = 0;
+};
+
+}  // namespace dairlib
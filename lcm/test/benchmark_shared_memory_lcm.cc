@@ -0,0 +1,144 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "dairlib/lcmt_robot_output.hpp"
+#include "lcm/shared_memory_lcm.h"
+#include "systems/framework/realtime.h"
+
+#include "drake/lcm/drake_lcm.h"
+
+DEFINE_int32(messages, 10000, "Number of messages to publish per transport");
+DEFINE_double(rate, 2000, "Publishing rate (Hz), 0 publishing back to back");
+DEFINE_bool(spin, false, "Whether the subscriber spins instead of sleeping");
+DEFINE_string(lcm_url, "udpm://239.255.76.67:7667?ttl=0",
+              "LCM URL of the UDP multicast transport");
+DEFINE_string(channel, "BENCHMARK_ROBOT_OUTPUT", "Channel to publish on");
+
+namespace dairlib {
+namespace {
+
+using drake::lcm::DrakeLcmInterface;
+using systems::LatencyHistogram;
+
+typedef std::chrono::steady_clock my_clock;
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             my_clock::now().time_since_epoch())
+      .count();
+}
+
+/// A message of the size of the Cassie state, with the publish time as utime
+lcmt_robot_output MakeMessage() {
+  lcmt_robot_output msg;
+  msg.num_positions = 23;
+  msg.num_velocities = 22;
+  msg.num_efforts = 10;
+  for (int i = 0; i < msg.num_positions; i++) {
+    msg.position_names.push_back("position_" + std::to_string(i));
+    msg.position.push_back(i);
+  }
+  for (int i = 0; i < msg.num_velocities; i++) {
+    msg.velocity_names.push_back("velocity_" + std::to_string(i));
+    msg.velocity.push_back(i);
+  }
+  for (int i = 0; i < msg.num_efforts; i++) {
+    msg.effort_names.push_back("effort_" + std::to_string(i));
+    msg.effort.push_back(i);
+  }
+  msg.imu_accel[0] = msg.imu_accel[1] = 0;
+  msg.imu_accel[2] = 9.81;
+  return msg;
+}
+
+/// Publishes the messages from a child process, and receives them in this
+/// one, recording the latency from encoding to decoding each message
+void Run(const std::string& name,
+         const std::function<std::unique_ptr<DrakeLcmInterface>()>& make_lcm) {
+  auto subscriber = make_lcm();
+  LatencyHistogram latency(1e-7, 100000);
+  int received = 0;
+  my_clock::time_point first_receive;
+  my_clock::time_point last_receive;
+  lcmt_robot_output msg;
+  auto subscription = subscriber->Subscribe(
+      FLAGS_channel, [&](const void* data, int size) {
+        msg.decode(data, 0, size);
+        last_receive = my_clock::now();
+        latency.Add(1e-9 * (Now() - msg.utime));
+        if (received++ == 0) {
+          first_receive = last_receive;
+        }
+      });
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    auto publisher = make_lcm();
+    lcmt_robot_output message = MakeMessage();
+    std::vector<uint8_t> bytes(message.getEncodedSize());
+    // Let the subscriber wait for the first message
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto next = my_clock::now();
+    const auto period = std::chrono::duration_cast<my_clock::duration>(
+        std::chrono::duration<double>(FLAGS_rate > 0 ? 1 / FLAGS_rate : 0));
+    for (int i = 0; i < FLAGS_messages; i++) {
+      next += period;
+      std::this_thread::sleep_until(next);
+      message.utime = Now();
+      message.encode(bytes.data(), 0, bytes.size());
+      publisher->Publish(FLAGS_channel, bytes.data(), bytes.size(), {});
+    }
+    _exit(0);
+  }
+
+  // Gives up after a second without messages, so that a dropped message does
+  // not stall the benchmark, whether it spins or sleeps
+  const auto timeout = std::chrono::seconds(1);
+  auto deadline = my_clock::now() + timeout;
+  while (received < FLAGS_messages && my_clock::now() < deadline) {
+    if (subscriber->HandleSubscriptions(FLAGS_spin ? 0 : 100) > 0) {
+      deadline = my_clock::now() + timeout;
+    }
+  }
+  waitpid(pid, nullptr, 0);
+
+  std::cout << name << ": " << received << " of " << FLAGS_messages
+            << " messages received in "
+            << std::chrono::duration<double>(last_receive - first_receive)
+                   .count()
+            << " s" << std::endl;
+  latency.PrintSummary("  latency", std::cout);
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  std::cout << "lcmt_robot_output: " << MakeMessage().getEncodedSize()
+            << " bytes, " << FLAGS_rate << " Hz" << std::endl;
+
+  Run("UDP multicast", []() {
+    return std::make_unique<drake::lcm::DrakeLcm>(FLAGS_lcm_url);
+  });
+
+  const std::string name = "dairlib_lcm_benchmark";
+  Run("shared memory", [&name]() {
+    return std::make_unique<SharedMemoryLcm>(name);
+  });
+  SharedMemoryLcm::Unlink(name, FLAGS_channel);
+  SharedMemoryLcm::Unlink(name, "");
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "lcm/lcm_trajectory.h"
+
+DEFINE_string(files, "",
+              "Comma-separated list of saved trajectories (e.g. Cassie and "
+              "Spirit DirconTrajectory files) to benchmark");
+DEFINE_string(tolerances, "0,1e-9,1e-6,1e-3",
+              "Comma-separated list of compact encoding tolerances, 0 being "
+              "lossless");
+DEFINE_int32(reps, 10, "Number of loads to time per file and encoding");
+DEFINE_string(scratch_file, "/tmp/benchmark_trajectory_encoding",
+              "File written to and loaded from during the benchmark");
+
+namespace dairlib {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+size_t FileSize(const std::string& filepath) {
+  std::ifstream file(filepath, std::ios_base::binary | std::ios_base::ate);
+  return file.tellg();
+}
+
+/// Loads the scratch file reps times, and returns the average load time
+double TimeLoad(int reps) {
+  double total = 0;
+  for (int i = 0; i < reps; i++) {
+    auto start = my_clock::now();
+    LcmTrajectory traj(FLAGS_scratch_file);
+    auto stop = my_clock::now();
+    total += std::chrono::duration<double>(stop - start).count();
+  }
+  return total / reps;
+}
+
+/// Largest absolute difference between the datapoints of the two
+double MaxError(const LcmTrajectory& a, const LcmTrajectory& b) {
+  double error = 0;
+  for (const auto& name : a.GetTrajectoryNames()) {
+    const auto& datapoints = a.GetTrajectory(name).datapoints;
+    if (datapoints.size() > 0) {
+      error = std::max(error, (datapoints - b.GetTrajectory(name).datapoints)
+                                  .lpNorm<Eigen::Infinity>());
+    }
+  }
+  return error;
+}
+
+void BenchmarkFile(const std::string& filepath) {
+  LcmTrajectory traj(filepath);
+  size_t num_doubles = 0;
+  for (const auto& name : traj.GetTrajectoryNames()) {
+    const auto& block = traj.GetTrajectory(name);
+    num_doubles += block.time_vector.size() + block.datapoints.size();
+  }
+  const double megabytes = 8e-6 * num_doubles;
+
+  traj.WriteToFile(FLAGS_scratch_file);
+  size_t lcm_size = FileSize(FLAGS_scratch_file);
+  double lcm_time = TimeLoad(FLAGS_reps);
+  std::cout << filepath << ": " << traj.GetTrajectoryNames().size()
+            << " trajectories, " << num_doubles << " doubles" << std::endl;
+  std::cout << "  lcm:              " << lcm_size << " bytes, loaded in "
+            << 1000 * lcm_time << " ms (" << megabytes / lcm_time << " MB/s)"
+            << std::endl;
+
+  for (const auto& tolerance_string : Split(FLAGS_tolerances)) {
+    CompactEncodingOptions options;
+    options.tolerance = std::stod(tolerance_string);
+    auto start = my_clock::now();
+    traj.WriteToFile(FLAGS_scratch_file, options);
+    auto stop = my_clock::now();
+    double encode_time = std::chrono::duration<double>(stop - start).count();
+    size_t size = FileSize(FLAGS_scratch_file);
+    double decode_time = TimeLoad(FLAGS_reps);
+    double error = MaxError(traj, LcmTrajectory(FLAGS_scratch_file));
+    std::printf(
+        "  compact %-8s  %zu bytes (%.2fx smaller than lcm), encoded in %.3g "
+        "ms, loaded in %.3g ms (%.1f MB/s), max error %.3g\n",
+        tolerance_string.c_str(), size,
+        static_cast<double>(lcm_size) / size, 1000 * encode_time,
+        1000 * decode_time, megabytes / decode_time, error);
+  }
+  std::remove(FLAGS_scratch_file.c_str());
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  auto files = dairlib::Split(FLAGS_files);
+  if (files.empty()) {
+    std::cerr << "Pass the trajectories to benchmark with --files"
+              << std::endl;
+    return 1;
+  }
+  for (const auto& file : files) {
+    dairlib::BenchmarkFile(file);
+  }
+  return 0;
+}
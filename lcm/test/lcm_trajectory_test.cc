@@ -1,6 +1,8 @@
 #include "lcm/lcm_trajectory.h"
+#include "lcm/mapped_trajectory.h"
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -28,6 +30,8 @@ using std::unordered_map;
 using std::vector;
 
 static const char TEST_FILEPATH[] = "TEST_FILEPATH";
+static const char TEST_MAPPED_FILEPATH[] = "TEST_MAPPED_FILEPATH";
+static const char TEST_COMPACT_FILEPATH[] = "TEST_COMPACT_FILEPATH";
 static const char TEST_TRAJ_NAME_1[] = "TEST_TRAJ_NAME_1";
 static const char TEST_TRAJ_NAME_2[] = "TEST_TRAJ_NAME_2";
 static const char TEST_NAME[] = "TEST_NAME";
@@ -114,6 +118,65 @@ TEST_F(LcmTrajectoryTest, TestConstructorFromLcmTObject) {
               lcm_traj_.GetTrajectory(TEST_TRAJ_NAME_2).datatypes);
 }
 
+TEST_F(LcmTrajectoryTest, TestMappedRoundTrip) {
+  lcm_traj_.WriteToFile(TEST_FILEPATH);
+  EXPECT_FALSE(MappedLcmTrajectory::IsMappedFile(TEST_FILEPATH));
+  MappedLcmTrajectory::WriteToFile(lcm_traj_, TEST_MAPPED_FILEPATH);
+  EXPECT_TRUE(MappedLcmTrajectory::IsMappedFile(TEST_MAPPED_FILEPATH));
+
+  MappedLcmTrajectory mapped_traj(TEST_MAPPED_FILEPATH);
+  EXPECT_EQ(mapped_traj.GetTrajectoryNames(), trajectory_names_);
+  EXPECT_EQ(mapped_traj.GetMetadata().name, TEST_NAME);
+  EXPECT_EQ(mapped_traj.GetMetadata().description, TEST_DESCRIPTION);
+  EXPECT_EQ(mapped_traj.GetMetadata().datetime,
+            lcm_traj_.GetMetadata().datetime);
+  for (const auto& traj_name : trajectory_names_) {
+    auto view = mapped_traj.GetTrajectory(traj_name);
+    const auto& traj = lcm_traj_.GetTrajectory(traj_name);
+    EXPECT_EQ(view.traj_name, traj_name);
+    EXPECT_TRUE(view.time_vector == traj.time_vector);
+    EXPECT_TRUE(view.datapoints == traj.datapoints);
+    EXPECT_TRUE(view.datatypes == traj.datatypes);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.time_vector.data()) % 64, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.datapoints.data()) % 64, 0);
+  }
+  EXPECT_FALSE(mapped_traj.HasTrajectory("NOT_A_TRAJECTORY"));
+
+  // Back to the LCM format
+  mapped_traj.ToLcmTrajectory().WriteToFile(TEST_FILEPATH);
+  LcmTrajectory loaded_traj(TEST_FILEPATH);
+  EXPECT_EQ(loaded_traj.GetMetadata().datetime,
+            lcm_traj_.GetMetadata().datetime);
+  for (const auto& traj_name : trajectory_names_) {
+    EXPECT_TRUE(loaded_traj.GetTrajectory(traj_name).datapoints ==
+                lcm_traj_.GetTrajectory(traj_name).datapoints);
+  }
+}
+
+TEST_F(LcmTrajectoryTest, TestCompactEncoding) {
+  for (double tolerance : {0.0, 1e-3}) {
+    CompactEncodingOptions options;
+    options.tolerance = tolerance;
+    lcm_traj_.WriteToFile(TEST_COMPACT_FILEPATH, options);
+    LcmTrajectory loaded_traj(TEST_COMPACT_FILEPATH);
+
+    EXPECT_EQ(loaded_traj.GetTrajectoryNames().size(), NUM_TRAJECTORIES);
+    EXPECT_EQ(loaded_traj.GetMetadata().datetime,
+              lcm_traj_.GetMetadata().datetime);
+    EXPECT_EQ(loaded_traj.GetMetadata().name, TEST_NAME);
+    EXPECT_EQ(loaded_traj.GetMetadata().description, TEST_DESCRIPTION);
+    for (const auto& traj_name : trajectory_names_) {
+      const auto& loaded = loaded_traj.GetTrajectory(traj_name);
+      const auto& traj = lcm_traj_.GetTrajectory(traj_name);
+      // Time vectors are always lossless
+      EXPECT_TRUE(loaded.time_vector == traj.time_vector);
+      EXPECT_LE((loaded.datapoints - traj.datapoints).lpNorm<Eigen::Infinity>(),
+                tolerance);
+      EXPECT_TRUE(loaded.datatypes == traj.datatypes);
+    }
+  }
+}
+
 }  // namespace dairlib
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include <gtest/gtest.h>
+#include <lcm/lcm.h>
+
+namespace dairlib {
+namespace {
+
+using std::string;
+using std::vector;
+
+/// The binary under test, a data dependency of the test
+const char kRectifier[] = "lcm/log_sequence_rectifier";
+
+string TempDirectory() {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? directory : ".";
+}
+
+struct Event {
+  int64_t timestamp;
+  string channel;
+  string data;
+};
+
+void WriteLog(const string& filepath, const vector<Event>& events) {
+  lcm_eventlog_t* log = lcm_eventlog_create(filepath.c_str(), "w");
+  ASSERT_NE(log, nullptr);
+  for (const auto& e : events) {
+    lcm_eventlog_event_t event{};
+    event.timestamp = e.timestamp;
+    event.channel = const_cast<char*>(e.channel.c_str());
+    event.channellen = e.channel.size();
+    event.data = const_cast<char*>(e.data.data());
+    event.datalen = e.data.size();
+    ASSERT_EQ(lcm_eventlog_write_event(log, &event), 0);
+  }
+  lcm_eventlog_destroy(log);
+}
+
+/// Reads every event, checking that they are numbered in order
+vector<Event> ReadLog(const string& filepath) {
+  vector<Event> events;
+  lcm_eventlog_t* log = lcm_eventlog_create(filepath.c_str(), "r");
+  EXPECT_NE(log, nullptr);
+  if (!log) {
+    return events;
+  }
+  while (lcm_eventlog_event_t* event = lcm_eventlog_read_next_event(log)) {
+    EXPECT_EQ(event->eventnum, static_cast<int64_t>(events.size()));
+    events.push_back({event->timestamp, event->channel,
+                      string(static_cast<const char*>(event->data),
+                             event->datalen)});
+    lcm_eventlog_free_event(event);
+  }
+  lcm_eventlog_destroy(log);
+  return events;
+}
+
+/// Events 1 ms apart, alternating between two channels, whose data is their
+/// index padded to data_size bytes. Every fifth event is logged up to
+/// max_lateness microseconds late, and every seventh has the timestamp of
+/// the one before it.
+vector<Event> MakeEvents(int num_events, int64_t max_lateness,
+                         int data_size) {
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<int64_t> lateness(1, max_lateness);
+  vector<Event> events;
+  for (int i = 0; i < num_events; i++) {
+    Event event;
+    event.timestamp = 1000000 + 1000 * i;
+    if (i % 5 == 0) {
+      event.timestamp -= lateness(generator);
+    } else if (i % 7 == 0) {
+      event.timestamp = events.back().timestamp;
+    }
+    event.channel = (i % 2) ? "A" : "B";
+    event.data = std::to_string(i);
+    event.data.resize(std::max<int>(data_size, event.data.size()), ' ');
+    events.push_back(event);
+  }
+  return events;
+}
+
+/// Runs the rectifier on events, checks that its output holds the same
+/// events sorted by timestamp, with equal timestamps in their original order,
+/// and returns what it printed
+string ExpectRectified(const vector<Event>& events, const string& flags) {
+  const string log_in = TempDirectory() + "/rectifier_in.lcmlog";
+  const string log_out = TempDirectory() + "/rectifier_out.lcmlog";
+  const string output = TempDirectory() + "/rectifier_output.txt";
+  WriteLog(log_in, events);
+  const string command = string(kRectifier) + " " + flags + " " + log_in +
+                         " " + log_out + " > " + output;
+  EXPECT_EQ(std::system(command.c_str()), 0) << command;
+
+  vector<Event> expected = events;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Event& lhs, const Event& rhs) {
+                     return lhs.timestamp < rhs.timestamp;
+                   });
+  const vector<Event> rectified = ReadLog(log_out);
+  EXPECT_EQ(rectified.size(), expected.size());
+  for (size_t i = 0; i < std::min(rectified.size(), expected.size()); i++) {
+    EXPECT_EQ(rectified[i].timestamp, expected[i].timestamp) << i;
+    EXPECT_EQ(rectified[i].channel, expected[i].channel) << i;
+    EXPECT_EQ(rectified[i].data, expected[i].data) << i;
+  }
+
+  std::ifstream file(output);
+  std::stringstream printed;
+  printed << file.rdbuf();
+  return printed.str();
+}
+
+const char kFallback[] = "Falling back to an external sort.";
+
+GTEST_TEST(LogSequenceRectifierTest, StreamsWithinWindow) {
+  const string printed =
+      ExpectRectified(MakeEvents(2000, 20000, 8), "--window=0.05");
+  EXPECT_EQ(printed.find(kFallback), string::npos) << printed;
+  EXPECT_NE(printed.find("Streamed"), string::npos) << printed;
+}
+
+GTEST_TEST(LogSequenceRectifierTest, SortsEventsLaterThanWindow) {
+  vector<Event> events = MakeEvents(2000, 20000, 8);
+  // Far later than the window
+  events[1500].timestamp = events[100].timestamp;
+  const string printed = ExpectRectified(events, "--window=0.05");
+  EXPECT_NE(printed.find(kFallback), string::npos) << printed;
+}
+
+GTEST_TEST(LogSequenceRectifierTest, SortsLogLargerThanMemory) {
+  // About 4 MB, which does not fit in the window nor in --max_memory_mb, so
+  // that the external sort merges several runs
+  const string printed = ExpectRectified(
+      MakeEvents(1000, 20000, 4000),
+      "--window=1000 --max_memory_mb=1 --tmp_dir=" + TempDirectory());
+  EXPECT_NE(printed.find(kFallback), string::npos) << printed;
+
+  // The runs are removed
+  DIR* directory = opendir(TempDirectory().c_str());
+  ASSERT_NE(directory, nullptr);
+  while (dirent* entry = readdir(directory)) {
+    EXPECT_EQ(string(entry->d_name).find("log_sequence_rectifier_run_"),
+              string::npos);
+  }
+  closedir(directory);
+}
+
+}  // namespace
+}  // namespace dairlib
@@ -0,0 +1,124 @@
+#include "lcm/shared_memory_lcm.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+
+using std::string;
+using std::vector;
+
+static const char TEST_CHANNEL[] = "TEST_CHANNEL";
+
+class SharedMemoryLcmTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Unique to this process, so that concurrent tests do not interfere
+    name_ = "dairlib_lcm_test_" + std::to_string(getpid());
+  }
+
+  void TearDown() override {
+    SharedMemoryLcm::Unlink(name_, TEST_CHANNEL);
+    SharedMemoryLcm::Unlink(name_, "");
+  }
+
+  static void Publish(SharedMemoryLcm* lcm, int value) {
+    lcm->Publish(TEST_CHANNEL, &value, sizeof(value), {});
+  }
+
+  /// Subscribes to TEST_CHANNEL, appending the received values to values
+  static std::shared_ptr<drake::lcm::DrakeSubscriptionInterface> Subscribe(
+      SharedMemoryLcm* lcm, vector<int>* values) {
+    return lcm->Subscribe(TEST_CHANNEL, [values](const void* data, int size) {
+      ASSERT_EQ(size, static_cast<int>(sizeof(int)));
+      values->push_back(*static_cast<const int*>(data));
+    });
+  }
+
+  string name_;
+};
+
+TEST_F(SharedMemoryLcmTest, PublishSubscribe) {
+  SharedMemoryLcm publisher(name_);
+  SharedMemoryLcm subscriber(name_);
+
+  // Messages published before subscribing are not received
+  Publish(&publisher, -1);
+  vector<int> values;
+  auto subscription = Subscribe(&subscriber, &values);
+  EXPECT_EQ(subscriber.HandleSubscriptions(0), 0);
+
+  for (int i = 0; i < 3; i++) {
+    Publish(&publisher, i);
+  }
+  EXPECT_EQ(subscriber.HandleSubscriptions(0), 3);
+  EXPECT_EQ(values, vector<int>({0, 1, 2}));
+  EXPECT_EQ(subscriber.HandleSubscriptions(0), 0);
+  EXPECT_EQ(subscriber.num_dropped(), 0);
+}
+
+TEST_F(SharedMemoryLcmTest, SlowReaderDropsOldest) {
+  SharedMemoryLcm::Options options;
+  options.num_slots = 4;
+  SharedMemoryLcm publisher(name_, options);
+  SharedMemoryLcm subscriber(name_, options);
+  vector<int> values;
+  auto subscription = Subscribe(&subscriber, &values);
+
+  for (int i = 0; i < 10; i++) {
+    Publish(&publisher, i);
+  }
+  EXPECT_EQ(subscriber.HandleSubscriptions(0), 4);
+  EXPECT_EQ(values, vector<int>({6, 7, 8, 9}));
+  EXPECT_EQ(subscriber.num_dropped(), 6);
+}
+
+TEST_F(SharedMemoryLcmTest, QueueCapacity) {
+  SharedMemoryLcm lcm(name_);
+  vector<int> values;
+  auto subscription = Subscribe(&lcm, &values);
+  subscription->set_queue_capacity(1);
+
+  for (int i = 0; i < 3; i++) {
+    Publish(&lcm, i);
+  }
+  lcm.HandleSubscriptions(0);
+  EXPECT_EQ(values, vector<int>({2}));
+}
+
+TEST_F(SharedMemoryLcmTest, WakesOnPublish) {
+  SharedMemoryLcm publisher(name_);
+  SharedMemoryLcm subscriber(name_);
+  vector<int> values;
+  auto subscription = Subscribe(&subscriber, &values);
+
+  std::thread thread([&publisher]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Publish(&publisher, 1);
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(subscriber.HandleSubscriptions(5000), 1);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  thread.join();
+  EXPECT_EQ(values, vector<int>({1}));
+}
+
+TEST_F(SharedMemoryLcmTest, Errors) {
+  SharedMemoryLcm::Options options;
+  options.slot_size = 2;
+  SharedMemoryLcm lcm(name_, options);
+  EXPECT_THROW(Publish(&lcm, 0), std::runtime_error);
+
+  options.slot_size = 4;
+  SharedMemoryLcm other(name_, options);
+  EXPECT_THROW(Publish(&other, 0), std::runtime_error);
+}
+
+}  // namespace dairlib
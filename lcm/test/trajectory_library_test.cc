@@ -0,0 +1,112 @@
+#include "lcm/trajectory_library.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "lcm/lcm_trajectory.h"
+#include "lcm/mapped_trajectory.h"
+
+namespace dairlib {
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+static const char TEST_TRAJ_NAME[] = "state_traj0";
+static const int NUM_FILES = 40;
+static const int NUM_DATAPOINTS = 5;
+
+class TrajectoryLibraryTest : public ::testing::Test {
+ protected:
+  /// Writes a trajectory from x0 = (speed, 0) to xf = (speed, speed * duration)
+  /// over the given duration, in the LCM or the mapped format
+  static string WriteFile(int index, double speed, double duration,
+                          bool mapped) {
+    LcmTrajectory::Trajectory traj;
+    traj.traj_name = TEST_TRAJ_NAME;
+    traj.time_vector = VectorXd::LinSpaced(NUM_DATAPOINTS, 0, duration);
+    traj.datapoints = MatrixXd(2, NUM_DATAPOINTS);
+    traj.datapoints.row(0).setConstant(speed);
+    traj.datapoints.row(1) = speed * traj.time_vector.transpose();
+    traj.datatypes = {"v", "x"};
+    LcmTrajectory lcm_traj({traj}, {TEST_TRAJ_NAME}, "test", "test");
+
+    string filepath = "TEST_LIBRARY_FILE_" + std::to_string(index);
+    if (mapped) {
+      MappedLcmTrajectory::WriteToFile(lcm_traj, filepath);
+    } else {
+      lcm_traj.WriteToFile(filepath);
+    }
+    return filepath;
+  }
+};
+
+TEST_F(TrajectoryLibraryTest, NearestMatchesBruteForce) {
+  TrajectoryLibraryOptions options;
+  options.final_state_trajectory = TEST_TRAJ_NAME;
+  options.state_indices = {1};
+  TrajectoryLibrary library(options);
+  for (int i = 0; i < NUM_FILES; i++) {
+    double speed = 0.1 * ((7 * i) % NUM_FILES);
+    double duration = 1 + 0.05 * ((3 * i) % 11);
+    library.AddFile(WriteFile(i, speed, duration, i % 2 == 0),
+                    VectorXd::Constant(1, speed));
+  }
+  library.Build();
+  EXPECT_EQ(library.size(), NUM_FILES);
+
+  for (double speed : {-1.0, 0.33, 1.27, 2.5, 5.0}) {
+    VectorXd xf(2);
+    xf << speed, 1.2 * speed;
+    VectorXd query = library.MakeQuery(VectorXd::Constant(1, speed),
+                                       VectorXd(), xf);
+    auto matches = library.FindNearest(query, 3);
+    ASSERT_EQ(matches.size(), 3);
+
+    // Brute force distances in the scaled feature space
+    vector<double> distances;
+    for (int i = 0; i < library.size(); i++) {
+      auto traj = library.GetTrajectory(i, TEST_TRAJ_NAME);
+      VectorXd features = library.MakeQuery(
+          library.get_parameters(i), VectorXd(),
+          traj.datapoints.col(NUM_DATAPOINTS - 1));
+      distances.push_back((features - query).norm());
+    }
+    std::sort(distances.begin(), distances.end());
+    for (int j = 0; j < 3; j++) {
+      EXPECT_NEAR(matches[j].distance, distances[j], 1e-12);
+    }
+  }
+}
+
+TEST_F(TrajectoryLibraryTest, InterpolateTest) {
+  TrajectoryLibrary library;
+  library.AddFile(WriteFile(0, 1, 1, true), VectorXd::Constant(1, 1));
+  library.AddFile(WriteFile(1, 2, 2, false), VectorXd::Constant(1, 2));
+  library.Build();
+
+  // Exact match
+  auto exact = library.Interpolate(library.MakeQuery(VectorXd::Constant(1, 2)),
+                                   TEST_TRAJ_NAME);
+  EXPECT_TRUE(exact.datapoints ==
+              library.GetTrajectory(1, TEST_TRAJ_NAME).datapoints);
+
+  // Halfway, both neighbours have equal weights
+  auto blended = library.Interpolate(
+      library.MakeQuery(VectorXd::Constant(1, 1.5)), TEST_TRAJ_NAME);
+  EXPECT_NEAR(blended.time_vector(NUM_DATAPOINTS - 1), 1.5, 1e-12);
+  EXPECT_NEAR(blended.datapoints(0, 0), 1.5, 1e-12);
+  EXPECT_NEAR(blended.datapoints(1, NUM_DATAPOINTS - 1), 2.5, 1e-12);
+}
+
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,286 @@
+#include "lcm/trajectory_library.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "drake/common/drake_assert.h"
+
+using Eigen::Map;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace dairlib {
+
+namespace {
+
+/// Linear interpolation of the columns of x, sampled at times t, at time s.
+/// Clamped to the first and last columns outside of [t(0), t(end)].
+VectorXd InterpolateColumn(const Eigen::Ref<const VectorXd>& t,
+                           const Eigen::Ref<const MatrixXd>& x, double s) {
+  const int n = t.size();
+  if (n == 1 || s <= t(0)) {
+    return x.col(0);
+  }
+  if (s >= t(n - 1)) {
+    return x.col(n - 1);
+  }
+  int k = std::upper_bound(t.data(), t.data() + n, s) - t.data() - 1;
+  double h = t(k + 1) - t(k);
+  double alpha = (h > 0) ? (s - t(k)) / h : 0;
+  return (1 - alpha) * x.col(k) + alpha * x.col(k + 1);
+}
+
+/// Appends b to a
+void Append(const VectorXd& b, VectorXd* a) {
+  const int size = a->size();
+  a->conservativeResize(size + b.size());
+  a->tail(b.size()) = b;
+}
+
+bool CompareMatches(const TrajectoryLibrary::Match& a,
+                    const TrajectoryLibrary::Match& b) {
+  return a.distance < b.distance;
+}
+
+}  // namespace
+
+TrajectoryLibrary::TrajectoryLibrary(const TrajectoryLibraryOptions& options)
+    : options_(options) {}
+
+int TrajectoryLibrary::AddFile(const string& filepath,
+                               const VectorXd& parameters) {
+  if (!entries_.empty()) {
+    DRAKE_DEMAND(parameters.size() == entries_[0].parameters.size());
+  }
+  Entry entry;
+  entry.filepath = filepath;
+  entry.parameters = parameters;
+  if (MappedLcmTrajectory::IsMappedFile(filepath)) {
+    entry.mapped = std::make_unique<MappedLcmTrajectory>(filepath);
+  } else {
+    entry.loaded = std::make_unique<LcmTrajectory>(filepath);
+  }
+  entries_.push_back(std::move(entry));
+  const int index = entries_.size() - 1;
+
+  VectorXd x0;
+  VectorXd xf;
+  if (!options_.initial_state_trajectory.empty()) {
+    x0 = GetTrajectory(index, options_.initial_state_trajectory)
+             .datapoints.col(0);
+  }
+  if (!options_.final_state_trajectory.empty()) {
+    auto xf_traj = GetTrajectory(index, options_.final_state_trajectory);
+    xf = xf_traj.datapoints.col(xf_traj.datapoints.cols() - 1);
+  }
+  entries_.back().features = RawFeatures(parameters, x0, xf);
+
+  // The tree has to be rebuilt
+  nodes_.clear();
+  root_ = -1;
+  return index;
+}
+
+MappedLcmTrajectory::TrajectoryView TrajectoryLibrary::GetTrajectory(
+    int index, const string& trajectory_name) const {
+  const Entry& entry = entries_.at(index);
+  if (entry.mapped) {
+    return entry.mapped->GetTrajectory(trajectory_name);
+  }
+  const auto& traj = entry.loaded->GetTrajectory(trajectory_name);
+  return {traj.traj_name,
+          Map<const VectorXd>(traj.time_vector.data(), traj.time_vector.size()),
+          Map<const MatrixXd>(traj.datapoints.data(), traj.datapoints.rows(),
+                              traj.datapoints.cols()),
+          traj.datatypes};
+}
+
+VectorXd TrajectoryLibrary::RawFeatures(const VectorXd& parameters,
+                                        const VectorXd& x0,
+                                        const VectorXd& xf) const {
+  auto state_features = [this](const VectorXd& x) {
+    if (options_.state_indices.empty()) {
+      return x;
+    }
+    VectorXd features(options_.state_indices.size());
+    for (int i = 0; i < features.size(); i++) {
+      features(i) = x(options_.state_indices[i]);
+    }
+    return features;
+  };
+
+  VectorXd features = options_.parameter_weight * parameters;
+  if (!options_.initial_state_trajectory.empty()) {
+    Append(options_.initial_state_weight * state_features(x0), &features);
+  }
+  if (!options_.final_state_trajectory.empty()) {
+    Append(options_.final_state_weight * state_features(xf), &features);
+  }
+  return features;
+}
+
+VectorXd TrajectoryLibrary::MakeQuery(const VectorXd& parameters,
+                                      const VectorXd& x0,
+                                      const VectorXd& xf) const {
+  DRAKE_DEMAND(root_ >= 0);
+  return RawFeatures(parameters, x0, xf).cwiseProduct(scale_);
+}
+
+void TrajectoryLibrary::Build() {
+  DRAKE_DEMAND(!entries_.empty());
+  const int n = entries_.size();
+  const int d = entries_[0].features.size();
+  DRAKE_DEMAND(d > 0);
+
+  MatrixXd raw(d, n);
+  for (int i = 0; i < n; i++) {
+    DRAKE_DEMAND(entries_[i].features.size() == d);
+    raw.col(i) = entries_[i].features;
+  }
+  scale_ = VectorXd::Ones(d);
+  if (options_.normalize && n > 1) {
+    VectorXd mean = raw.rowwise().mean();
+    for (int j = 0; j < d; j++) {
+      double std_dev = std::sqrt((raw.row(j).array() - mean(j)).square().sum() /
+                                 (n - 1));
+      if (std_dev > 0) {
+        scale_(j) = 1 / std_dev;
+      }
+    }
+  }
+  features_ = scale_.asDiagonal() * raw;
+
+  nodes_.clear();
+  nodes_.reserve(n);
+  vector<int> indices(n);
+  std::iota(indices.begin(), indices.end(), 0);
+  root_ = BuildTree(indices.begin(), indices.end());
+}
+
+int TrajectoryLibrary::BuildTree(vector<int>::iterator begin,
+                                 vector<int>::iterator end) {
+  if (begin == end) {
+    return -1;
+  }
+  // Split on the median of the dimension with the largest spread
+  int split_dimension = 0;
+  double max_spread = -1;
+  for (int j = 0; j < features_.rows(); j++) {
+    double min_value = features_(j, *begin);
+    double max_value = min_value;
+    for (auto it = begin; it != end; ++it) {
+      min_value = std::min(min_value, features_(j, *it));
+      max_value = std::max(max_value, features_(j, *it));
+    }
+    if (max_value - min_value > max_spread) {
+      max_spread = max_value - min_value;
+      split_dimension = j;
+    }
+  }
+  auto middle = begin + (end - begin) / 2;
+  std::nth_element(begin, middle, end, [&](int a, int b) {
+    return features_(split_dimension, a) < features_(split_dimension, b);
+  });
+
+  const int node = nodes_.size();
+  nodes_.push_back({*middle, split_dimension});
+  const int left = BuildTree(begin, middle);
+  const int right = BuildTree(middle + 1, end);
+  nodes_[node].left = left;
+  nodes_[node].right = right;
+  return node;
+}
+
+void TrajectoryLibrary::SearchTree(int node, const VectorXd& query, int k,
+                                   vector<Match>* heap) const {
+  if (node < 0) {
+    return;
+  }
+  // heap is a max-heap of squared distances, holding the best k so far
+  const Node& current = nodes_[node];
+  double distance = (features_.col(current.entry) - query).squaredNorm();
+  if (static_cast<int>(heap->size()) < k) {
+    heap->push_back({current.entry, distance});
+    std::push_heap(heap->begin(), heap->end(), CompareMatches);
+  } else if (distance < heap->front().distance) {
+    std::pop_heap(heap->begin(), heap->end(), CompareMatches);
+    heap->back() = {current.entry, distance};
+    std::push_heap(heap->begin(), heap->end(), CompareMatches);
+  }
+
+  double offset = query(current.split_dimension) -
+                  features_(current.split_dimension, current.entry);
+  int near = (offset < 0) ? current.left : current.right;
+  int far = (offset < 0) ? current.right : current.left;
+  SearchTree(near, query, k, heap);
+  if (static_cast<int>(heap->size()) < k ||
+      offset * offset < heap->front().distance) {
+    SearchTree(far, query, k, heap);
+  }
+}
+
+vector<TrajectoryLibrary::Match> TrajectoryLibrary::FindNearest(
+    const VectorXd& query, int k) const {
+  DRAKE_DEMAND(root_ >= 0);
+  DRAKE_DEMAND(query.size() == features_.rows());
+  DRAKE_DEMAND(k > 0);
+  vector<Match> heap;
+  heap.reserve(k);
+  SearchTree(root_, query, k, &heap);
+  std::sort_heap(heap.begin(), heap.end(), CompareMatches);
+  for (auto& match : heap) {
+    match.distance = std::sqrt(match.distance);
+  }
+  return heap;
+}
+
+LcmTrajectory::Trajectory TrajectoryLibrary::Interpolate(
+    const VectorXd& query, const string& trajectory_name, int k) const {
+  vector<Match> matches = FindNearest(query, k);
+  auto nearest = GetTrajectory(matches[0].index, trajectory_name);
+  if (matches.size() == 1 || matches[0].distance == 0) {
+    return nearest.Copy();
+  }
+
+  // Normalized time of the nearest trajectory's samples
+  const int n = nearest.time_vector.size();
+  double duration = nearest.time_vector(n - 1) - nearest.time_vector(0);
+  VectorXd phase = VectorXd::Zero(n);
+  if (duration > 0) {
+    phase = ((nearest.time_vector.array() - nearest.time_vector(0)) / duration)
+                .matrix();
+  }
+
+  LcmTrajectory::Trajectory traj;
+  traj.traj_name = nearest.traj_name;
+  traj.datatypes = nearest.datatypes;
+  traj.datapoints = MatrixXd::Zero(nearest.datapoints.rows(), n);
+  double start_time = 0;
+  double blended_duration = 0;
+  double total_weight = 0;
+  for (const auto& match : matches) {
+    auto neighbour = GetTrajectory(match.index, trajectory_name);
+    DRAKE_DEMAND(neighbour.datapoints.rows() == nearest.datapoints.rows());
+    const auto& t = neighbour.time_vector;
+    double t0 = t(0);
+    double neighbour_duration = t(t.size() - 1) - t0;
+    double weight = 1 / match.distance;
+    for (int j = 0; j < n; j++) {
+      traj.datapoints.col(j) +=
+          weight * InterpolateColumn(t, neighbour.datapoints,
+                                     t0 + phase(j) * neighbour_duration);
+    }
+    start_time += weight * t0;
+    blended_duration += weight * neighbour_duration;
+    total_weight += weight;
+  }
+  traj.datapoints /= total_weight;
+  traj.time_vector =
+      ((start_time + phase.array() * blended_duration) / total_weight).matrix();
+  return traj;
+}
+
+}  // namespace dairlib
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "lcm/lcm_trajectory.h"
+#include "lcm/mapped_trajectory.h"
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+struct TrajectoryLibraryOptions {
+  /// Trajectory whose first and last columns are the initial and final
+  /// states, e.g. "state_traj0" and "state_traj<num_modes - 1>" for a
+  /// DirconTrajectory. Leave empty to not index by that state.
+  std::string initial_state_trajectory;
+  std::string final_state_trajectory;
+  /// Rows of the state trajectories used as features, all rows if empty
+  std::vector<int> state_indices;
+  /// Relative weights of the user-supplied parameters and of the state
+  /// features in the distance
+  double parameter_weight = 1;
+  double initial_state_weight = 1;
+  double final_state_weight = 1;
+  /// Scales every feature by the inverse of its standard deviation over the
+  /// library, so that features in different units are comparable
+  bool normalize = true;
+};
+
+/// TrajectoryLibrary holds many saved trajectories, for instance gaits over a
+/// range of speeds or jumps over a range of heights, and selects among them
+/// online.
+///
+/// Each file is indexed by a feature vector made of user-supplied parameters
+/// (speed, height, ...) and, optionally, the initial and final states of one
+/// of its trajectories. Files in the mapped format (see MappedLcmTrajectory)
+/// are mapped, so that adding them only reads their index; files in the LCM
+/// format are loaded. Once all files are added, Build() constructs a k-d tree
+/// over the features, after which FindNearest and Interpolate only touch the
+/// tree and the selected trajectories.
+///
+/// Queries are const and may be run concurrently.
+class TrajectoryLibrary {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(TrajectoryLibrary)
+
+  explicit TrajectoryLibrary(const TrajectoryLibraryOptions& options = {});
+
+  /// Adds a trajectory file with the given parameters, which must have the
+  /// same size for every file
+  /// @return The index of the file in the library
+  /// @throws std::exception if the file cannot be loaded
+  int AddFile(const std::string& filepath, const Eigen::VectorXd& parameters);
+
+  /// Builds the search tree. Must be called after the last AddFile, and
+  /// before any query.
+  void Build();
+
+  int size() const { return entries_.size(); }
+
+  const std::string& get_filepath(int index) const {
+    return entries_.at(index).filepath;
+  }
+
+  const Eigen::VectorXd& get_parameters(int index) const {
+    return entries_.at(index).parameters;
+  }
+
+  /// View of a trajectory of the file at index, valid as long as the library
+  MappedLcmTrajectory::TrajectoryView GetTrajectory(
+      int index, const std::string& trajectory_name) const;
+
+  /// Builds the feature vector of a query. x0 and xf are full states, and are
+  /// ignored (and may be empty) if the library is not indexed by them.
+  Eigen::VectorXd MakeQuery(
+      const Eigen::VectorXd& parameters,
+      const Eigen::VectorXd& x0 = Eigen::VectorXd(),
+      const Eigen::VectorXd& xf = Eigen::VectorXd()) const;
+
+  struct Match {
+    int index;
+    /// Weighted (and normalized) distance to the query
+    double distance;
+  };
+
+  /// Returns the k entries nearest to the query, closest first
+  std::vector<Match> FindNearest(const Eigen::VectorXd& query,
+                                 int k = 1) const;
+
+  /// Blends the named trajectory of the k entries nearest to the query, with
+  /// weights inversely proportional to their distance. The neighbours are
+  /// resampled (linearly, in normalized time) onto the time points of the
+  /// nearest one, and their start times and durations are blended alike. All
+  /// neighbours must have the same datatypes. Returns the nearest trajectory
+  /// unchanged if it matches the query exactly.
+  LcmTrajectory::Trajectory Interpolate(const Eigen::VectorXd& query,
+                                        const std::string& trajectory_name,
+                                        int k = 2) const;
+
+ private:
+  struct Entry {
+    std::string filepath;
+    Eigen::VectorXd parameters;
+    Eigen::VectorXd features;
+    // Exactly one of them is set
+    std::unique_ptr<MappedLcmTrajectory> mapped;
+    std::unique_ptr<LcmTrajectory> loaded;
+  };
+
+  struct Node {
+    int entry;
+    int split_dimension;
+    int left = -1;
+    int right = -1;
+  };
+
+  /// Weighted, but not yet normalized, features
+  Eigen::VectorXd RawFeatures(const Eigen::VectorXd& parameters,
+                              const Eigen::VectorXd& x0,
+                              const Eigen::VectorXd& xf) const;
+  int BuildTree(std::vector<int>::iterator begin,
+                std::vector<int>::iterator end);
+  void SearchTree(int node, const Eigen::VectorXd& query, int k,
+                  std::vector<Match>* heap) const;
+
+  const TrajectoryLibraryOptions options_;
+  std::vector<Entry> entries_;
+  /// Per-feature scaling, applied to the stored features and to queries
+  Eigen::VectorXd scale_;
+  /// Scaled features, one column per entry
+  Eigen::MatrixXd features_;
+  std::vector<Node> nodes_;
+  int root_ = -1;
+};
+
+}  // namespace dairlib
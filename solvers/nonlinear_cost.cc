@@ -1,4 +1,10 @@
 #include "solvers/nonlinear_cost.h"
+
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
 #include "drake/common/default_scalars.h"
 #include "drake/math/autodiff.h"
 #include "drake/math/autodiff_gradient.h"
@@ -12,11 +18,97 @@ using drake::VectorX;
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
+namespace {
+
+/// Calls f(thread_index, num_threads) on each of num_threads threads
+template <typename F>
+void RunOnThreads(int num_threads, const F& f) {
+  if (num_threads <= 1) {
+    f(0, 1);
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&f, t, num_threads]() { f(t, num_threads); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
 template <typename T>
 NonlinearCost<T>::NonlinearCost(int num_vars, const std::string& description,
                                 double eps)
     : Cost(num_vars, description), eps_(eps) {}
 
+template <typename T>
+void NonlinearCost<T>::EvaluateCostTerms(
+    const Eigen::Ref<const VectorX<T>>& x, VectorX<T>* terms) const {
+  throw std::logic_error(
+      "NonlinearCost with cost terms must implement EvaluateCostTerms.");
+}
+
+template <typename T>
+void NonlinearCost<T>::SetNumDifferencingThreads(int num_threads) {
+  DRAKE_DEMAND(num_threads > 0);
+  num_threads_ = num_threads;
+}
+
+template <typename T>
+void NonlinearCost<T>::SetDependentVariables(const std::vector<int>& indices) {
+  std::vector<std::pair<int, int>> sparsity;
+  for (int i : indices) {
+    DRAKE_DEMAND(i >= 0 && i < num_vars());
+    sparsity.emplace_back(0, i);
+  }
+  dependent_variables_ = indices;
+  SetGradientSparsityPattern(sparsity);
+}
+
+template <typename T>
+void NonlinearCost<T>::SetCostTerms(
+    const std::vector<std::vector<int>>& term_variables) {
+  variable_terms_.assign(num_vars(), {});
+  for (int k = 0; k < static_cast<int>(term_variables.size()); k++) {
+    for (int i : term_variables[k]) {
+      DRAKE_DEMAND(i >= 0 && i < num_vars());
+      variable_terms_[i].push_back(k);
+    }
+  }
+
+  // Greedy coloring: a variable gets the lowest color not already used by a
+  // variable sharing one of its terms
+  colors_.clear();
+  std::vector<int> color(num_vars(), -1);
+  std::vector<int> dependent_variables;
+  for (int i = 0; i < num_vars(); i++) {
+    if (variable_terms_[i].empty()) {
+      continue;
+    }
+    std::set<int> used;
+    for (int k : variable_terms_[i]) {
+      for (int j : term_variables[k]) {
+        if (color[j] >= 0) {
+          used.insert(color[j]);
+        }
+      }
+    }
+    int c = 0;
+    while (used.count(c)) {
+      c++;
+    }
+    color[i] = c;
+    if (c == static_cast<int>(colors_.size())) {
+      colors_.emplace_back();
+    }
+    colors_[c].push_back(i);
+    dependent_variables.push_back(i);
+  }
+  SetDependentVariables(dependent_variables);
+}
+
 template <>
 void NonlinearCost<double>::DoEval(const Eigen::Ref<const Eigen::VectorXd>& x,
                                    Eigen::VectorXd* y) const {
@@ -44,6 +136,60 @@ void NonlinearCost<AutoDiffXd>::DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
   EvaluateCost(x, y);
 }
 
+template <>
+MatrixXd NonlinearCost<double>::DifferenceColumns(const VectorXd& x,
+                                                  const VectorXd& y0) const {
+  std::vector<int> columns = dependent_variables_;
+  if (columns.empty()) {
+    columns.resize(x.size());
+    std::iota(columns.begin(), columns.end(), 0);
+  }
+  const int n = columns.size();
+
+  // Every thread perturbs its own copy of x, and writes distinct columns
+  MatrixXd dy = MatrixXd::Zero(y0.size(), x.size());
+  RunOnThreads(std::min(num_threads_, n), [&](int thread, int num_threads) {
+    VectorXd x_i = x;
+    VectorXd y_i;
+    for (int k = thread; k < n; k += num_threads) {
+      int i = columns[k];
+      x_i(i) += eps_;
+      EvaluateCost(x_i, &y_i);
+      x_i(i) = x(i);
+      dy.col(i) = (y_i - y0) / eps_;
+    }
+  });
+  return dy;
+}
+
+template <>
+MatrixXd NonlinearCost<double>::DifferenceColors(const VectorXd& x) const {
+  VectorXd terms0;
+  EvaluateCostTerms(x, &terms0);
+  const int n = colors_.size();
+
+  // Variables of the same color share no term, so every perturbed term is
+  // attributed to exactly one variable
+  MatrixXd dy = MatrixXd::Zero(1, x.size());
+  RunOnThreads(std::min(num_threads_, n), [&](int thread, int num_threads) {
+    VectorXd x_c = x;
+    VectorXd terms;
+    for (int k = thread; k < n; k += num_threads) {
+      for (int i : colors_[k]) {
+        x_c(i) += eps_;
+      }
+      EvaluateCostTerms(x_c, &terms);
+      for (int i : colors_[k]) {
+        x_c(i) = x(i);
+        for (int term : variable_terms_[i]) {
+          dy(0, i) += (terms(term) - terms0(term)) / eps_;
+        }
+      }
+    }
+  });
+  return dy;
+}
+
 template <>
 void NonlinearCost<double>::DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
                                    AutoDiffVecXd* y) const {
@@ -51,16 +197,11 @@ void NonlinearCost<double>::DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
 
   // forward differencing
   VectorXd x_val = drake::math::autoDiffToValueMatrix(x);
-  VectorXd y0, yi;
+  VectorXd y0;
   EvaluateCost(x_val, &y0);
 
-  MatrixXd dy = MatrixXd(y0.size(), x_val.size());
-  for (int i = 0; i < x_val.size(); i++) {
-    x_val(i) += eps_;
-    EvaluateCost(x_val, &yi);
-    x_val(i) -= eps_;
-    dy.col(i) = (yi - y0) / eps_;
-  }
+  MatrixXd dy = colors_.empty() ? DifferenceColumns(x_val, y0)
+                                : DifferenceColors(x_val);
   drake::math::initializeAutoDiffGivenGradientMatrix(y0, dy * original_grad,
                                                      *y);
 }
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+
 #include "drake/common/symbolic.h"
 #include "drake/solvers/cost.h"
 
@@ -35,8 +37,46 @@ class NonlinearCost : public drake::solvers::Cost {
   virtual void EvaluateCost(const Eigen::Ref<const drake::VectorX<T>>& x,
                             drake::VectorX<T>* y) const = 0;
 
+  /// Evaluates the individual terms of a cost declared by SetCostTerms, whose
+  /// sum is the cost. Only needs to be implemented by such costs.
+  virtual void EvaluateCostTerms(const Eigen::Ref<const drake::VectorX<T>>& x,
+                                 drake::VectorX<T>* terms) const;
+
+  /// The following options only affect the numerical differencing of
+  /// NonlinearCost<double>.
+
+  /// Evaluates the perturbed costs on num_threads threads, each with its own
+  /// copy of the input. EvaluateCost (and EvaluateCostTerms) must then be safe
+  /// to call concurrently. Only worthwhile for expensive costs, as threads are
+  /// started on every gradient evaluation.
+  void SetNumDifferencingThreads(int num_threads);
+
+  /// Declares that the cost only depends on the given input indices. All other
+  /// gradient entries are zero, and are not differenced.
+  void SetDependentVariables(const std::vector<int>& indices);
+
+  /// Declares that the cost is a sum of terms, where term k only depends on
+  /// the input indices term_variables[k], and enables colored differencing:
+  /// variables which share no term are perturbed together, so that a gradient
+  /// costs one EvaluateCostTerms call per color rather than one EvaluateCost
+  /// call per variable. For a sum of N terms over disjoint windows of knot
+  /// points, the number of colors is independent of N.
+  void SetCostTerms(const std::vector<std::vector<int>>& term_variables);
+
  private:
+  /// Forward-differenced gradient of a cost with value y0 at x
+  Eigen::MatrixXd DifferenceColumns(const Eigen::VectorXd& x,
+                                    const Eigen::VectorXd& y0) const;
+  Eigen::MatrixXd DifferenceColors(const Eigen::VectorXd& x) const;
+
   double eps_;
+  int num_threads_ = 1;
+  /// Columns to difference, all of them if empty
+  std::vector<int> dependent_variables_;
+  /// Terms of the cost depending on each variable, see SetCostTerms
+  std::vector<std::vector<int>> variable_terms_;
+  /// Variables perturbed together, see SetCostTerms
+  std::vector<std::vector<int>> colors_;
 };
 
 }  // namespace solvers
@@ -1,18 +1,72 @@
 #include "solvers/optimization_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <thread>
+
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 using drake::solvers::Constraint;
+using drake::solvers::Cost;
 using drake::solvers::Binding;
+using drake::solvers::LinearConstraint;
+using drake::solvers::LinearCost;
+using drake::solvers::QuadraticCost;
 using drake::solvers::MathematicalProgram;
 using drake::AutoDiffVecXd;
 using drake::math::initializeAutoDiff;
 using drake::math::autoDiffToGradientMatrix;
 using drake::math::autoDiffToValueMatrix;
+using Triplet = Eigen::Triplet<double>;
 
 namespace dairlib {
 namespace solvers {
 
+namespace {
+
+/// Calls f(i) for i = 0, ..., n - 1, distributed over num_threads threads
+void ParallelFor(int n, int num_threads,
+                 const std::function<void(int)>& f) {
+  num_threads = std::min(num_threads, n);
+  if (num_threads <= 1) {
+    for (int i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+  std::atomic<int> next(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&]() {
+      for (int i = next++; i < n; i = next++) {
+        f(i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/// Indices of the binding's variables in the program's decision variables
+template <typename C>
+std::vector<int> BindingVariableIndices(const MathematicalProgram& prog,
+                                        const Binding<C>& binding) {
+  const auto& variables = binding.variables();
+  std::vector<int> indices(variables.size());
+  for (int i = 0; i < variables.size(); i++) {
+    indices[i] = prog.FindDecisionVariableIndex(variables(i));
+  }
+  return indices;
+}
+
+}  // namespace
+
 bool CheckGenericConstraints(const MathematicalProgram& prog,
     const drake::solvers::MathematicalProgramResult& result,
     double tol) {
@@ -135,6 +189,172 @@ void LinearizeConstraints(const MathematicalProgram& prog, const VectorXd& x,
   }
 }
 
+void LinearizeConstraints(const MathematicalProgram& prog, const VectorXd& x,
+    VectorXd* y, Eigen::SparseMatrix<double>* A, VectorXd* lb, VectorXd* ub,
+    int num_threads) {
+  auto constraints = prog.GetAllConstraints();
+  const int num_bindings = constraints.size();
+
+  // Row offset of every binding, in the order of GetConstraintRows
+  std::vector<int> row_start(num_bindings + 1, 0);
+  for (int k = 0; k < num_bindings; k++) {
+    row_start[k + 1] =
+        row_start[k] + constraints[k].evaluator()->num_constraints();
+  }
+  const int num_constraints = row_start[num_bindings];
+
+  lb->resize(num_constraints);
+  ub->resize(num_constraints);
+  y->resize(num_constraints);
+
+  // Each binding writes its own rows of y, lb, ub and its own triplets
+  std::vector<std::vector<Triplet>> triplets(num_bindings);
+  ParallelFor(num_bindings, num_threads, [&](int k) {
+    const auto& binding = constraints[k];
+    const auto& c = binding.evaluator();
+    const int n = c->num_constraints();
+    const int row = row_start[k];
+    lb->segment(row, n) = c->lower_bound();
+    ub->segment(row, n) = c->upper_bound();
+
+    std::vector<int> indices = BindingVariableIndices(prog, binding);
+    VectorXd x_binding(indices.size());
+    for (int i = 0; i < static_cast<int>(indices.size()); i++) {
+      x_binding(i) = x(indices[i]);
+    }
+
+    MatrixXd dx;
+    auto linear = std::dynamic_pointer_cast<LinearConstraint>(c);
+    if (linear) {
+      dx = linear->A();
+      y->segment(row, n) = dx * x_binding;
+    } else {
+      AutoDiffVecXd y_val;
+      c->Eval(initializeAutoDiff(x_binding), &y_val);
+      dx = autoDiffToGradientMatrix(y_val);
+      y->segment(row, n) = autoDiffToValueMatrix(y_val);
+      if (dx.cols() == 0) {
+        // Constant constraint, with no gradient information
+        return;
+      }
+    }
+
+    for (int i = 0; i < dx.cols(); i++) {
+      for (int j = 0; j < n; j++) {
+        if (dx(j, i) != 0) {
+          triplets[k].emplace_back(row + j, indices[i], dx(j, i));
+        }
+      }
+    }
+  });
+
+  std::vector<Triplet> all_triplets;
+  for (auto& binding_triplets : triplets) {
+    all_triplets.insert(all_triplets.end(), binding_triplets.begin(),
+                        binding_triplets.end());
+  }
+  A->resize(num_constraints, prog.num_vars());
+  A->setFromTriplets(all_triplets.begin(), all_triplets.end());
+}
+
+double SecondOrderCost(const MathematicalProgram& prog, const VectorXd& x_nom,
+    Eigen::SparseMatrix<double>* Q, VectorXd* w, double eps,
+    int num_threads) {
+  auto costs = prog.GetAllCosts();
+  const int num_bindings = costs.size();
+
+  // Per-binding cost value, gradient and Hessian entries, summed afterwards
+  std::vector<double> values(num_bindings, 0);
+  std::vector<std::vector<int>> indices(num_bindings);
+  std::vector<VectorXd> gradients(num_bindings);
+  std::vector<std::vector<Triplet>> triplets(num_bindings);
+
+  ParallelFor(num_bindings, num_threads, [&](int k) {
+    const auto& binding = costs[k];
+    indices[k] = BindingVariableIndices(prog, binding);
+    const int n = indices[k].size();
+    if (n == 0) {
+      return;
+    }
+    VectorXd x_binding(n);
+    for (int i = 0; i < n; i++) {
+      x_binding(i) = x_nom(indices[k][i]);
+    }
+
+    // Linear and quadratic costs have exact, constant Hessians
+    auto linear = std::dynamic_pointer_cast<LinearCost>(binding.evaluator());
+    auto quadratic =
+        std::dynamic_pointer_cast<QuadraticCost>(binding.evaluator());
+    if (linear) {
+      values[k] = linear->a().dot(x_binding) + linear->b();
+      gradients[k] = linear->a();
+      return;
+    }
+    if (quadratic) {
+      MatrixXd H = 0.5 * (quadratic->Q() + quadratic->Q().transpose());
+      values[k] = 0.5 * x_binding.dot(quadratic->Q() * x_binding) +
+                  quadratic->b().dot(x_binding) + quadratic->c();
+      gradients[k] = H * x_binding + quadratic->b();
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          if (H(i, j) != 0) {
+            triplets[k].emplace_back(indices[k][i], indices[k][j], H(i, j));
+          }
+        }
+      }
+      return;
+    }
+
+    AutoDiffVecXd x_val = initializeAutoDiff(x_binding);
+    AutoDiffVecXd y_val;
+    binding.evaluator()->Eval(x_val, &y_val);
+    values[k] = autoDiffToValueMatrix(y_val)(0);  // costs are length 1
+    MatrixXd gradient_x = autoDiffToGradientMatrix(y_val);
+    if (gradient_x.cols() == 0) {
+      gradients[k] = VectorXd::Zero(n);
+      return;
+    }
+    gradients[k] = gradient_x.row(0).transpose();
+
+    // forward differencing for Hessian, over this binding's variables only
+    AutoDiffVecXd y_hessian;
+    for (int i = 0; i < n; i++) {
+      x_val(i) += eps;
+      binding.evaluator()->Eval(x_val, &y_hessian);
+      x_val(i) -= eps;
+      MatrixXd gradient_hessian = autoDiffToGradientMatrix(y_hessian);
+      for (int j = 0; j <= i; j++) {
+        double d = (gradient_hessian(0, j) - gradient_x(0, j)) / eps;
+        if (d == 0) {
+          continue;
+        }
+        triplets[k].emplace_back(indices[k][i], indices[k][j], d);
+        if (indices[k][i] != indices[k][j]) {
+          triplets[k].emplace_back(indices[k][j], indices[k][i], d);
+        }
+      }
+    }
+  });
+
+  double c = 0;
+  *w = VectorXd::Zero(prog.num_vars());
+  std::vector<Triplet> all_triplets;
+  for (int k = 0; k < num_bindings; k++) {
+    if (indices[k].empty()) {
+      continue;
+    }
+    c += values[k];
+    for (int i = 0; i < static_cast<int>(indices[k].size()); i++) {
+      (*w)(indices[k][i]) += gradients[k](i);
+    }
+    all_triplets.insert(all_triplets.end(), triplets[k].begin(),
+                        triplets[k].end());
+  }
+  Q->resize(prog.num_vars(), prog.num_vars());
+  Q->setFromTriplets(all_triplets.begin(), all_triplets.end());
+  return c;
+}
+
 /// Helper method, returns a vector of given length
 /// [start, start+1, ..., (start + length -1)]
 VectorXd NVec(int start, int length) {
@@ -186,13 +406,108 @@ double EvalCostGivenSolution(
 
 double EvalCostGivenSolution(
     const drake::solvers::MathematicalProgramResult& result,
-    const std::vector<drake::solvers::Binding<drake::solvers::Cost>>& c) {
+    const std::vector<drake::solvers::Binding<drake::solvers::Cost>>& c,
+    int num_threads) {
+  std::vector<double> cost_vals(c.size());
+  ParallelFor(c.size(), num_threads, [&](int i) {
+    cost_vals[i] = solvers::EvalCostGivenSolution(result, c[i]);
+  });
   double cost_val_sum = 0;
-  for (const auto& cost_binding : c) {
-    cost_val_sum += solvers::EvalCostGivenSolution(result, cost_binding);
+  for (double cost_val : cost_vals) {
+    cost_val_sum += cost_val;
   }
   return cost_val_sum;
 }
 
+std::string GroupDescription(const std::string& description) {
+  if (description.empty()) {
+    return "(no description)";
+  }
+  std::string group;
+  size_t i = 0;
+  while (i < description.size()) {
+    size_t close = description.find(']', i);
+    if (description[i] == '[' && close != std::string::npos) {
+      // Collapse consecutive bracketed indices into a single [*]
+      if (group.size() < 3 || group.compare(group.size() - 3, 3, "[*]") != 0) {
+        group += "[*]";
+      }
+      i = close + 1;
+    } else {
+      group += description[i];
+      i++;
+    }
+  }
+  return group;
+}
+
+ConstraintViolationReport EvaluateConstraintViolations(
+    const MathematicalProgram& prog, const VectorXd& x, bool generic_only,
+    int num_threads) {
+  std::vector<Binding<Constraint>> constraints;
+  if (generic_only) {
+    constraints = prog.generic_constraints();
+  } else {
+    constraints = prog.GetAllConstraints();
+  }
+
+  ConstraintViolationReport report;
+  report.bindings.resize(constraints.size());
+  ParallelFor(constraints.size(), num_threads, [&](int k) {
+    const auto& binding = constraints[k];
+    const auto& c = binding.evaluator();
+    VectorXd y = prog.EvalBinding(binding, x);
+    VectorXd violation =
+        (c->lower_bound() - y).cwiseMax(y - c->upper_bound()).cwiseMax(0);
+    // NaN compares false above, so it would otherwise pass as satisfied
+    for (int i = 0; i < y.size(); i++) {
+      if (std::isnan(y(i))) {
+        violation(i) = std::numeric_limits<double>::infinity();
+      }
+    }
+    ConstraintViolation& result = report.bindings[k];
+    result.description = c->get_description();
+    result.num_bindings = 1;
+    result.num_rows = y.size();
+    result.max_violation = (y.size() > 0) ? violation.maxCoeff() : 0;
+    result.l2_violation = violation.norm();
+  });
+
+  std::map<std::string, ConstraintViolation> groups;
+  for (const auto& binding : report.bindings) {
+    std::string name = GroupDescription(binding.description);
+    ConstraintViolation& group = groups[name];
+    group.description = name;
+    group.num_bindings++;
+    group.num_rows += binding.num_rows;
+    group.max_violation = std::max(group.max_violation, binding.max_violation);
+    // Accumulate the squared norm, converted back below
+    group.l2_violation += binding.l2_violation * binding.l2_violation;
+    report.max_violation =
+        std::max(report.max_violation, binding.max_violation);
+  }
+  for (auto& [name, group] : groups) {
+    group.l2_violation = std::sqrt(group.l2_violation);
+    report.groups.push_back(group);
+  }
+  std::stable_sort(
+      report.groups.begin(), report.groups.end(),
+      [](const ConstraintViolation& a, const ConstraintViolation& b) {
+        return a.max_violation > b.max_violation;
+      });
+  return report;
+}
+
+void ConstraintViolationReport::Print(double tol) const {
+  for (const auto& group : groups) {
+    if (group.max_violation > tol) {
+      std::cout << "Constraint violation: " << group.description << " ("
+                << group.num_bindings << " bindings), max "
+                << group.max_violation << ", L2 " << group.l2_violation
+                << std::endl;
+    }
+  }
+}
+
 }  // namespace solvers
 }  // namespace dairlib
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include <Eigen/Sparse>
+
 #include "drake/solvers/mathematical_program.h"
 #include "drake/solvers/mathematical_program_result.h"
 #include "drake/solvers/decision_variable.h"
@@ -17,6 +22,49 @@ bool CheckGenericConstraints(const drake::solvers::MathematicalProgram& prog,
     const drake::solvers::MathematicalProgramResult& result,
     double tol = 1e-6);
 
+/// Violation of one constraint binding, or of a group of bindings, where the
+/// violation of each row lb <= f(x) <= ub is max(lb - f(x), f(x) - ub, 0)
+struct ConstraintViolation {
+  /// The binding description, or the group name for groups
+  std::string description;
+  int num_bindings = 0;
+  int num_rows = 0;
+  /// Largest violation of any row
+  double max_violation = 0;
+  /// 2-norm of the violations of all rows
+  double l2_violation = 0;
+};
+
+struct ConstraintViolationReport {
+  /// One entry per binding, in the order of the program
+  std::vector<ConstraintViolation> bindings;
+  /// One entry per group of bindings (see GroupDescription), sorted by
+  /// decreasing max_violation
+  std::vector<ConstraintViolation> groups;
+  double max_violation = 0;
+
+  bool is_satisfied(double tol = 1e-6) const { return max_violation <= tol; }
+
+  /// Prints the groups with a violation above tol
+  void Print(double tol = 1e-6) const;
+};
+
+/// Evaluates the violation of the constraints of a program at x, without
+/// printing.
+/// @param generic_only If true, only generic (nonlinear) constraints are
+///   checked, as in CheckGenericConstraints. Otherwise all constraints are.
+/// @param num_threads The number of threads used to evaluate the bindings.
+///   Only use more than one if every constraint can be evaluated concurrently.
+///   This is not the case for Dircon, whose constraints share contexts between
+///   neighboring knot points.
+ConstraintViolationReport EvaluateConstraintViolations(
+    const drake::solvers::MathematicalProgram& prog, const Eigen::VectorXd& x,
+    bool generic_only = true, int num_threads = 1);
+
+/// Name used to group bindings by description, with any bracketed indices
+/// replaced by [*], e.g. "collocation[0][3]" becomes "collocation[*]"
+std::string GroupDescription(const std::string& description);
+
 /// Given a MathematicalProgram and associated constraint Binding, returns
 /// the vector of row indices associated with that constraint.
 /// Note that an exact ordering of constraints is *not* inherant to
@@ -38,6 +86,20 @@ void LinearizeConstraints(const drake::solvers::MathematicalProgram& prog,
                           Eigen::MatrixXd* A, Eigen::VectorXd* lb,
                           Eigen::VectorXd* ub);
 
+/// Sparse version of LinearizeConstraints. Rows are ordered identically.
+///
+/// Only the columns of the variables each binding touches are filled, and
+/// the gradients of linear constraints are read directly from their A
+/// matrices instead of being differentiated.
+/// @param num_threads The number of threads used to evaluate the bindings.
+///   Only use more than one if every constraint can be evaluated concurrently.
+///   This is not the case for Dircon, whose constraints share contexts between
+///   neighboring knot points.
+void LinearizeConstraints(const drake::solvers::MathematicalProgram& prog,
+                          const Eigen::VectorXd& x, Eigen::VectorXd* y,
+                          Eigen::SparseMatrix<double>* A, Eigen::VectorXd* lb,
+                          Eigen::VectorXd* ub, int num_threads = 1);
+
 /// Form a second order approximation to the cost of an optimization program
 /// about some nominal value
 ///
@@ -55,6 +117,17 @@ double SecondOrderCost(const drake::solvers::MathematicalProgram& prog,
     const Eigen::VectorXd& x_nom, Eigen::MatrixXd* Q, Eigen::VectorXd* w,
     double eps = 1e-8);
 
+/// Sparse version of SecondOrderCost.
+///
+/// Each binding contributes only a block over the variables it touches.
+/// Linear and quadratic costs use their exact gradients and Hessians, and
+/// numerical differencing is only used for the remaining costs.
+/// @param num_threads The number of threads used to evaluate the bindings.
+///   Only use more than one if every cost can be evaluated concurrently.
+double SecondOrderCost(const drake::solvers::MathematicalProgram& prog,
+    const Eigen::VectorXd& x_nom, Eigen::SparseMatrix<double>* Q,
+    Eigen::VectorXd* w, double eps = 1e-8, int num_threads = 1);
+
 /// Count the total number of constraint rows, if lb <= f(x) <= ub, this is
 /// the dimension of f(x)
 int CountConstraintRows(const drake::solvers::MathematicalProgram& prog);
@@ -62,9 +135,13 @@ int CountConstraintRows(const drake::solvers::MathematicalProgram& prog);
 double EvalCostGivenSolution(
     const drake::solvers::MathematicalProgramResult& result,
     const drake::solvers::Binding<drake::solvers::Cost>& c);
+/// Sums the costs at the solution.
+/// @param num_threads The number of threads used to evaluate the bindings.
+///   Only use more than one if every cost can be evaluated concurrently.
 double EvalCostGivenSolution(
     const drake::solvers::MathematicalProgramResult& result,
-    const std::vector<drake::solvers::Binding<drake::solvers::Cost>>& c);
+    const std::vector<drake::solvers::Binding<drake::solvers::Cost>>& c,
+    int num_threads = 1);
 
 }  // namespace solvers
 }  // namespace dairlib
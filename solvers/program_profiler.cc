@@ -0,0 +1,316 @@
+#include "solvers/program_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+#include "solvers/optimization_utils.h"
+
+namespace dairlib {
+namespace solvers {
+
+using drake::AutoDiffVecXd;
+using drake::VectorX;
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
+using drake::solvers::Cost;
+using drake::solvers::MathematicalProgram;
+using drake::symbolic::Expression;
+using drake::symbolic::Variable;
+using Eigen::VectorXd;
+
+namespace {
+
+using Counters = ProgramProfiler::Counters;
+
+/// Runs f, adding one call and its wall time to the given counters
+template <typename F>
+void Timed(std::atomic<int64_t>* num_evals, std::atomic<int64_t>* nanoseconds,
+           const F& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto finish = std::chrono::steady_clock::now();
+  num_evals->fetch_add(1, std::memory_order_relaxed);
+  nanoseconds->fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start)
+          .count(),
+      std::memory_order_relaxed);
+}
+
+/// Forwards to a wrapped constraint, counting and timing each evaluation
+class ProfiledConstraint : public Constraint {
+ public:
+  ProfiledConstraint(std::shared_ptr<Constraint> constraint,
+                     std::shared_ptr<Counters> counters)
+      : Constraint(constraint->num_constraints(), constraint->num_vars(),
+                   constraint->lower_bound(), constraint->upper_bound(),
+                   constraint->get_description()),
+        constraint_(std::move(constraint)),
+        counters_(std::move(counters)) {
+    if (constraint_->gradient_sparsity_pattern().has_value()) {
+      SetGradientSparsityPattern(
+          constraint_->gradient_sparsity_pattern().value());
+    }
+  }
+
+ private:
+  void DoEval(const Eigen::Ref<const VectorXd>& x,
+              VectorXd* y) const override {
+    Timed(&counters_->num_value_evals, &counters_->value_nanoseconds,
+          [&]() { constraint_->Eval(x, y); });
+  }
+
+  void DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
+              AutoDiffVecXd* y) const override {
+    Timed(&counters_->num_gradient_evals, &counters_->gradient_nanoseconds,
+          [&]() { constraint_->Eval(x, y); });
+  }
+
+  void DoEval(const Eigen::Ref<const VectorX<Variable>>& x,
+              VectorX<Expression>* y) const override {
+    constraint_->Eval(x, y);
+  }
+
+  std::shared_ptr<Constraint> constraint_;
+  std::shared_ptr<Counters> counters_;
+};
+
+/// Forwards to a wrapped cost, counting and timing each evaluation
+class ProfiledCost : public Cost {
+ public:
+  ProfiledCost(std::shared_ptr<Cost> cost, std::shared_ptr<Counters> counters)
+      : Cost(cost->num_vars(), cost->get_description()),
+        cost_(std::move(cost)),
+        counters_(std::move(counters)) {
+    if (cost_->gradient_sparsity_pattern().has_value()) {
+      SetGradientSparsityPattern(cost_->gradient_sparsity_pattern().value());
+    }
+  }
+
+ private:
+  void DoEval(const Eigen::Ref<const VectorXd>& x,
+              VectorXd* y) const override {
+    Timed(&counters_->num_value_evals, &counters_->value_nanoseconds,
+          [&]() { cost_->Eval(x, y); });
+  }
+
+  void DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
+              AutoDiffVecXd* y) const override {
+    Timed(&counters_->num_gradient_evals, &counters_->gradient_nanoseconds,
+          [&]() { cost_->Eval(x, y); });
+  }
+
+  void DoEval(const Eigen::Ref<const VectorX<Variable>>& x,
+              VectorX<Expression>* y) const override {
+    cost_->Eval(x, y);
+  }
+
+  std::shared_ptr<Cost> cost_;
+  std::shared_ptr<Counters> counters_;
+};
+
+EvaluationProfile MakeProfile(const std::string& name, bool is_cost,
+                              const Counters& counters) {
+  EvaluationProfile profile;
+  profile.name = name;
+  profile.is_cost = is_cost;
+  profile.num_bindings = 1;
+  profile.num_value_evals = counters.num_value_evals;
+  profile.num_gradient_evals = counters.num_gradient_evals;
+  profile.value_time = 1e-9 * counters.value_nanoseconds;
+  profile.gradient_time = 1e-9 * counters.gradient_nanoseconds;
+  return profile;
+}
+
+void SortByTotalTime(std::vector<EvaluationProfile>* profiles) {
+  std::stable_sort(profiles->begin(), profiles->end(),
+                   [](const EvaluationProfile& a, const EvaluationProfile& b) {
+                     return a.total_time() > b.total_time();
+                   });
+}
+
+std::string JsonEscape(const std::string& s) {
+  std::string escaped;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void WriteJsonProfiles(std::ostream& out,
+                       const std::vector<EvaluationProfile>& profiles) {
+  out << "[";
+  for (size_t i = 0; i < profiles.size(); i++) {
+    const auto& p = profiles[i];
+    out << (i > 0 ? "," : "") << "\n    {\"name\": \"" << JsonEscape(p.name)
+        << "\", \"type\": \"" << (p.is_cost ? "cost" : "constraint")
+        << "\", \"num_bindings\": " << p.num_bindings
+        << ", \"num_value_evals\": " << p.num_value_evals
+        << ", \"num_gradient_evals\": " << p.num_gradient_evals
+        << ", \"value_time\": " << p.value_time
+        << ", \"gradient_time\": " << p.gradient_time << "}";
+  }
+  out << "\n  ]";
+}
+
+void PrintProfiles(std::ostream& out,
+                   const std::vector<EvaluationProfile>& profiles,
+                   int max_rows) {
+  out << std::left << std::setw(40) << "name" << std::right << std::setw(8)
+      << "count" << std::setw(12) << "value" << std::setw(12) << "gradient"
+      << std::setw(12) << "value(s)" << std::setw(12) << "grad(s)"
+      << std::setw(12) << "total(s)" << std::endl;
+  int rows = std::min(max_rows, static_cast<int>(profiles.size()));
+  for (int i = 0; i < rows; i++) {
+    const auto& p = profiles[i];
+    std::string name = (p.is_cost ? "(cost) " : "") + p.name;
+    out << std::left << std::setw(40) << name.substr(0, 39) << std::right
+        << std::setw(8) << p.num_bindings << std::setw(12)
+        << p.num_value_evals << std::setw(12) << p.num_gradient_evals
+        << std::setw(12) << p.value_time << std::setw(12) << p.gradient_time
+        << std::setw(12) << p.total_time() << std::endl;
+  }
+}
+
+}  // namespace
+
+ProgramProfiler::ProgramProfiler(const MathematicalProgram& prog)
+    : prog_(std::make_unique<MathematicalProgram>()) {
+  DRAKE_DEMAND(prog.lorentz_cone_constraints().empty());
+  DRAKE_DEMAND(prog.rotated_lorentz_cone_constraints().empty());
+  DRAKE_DEMAND(prog.positive_semidefinite_constraints().empty());
+  DRAKE_DEMAND(prog.linear_matrix_inequality_constraints().empty());
+  DRAKE_DEMAND(prog.linear_complementarity_constraints().empty());
+
+  prog_->AddDecisionVariables(prog.decision_variables());
+
+  for (const auto& binding : prog.generic_constraints()) {
+    auto counters = std::make_shared<Counters>();
+    bindings_.push_back(
+        {binding.evaluator()->get_description(), false, counters});
+    prog_->AddConstraint(
+        std::make_shared<ProfiledConstraint>(binding.evaluator(), counters),
+        binding.variables());
+  }
+  for (const auto& binding : prog.linear_equality_constraints()) {
+    prog_->AddConstraint(binding);
+  }
+  for (const auto& binding : prog.linear_constraints()) {
+    prog_->AddConstraint(binding);
+  }
+  for (const auto& binding : prog.bounding_box_constraints()) {
+    prog_->AddConstraint(binding);
+  }
+
+  for (const auto& binding : prog.generic_costs()) {
+    auto counters = std::make_shared<Counters>();
+    bindings_.push_back(
+        {binding.evaluator()->get_description(), true, counters});
+    prog_->AddCost(
+        std::make_shared<ProfiledCost>(binding.evaluator(), counters),
+        binding.variables());
+  }
+  for (const auto& binding : prog.linear_costs()) {
+    prog_->AddCost(binding);
+  }
+  for (const auto& binding : prog.quadratic_costs()) {
+    prog_->AddCost(binding);
+  }
+
+  for (const auto& binding : prog.visualization_callbacks()) {
+    auto callback = binding.evaluator();
+    prog_->AddVisualizationCallback(
+        [callback](const Eigen::Ref<const VectorXd>& x) {
+          callback->EvalCallback(x);
+        },
+        binding.variables());
+  }
+
+  prog_->SetInitialGuessForAllVariables(prog.initial_guess());
+  prog_->SetSolverOptions(prog.solver_options());
+  for (const auto& [index, scale] : prog.GetVariableScaling()) {
+    prog_->SetVariableScaling(prog.decision_variable(index), scale);
+  }
+}
+
+void ProgramProfiler::Reset() {
+  for (auto& binding : bindings_) {
+    binding.counters->num_value_evals = 0;
+    binding.counters->num_gradient_evals = 0;
+    binding.counters->value_nanoseconds = 0;
+    binding.counters->gradient_nanoseconds = 0;
+  }
+}
+
+std::string ProgramProfiler::GroupName(const std::string& description) {
+  return GroupDescription(description);
+}
+
+std::vector<EvaluationProfile> ProgramProfiler::GetBindingProfiles() const {
+  std::vector<EvaluationProfile> profiles;
+  for (const auto& binding : bindings_) {
+    profiles.push_back(
+        MakeProfile(binding.description, binding.is_cost, *binding.counters));
+  }
+  SortByTotalTime(&profiles);
+  return profiles;
+}
+
+std::vector<EvaluationProfile> ProgramProfiler::GetGroupProfiles() const {
+  // Costs and constraints with the same description are separate groups
+  std::map<std::pair<bool, std::string>, EvaluationProfile> groups;
+  for (const auto& binding : bindings_) {
+    std::string name = GroupName(binding.description);
+    auto profile = MakeProfile(name, binding.is_cost, *binding.counters);
+    auto [it, inserted] =
+        groups.emplace(std::make_pair(binding.is_cost, name), profile);
+    if (!inserted) {
+      EvaluationProfile& group = it->second;
+      group.num_bindings++;
+      group.num_value_evals += profile.num_value_evals;
+      group.num_gradient_evals += profile.num_gradient_evals;
+      group.value_time += profile.value_time;
+      group.gradient_time += profile.gradient_time;
+    }
+  }
+  std::vector<EvaluationProfile> profiles;
+  for (const auto& [key, group] : groups) {
+    profiles.push_back(group);
+  }
+  SortByTotalTime(&profiles);
+  return profiles;
+}
+
+void ProgramProfiler::PrintReport(std::ostream& out, int max_bindings) const {
+  auto groups = GetGroupProfiles();
+  double total = 0;
+  for (const auto& group : groups) {
+    total += group.total_time();
+  }
+  out << "Evaluation time by group (" << total << "s in total):"
+      << std::endl;
+  PrintProfiles(out, groups, groups.size());
+  out << std::endl << "Most expensive bindings:" << std::endl;
+  PrintProfiles(out, GetBindingProfiles(), max_bindings);
+}
+
+void ProgramProfiler::WriteJson(const std::string& filepath) const {
+  std::ofstream out(filepath);
+  if (!out) {
+    std::cerr << "Could not open file: " << filepath << std::endl;
+    return;
+  }
+  out << "{\n  \"groups\": ";
+  WriteJsonProfiles(out, GetGroupProfiles());
+  out << ",\n  \"bindings\": ";
+  WriteJsonProfiles(out, GetBindingProfiles());
+  out << "\n}\n";
+}
+
+}  // namespace solvers
+}  // namespace dairlib
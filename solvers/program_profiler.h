@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/solvers/mathematical_program.h"
+
+namespace dairlib {
+namespace solvers {
+
+/// Evaluation statistics of one binding, or of a group of bindings
+struct EvaluationProfile {
+  /// The binding description, or the group name for groups
+  std::string name;
+  bool is_cost = false;
+  int num_bindings = 0;
+  /// Evaluations with double arguments (values only)
+  int64_t num_value_evals = 0;
+  /// Evaluations with AutoDiff arguments (values and gradients)
+  int64_t num_gradient_evals = 0;
+  /// Wall time, in seconds
+  double value_time = 0;
+  double gradient_time = 0;
+
+  double total_time() const { return value_time + gradient_time; }
+};
+
+/// ProgramProfiler measures how often, and for how long, each cost and
+/// constraint of a MathematicalProgram is evaluated by a solver.
+///
+/// The profiler builds a copy of the program in which every generic cost and
+/// constraint is wrapped by an evaluator that counts and times calls to Eval,
+/// separately for value (double) and gradient (AutoDiff) evaluations. Linear,
+/// quadratic and bounding box bindings are copied unchanged, so that the
+/// solver sees the same problem structure. The copy shares the decision
+/// variables of the original, so its solution can be read with the original
+/// program's variables (e.g. through Dircon accessors).
+///
+/// Profiling only affects the copy. When it is not constructed, the original
+/// program is solved exactly as before, at no cost.
+///
+/// Statistics are reported per binding and per group. Bindings are grouped by
+/// description, with any bracketed indices replaced by [*], so that for
+/// instance all "collocation[i][j]" constraints are reported together as
+/// "collocation[*]".
+///
+/// Typical usage:
+///   std::unique_ptr<ProgramProfiler> profiler;
+///   if (FLAGS_profile) {
+///     profiler = std::make_unique<ProgramProfiler>(trajopt);
+///   }
+///   solver->Solve(profiler ? profiler->get_prog() : trajopt, ...);
+///   if (profiler) profiler->PrintReport();
+class ProgramProfiler {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(ProgramProfiler)
+
+  /// Copies prog, including its initial guess, solver options, variable
+  /// scaling and visualization callbacks. Later changes to prog are not
+  /// reflected in the copy.
+  explicit ProgramProfiler(const drake::solvers::MathematicalProgram& prog);
+
+  /// The profiled copy of the program, to pass to the solver
+  const drake::solvers::MathematicalProgram& get_prog() const {
+    return *prog_;
+  }
+
+  /// Clears all counters
+  void Reset();
+
+  /// Statistics of every profiled binding, ranked by total time
+  std::vector<EvaluationProfile> GetBindingProfiles() const;
+
+  /// Statistics of every group of bindings, ranked by total time
+  std::vector<EvaluationProfile> GetGroupProfiles() const;
+
+  /// Prints the groups, ranked by total time, followed by the max_bindings
+  /// most expensive individual bindings
+  void PrintReport(std::ostream& out = std::cout, int max_bindings = 10) const;
+
+  /// Writes the binding and group profiles to a JSON file
+  void WriteJson(const std::string& filepath) const;
+
+  /// Group name of a binding description, see GroupDescription
+  static std::string GroupName(const std::string& description);
+
+  /// Counters shared with the wrapped evaluators. Atomic, so that bindings may
+  /// be evaluated concurrently.
+  struct Counters {
+    std::atomic<int64_t> num_value_evals{0};
+    std::atomic<int64_t> num_gradient_evals{0};
+    std::atomic<int64_t> value_nanoseconds{0};
+    std::atomic<int64_t> gradient_nanoseconds{0};
+  };
+
+ private:
+  struct ProfiledBinding {
+    std::string description;
+    bool is_cost;
+    std::shared_ptr<Counters> counters;
+  };
+
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+  std::vector<ProfiledBinding> bindings_;
+};
+
+}  // namespace solvers
+}  // namespace dairlib
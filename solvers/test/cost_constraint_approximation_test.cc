@@ -102,6 +102,76 @@ TEST_F(CostConstraintApproximationTest, QPTest) {
   EXPECT_EQ(ub_o, ub_a);
 }
 
+TEST_F(CostConstraintApproximationTest, SparseMatchesDenseTest) {
+  MathematicalProgram prog;
+  auto w = prog.NewContinuousVariables(4, "w");
+  MatrixXd A_o(2, 2);
+  A_o <<  0.411647, -0.164777,
+         -0.302449, 0.26823;
+  prog.AddLinearConstraint(A_o, 0.5 * VectorXd::Ones(2), VectorXd::Ones(2),
+                           w.head(2));
+  prog.AddBoundingBoxConstraint(-1, 1, w(3));
+  prog.AddConstraint(w(1) * w(2) + w(3) * w(3) <= 2);
+  prog.AddQuadraticCost(MatrixXd::Identity(2, 2), VectorXd::Ones(2),
+                        w.tail(2));
+  prog.AddLinearCost(w(0) + 2 * w(2));
+  prog.AddCost(w(0) * w(0) * w(1) + w(2) * w(2) * w(2) * w(2));
+
+  VectorXd x(4);
+  x << 0.3, -0.7, 1.2, 0.4;
+
+  VectorXd y_d, lb_d, ub_d, w_d;
+  MatrixXd A_d, Q_d;
+  LinearizeConstraints(prog, x, &y_d, &A_d, &lb_d, &ub_d);
+  double c_d = SecondOrderCost(prog, x, &Q_d, &w_d);
+
+  for (int num_threads : {1, 3}) {
+    VectorXd y_s, lb_s, ub_s, w_s;
+    Eigen::SparseMatrix<double> A_s, Q_s;
+    LinearizeConstraints(prog, x, &y_s, &A_s, &lb_s, &ub_s, num_threads);
+    double c_s = SecondOrderCost(prog, x, &Q_s, &w_s, 1e-8, num_threads);
+
+    EXPECT_TRUE(CompareMatrices(y_d, y_s, 1e-12));
+    EXPECT_TRUE(CompareMatrices(A_d, MatrixXd(A_s), 1e-12));
+    EXPECT_EQ(lb_d, lb_s);
+    EXPECT_EQ(ub_d, ub_s);
+    EXPECT_NEAR(c_d, c_s, 1e-12);
+    EXPECT_TRUE(CompareMatrices(w_d, w_s, 1e-12));
+    // The dense version differentiates quadratic costs numerically
+    EXPECT_TRUE(CompareMatrices(Q_d, MatrixXd(Q_s), 1e-5));
+  }
+}
+
+TEST_F(CostConstraintApproximationTest, ConstraintViolationTest) {
+  MathematicalProgram prog;
+  auto w = prog.NewContinuousVariables(3, "w");
+  auto c0 = prog.AddConstraint(w(0) * w(1) <= 1);
+  c0.evaluator()->set_description("product[0]");
+  auto c1 = prog.AddConstraint(w(1) * w(2) <= 1);
+  c1.evaluator()->set_description("product[1]");
+  prog.AddBoundingBoxConstraint(-1, 1, w);
+
+  VectorXd x(3);
+  x << 1, 3, 2;
+  for (int num_threads : {1, 2}) {
+    auto report = EvaluateConstraintViolations(prog, x, true, num_threads);
+    ASSERT_EQ(report.bindings.size(), 2);
+    EXPECT_DOUBLE_EQ(report.bindings[0].max_violation, 2);
+    EXPECT_DOUBLE_EQ(report.bindings[1].max_violation, 5);
+    ASSERT_EQ(report.groups.size(), 1);
+    EXPECT_EQ(report.groups[0].description, "product[*]");
+    EXPECT_EQ(report.groups[0].num_bindings, 2);
+    EXPECT_DOUBLE_EQ(report.groups[0].l2_violation, std::sqrt(29.0));
+    EXPECT_DOUBLE_EQ(report.max_violation, 5);
+    EXPECT_FALSE(report.is_satisfied());
+  }
+
+  // The bounding box is only checked when all constraints are requested
+  auto report = EvaluateConstraintViolations(prog, x, false);
+  EXPECT_EQ(report.bindings.size(), 3);
+  EXPECT_DOUBLE_EQ(report.max_violation, 5);
+}
+
 }  // namespace
 }  // namespace solvers
 }  // namespace dairlib
@@ -0,0 +1,88 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "solvers/nonlinear_cost.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::VectorX;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// Sum over i of sin(x_i * x_{i+1}), with a term per pair of neighbours
+class ChainCost : public NonlinearCost<double> {
+ public:
+  explicit ChainCost(int num_vars) : NonlinearCost<double>(num_vars) {}
+
+  void EvaluateCost(const Eigen::Ref<const VectorXd>& x,
+                    VectorXd* y) const override {
+    VectorXd terms;
+    EvaluateCostTerms(x, &terms);
+    *y = VectorXd::Constant(1, terms.sum());
+  }
+
+  void EvaluateCostTerms(const Eigen::Ref<const VectorXd>& x,
+                         VectorXd* terms) const override {
+    *terms = VectorXd(x.size() - 1);
+    for (int i = 0; i < x.size() - 1; i++) {
+      (*terms)(i) = std::sin(x(i) * x(i + 1));
+    }
+  }
+};
+
+class NonlinearCostTest : public ::testing::Test {};
+
+MatrixXd Gradient(const ChainCost& cost, const VectorXd& x) {
+  AutoDiffVecXd y;
+  cost.Eval(drake::math::initializeAutoDiff(x), &y);
+  return drake::math::autoDiffToGradientMatrix(y);
+}
+
+TEST_F(NonlinearCostTest, DifferencingOptionsTest) {
+  const int n = 9;
+  VectorXd x = VectorXd::LinSpaced(n, -1, 1);
+
+  MatrixXd expected = MatrixXd::Zero(1, n);
+  for (int i = 0; i < n - 1; i++) {
+    double c = std::cos(x(i) * x(i + 1));
+    expected(0, i) += c * x(i + 1);
+    expected(0, i + 1) += c * x(i);
+  }
+
+  ChainCost serial(n);
+  EXPECT_TRUE(drake::CompareMatrices(Gradient(serial, x), expected, 1e-6));
+
+  ChainCost threaded(n);
+  threaded.SetNumDifferencingThreads(4);
+  EXPECT_TRUE(drake::CompareMatrices(Gradient(threaded, x), expected, 1e-6));
+
+  // The last variable is ignored
+  ChainCost dependent(n);
+  dependent.SetDependentVariables({0, 1, 2, 3, 4, 5, 6, 7});
+  MatrixXd truncated = expected;
+  truncated(0, n - 1) = 0;
+  EXPECT_TRUE(drake::CompareMatrices(Gradient(dependent, x), truncated, 1e-6));
+
+  // Neighbouring variables share a term, so two colors suffice
+  std::vector<std::vector<int>> term_variables;
+  for (int i = 0; i < n - 1; i++) {
+    term_variables.push_back({i, i + 1});
+  }
+  for (int num_threads : {1, 2}) {
+    ChainCost colored(n);
+    colored.SetCostTerms(term_variables);
+    colored.SetNumDifferencingThreads(num_threads);
+    EXPECT_TRUE(drake::CompareMatrices(Gradient(colored, x), expected, 1e-6));
+  }
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
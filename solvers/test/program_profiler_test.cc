@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "drake/math/autodiff.h"
+#include "drake/solvers/mathematical_program.h"
+#include "solvers/program_profiler.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::solvers::MathematicalProgram;
+using Eigen::VectorXd;
+
+class ProgramProfilerTest : public ::testing::Test {};
+
+TEST_F(ProgramProfilerTest, GroupNameTest) {
+  EXPECT_EQ(ProgramProfiler::GroupName("collocation[0][12]"),
+            "collocation[*]");
+  EXPECT_EQ(ProgramProfiler::GroupName("kinematic_position[1][3]"),
+            "kinematic_position[*]");
+  EXPECT_EQ(ProgramProfiler::GroupName("work_cost"), "work_cost");
+  EXPECT_EQ(ProgramProfiler::GroupName(""), "(no description)");
+}
+
+TEST_F(ProgramProfilerTest, CountTest) {
+  MathematicalProgram prog;
+  auto w = prog.NewContinuousVariables(3, "w");
+  auto c0 = prog.AddConstraint(w(0) * w(1) <= 1);
+  c0.evaluator()->set_description("product[0]");
+  auto c1 = prog.AddConstraint(w(1) * w(2) <= 1);
+  c1.evaluator()->set_description("product[1]");
+  auto cost = prog.AddCost(w(0) * w(0) * w(0) * w(2));
+  cost.evaluator()->set_description("cubic");
+  prog.AddBoundingBoxConstraint(-1, 1, w);
+
+  ProgramProfiler profiler(prog);
+  const auto& profiled = profiler.get_prog();
+  EXPECT_EQ(profiled.num_vars(), prog.num_vars());
+  EXPECT_EQ(profiled.generic_constraints().size(), 2);
+  EXPECT_EQ(profiled.bounding_box_constraints().size(), 1);
+
+  VectorXd x = VectorXd::Ones(3);
+  auto x_ad = drake::math::initializeAutoDiff(x);
+  for (int i = 0; i < 3; i++) {
+    profiled.EvalBinding(profiled.generic_constraints()[0], x);
+    profiled.EvalBinding(profiled.generic_costs()[0], x);
+  }
+  profiled.EvalBinding(profiled.generic_constraints()[1], x_ad);
+
+  auto groups = profiler.GetGroupProfiles();
+  ASSERT_EQ(groups.size(), 2);
+  for (const auto& group : groups) {
+    if (group.is_cost) {
+      EXPECT_EQ(group.name, "cubic");
+      EXPECT_EQ(group.num_bindings, 1);
+      EXPECT_EQ(group.num_value_evals, 3);
+    } else {
+      EXPECT_EQ(group.name, "product[*]");
+      EXPECT_EQ(group.num_bindings, 2);
+      EXPECT_EQ(group.num_value_evals, 3);
+      EXPECT_EQ(group.num_gradient_evals, 1);
+    }
+  }
+
+  profiler.Reset();
+  for (const auto& binding : profiler.GetBindingProfiles()) {
+    EXPECT_EQ(binding.num_value_evals, 0);
+    EXPECT_EQ(binding.num_gradient_evals, 0);
+  }
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
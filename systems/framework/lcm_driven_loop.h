@@ -1,10 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <fstream>
+#include <iostream>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "dairlib/lcmt_controller_switch.hpp"
+#include "lcm/lcm-cpp.hpp"
+#include "systems/framework/pipeline_tracer.h"
+#include "systems/framework/realtime.h"
 
 #include "drake/lcm/drake_lcm.h"
 #include "drake/systems/analysis/simulator.h"
@@ -46,7 +52,23 @@ namespace systems {
 /// 1. construct LcmDrivenLoop
 /// 2. (if it's multi-input) the user can set the initial channel that
 ///    LcmDrivenLoop listens to by calling SetInitActiveChannel().
-/// 3. run Simulate()
+/// 3. (optionally) enable the real-time mode with set_realtime_options(), and
+///    the tracing of input messages through the pipeline with EnableTracing()
+/// 4. run Simulate()
+
+/// In real-time mode, Simulate() first configures its thread and process as
+/// given by RealtimeOptions, and then waits for messages on the LCM file
+/// descriptor itself, sleeping in poll() or spinning on it (other transports
+/// than DrakeLcm, such as SharedMemoryLcm, wait in HandleSubscriptions()
+/// instead, with a zero timeout to spin). With
+/// record_latency, every iteration records its wake-up latency, from the
+/// kernel receiving the input message to the loop handling it, and its compute
+/// time, from the loop waking up on the input message to the end of the
+/// diagram update and publish. The wake-up latency is only known for DrakeLcm,
+/// whose UDP multicast provider stamps every message with its kernel receive
+/// time (SO_TIMESTAMP). SIGINT and SIGTERM then stop the loop, and the
+/// histograms are printed and written to latency_file before Simulate()
+/// returns.
 
 /// Note that we implement the class only in the header file because we don't
 /// know what MessageTypes are beforehand.
@@ -60,13 +82,13 @@ class LcmDrivenLoop {
   DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(LcmDrivenLoop)
 
   /// Constructor for single-input LcmDrivenLoop
-  ///     @param drake_lcm DrakeLcm
+  ///     @param drake_lcm The LCM transport, e.g. DrakeLcm or SharedMemoryLcm
   ///     @param diagram A Drake diagram
   ///     @param lcm_parser The LeafSystem of the diagram that parses the
   ///     incoming lcm message
   ///     @param input_channel The name of the input channel
   ///     @param is_forced_publish A flag which enables publishing via diagram.
-  LcmDrivenLoop(drake::lcm::DrakeLcm* drake_lcm,
+  LcmDrivenLoop(drake::lcm::DrakeLcmInterface* drake_lcm,
                 std::unique_ptr<drake::systems::Diagram<double>> diagram,
                 const drake::systems::LeafSystem<double>* lcm_parser,
                 const std::string& input_channel, bool is_forced_publish)
@@ -75,7 +97,7 @@ class LcmDrivenLoop {
                       "", is_forced_publish){};
 
   /// Constructor for multi-input LcmDrivenLoop
-  ///     @param drake_lcm DrakeLcm
+  ///     @param drake_lcm The LCM transport, e.g. DrakeLcm or SharedMemoryLcm
   ///     @param diagram A Drake diagram
   ///     @param lcm_parser The LeafSystem of the diagram that parses the
   ///     incoming lcm message
@@ -83,7 +105,7 @@ class LcmDrivenLoop {
   ///     @param active_channel The name of the initial active input channel
   ///     @param switch_channel The name of the switch channel
   ///     @param is_forced_publish A flag which enables publishing via diagram.
-  LcmDrivenLoop(drake::lcm::DrakeLcm* drake_lcm,
+  LcmDrivenLoop(drake::lcm::DrakeLcmInterface* drake_lcm,
                 std::unique_ptr<drake::systems::Diagram<double>> diagram,
                 const drake::systems::LeafSystem<double>* lcm_parser,
                 std::vector<std::string> input_channels,
@@ -130,12 +152,12 @@ class LcmDrivenLoop {
   };
 
   /// Constructor for single-input LcmDrivenLoop without lcm_parser
-  ///     @param drake_lcm DrakeLcm
+  ///     @param drake_lcm The LCM transport, e.g. DrakeLcm or SharedMemoryLcm
   ///     @param diagram A Drake diagram
   ///     @param input_channel The name of the input channel
   ///     @param is_forced_publish A flag which enables publishing via diagram.
   /// The use case is that the user only need the time from lcm message.
-  LcmDrivenLoop(drake::lcm::DrakeLcm* drake_lcm,
+  LcmDrivenLoop(drake::lcm::DrakeLcmInterface* drake_lcm,
                 std::unique_ptr<drake::systems::Diagram<double>> diagram,
                 const std::string& input_channel, bool is_forced_publish)
       : LcmDrivenLoop(drake_lcm, std::move(diagram), nullptr,
@@ -148,16 +170,54 @@ class LcmDrivenLoop {
     return simulator_->get_mutable_context();
   }
 
+  /// Enables the real-time mode of Simulate()
+  void set_realtime_options(const RealtimeOptions& options) {
+    realtime_options_ = options;
+    is_realtime_ = true;
+  }
+
+  /// Publishes, for every input message, the times at which it was received
+  /// and the diagram finished its update and publish, as the given stage of
+  /// the pipeline. See PipelineTracer.
+  void EnableTracing(const std::string& stage,
+                     const std::string& channel = "PIPELINE_TRACE") {
+    tracer_ = std::make_unique<PipelineTracer>(drake_lcm_, stage, channel);
+  }
+
+  const LatencyHistogram& get_wakeup_latency() const {
+    return wakeup_latency_;
+  }
+  const LatencyHistogram& get_compute_time() const { return compute_time_; }
+
   // Start simulating the diagram
   void Simulate(double end_time = std::numeric_limits<double>::infinity()) {
     // Get mutable contexts
     auto& diagram_context = simulator_->get_mutable_context();
 
+    // Raw subscriptions to the input channels, for their receive times
+    std::vector<::lcm::Subscription*> receive_time_subs;
+    if (is_realtime_) {
+      ConfigureRealtimeThread(realtime_options_);
+      if (realtime_options_.record_latency) {
+        InstallStopSignalHandlers();
+        auto udp_lcm = dynamic_cast<drake::lcm::DrakeLcm*>(drake_lcm_);
+        if (udp_lcm != nullptr) {
+          for (const auto& [name, sub] : name_to_input_sub_map_) {
+            receive_time_subs.push_back(
+                udp_lcm->get_lcm_instance()->subscribe(
+                    name, &LcmDrivenLoop::HandleReceiveTime, this));
+          }
+        }
+      }
+    }
+
     // Wait for the first message.
     drake::log()->info("Waiting for first lcm input message");
-    LcmHandleSubscriptionsUntil(drake_lcm_, [&]() {
-      return name_to_input_sub_map_.at(active_channel_).count() > 0;
-    });
+    if (!HandleSubscriptionsUntil([&]() {
+          return name_to_input_sub_map_.at(active_channel_).count() > 0;
+        })) {
+      return;
+    }
 
     // Initialize the context time.
     const double t0 =
@@ -192,20 +252,27 @@ class LcmDrivenLoop {
       // Wait for new InputMessageType messages and SwitchMessageType messages.
       bool is_new_input_message = false;
       bool is_new_switch_message = false;
-      LcmHandleSubscriptionsUntil(drake_lcm_, [&]() {
-        if (name_to_input_sub_map_.at(active_channel_).count() > 0) {
-          is_new_input_message = true;
-        }
-        if (switch_sub_ != nullptr) {
-          if (switch_sub_->count() > 0) {
-            is_new_switch_message = true;
-          }
-        }
-        return is_new_input_message || is_new_switch_message;
-      });
+      if (!HandleSubscriptionsUntil([&]() {
+            if (name_to_input_sub_map_.at(active_channel_).count() > 0) {
+              is_new_input_message = true;
+            }
+            if (switch_sub_ != nullptr) {
+              if (switch_sub_->count() > 0) {
+                is_new_switch_message = true;
+              }
+            }
+            return is_new_input_message || is_new_switch_message;
+          })) {
+        break;
+      }
 
       // Update the diagram context when there is new input message
       if (is_new_input_message) {
+        if (tracer_ != nullptr) {
+          tracer_->Receive(
+              name_to_input_sub_map_.at(active_channel_).message().utime);
+        }
+
         // Write the InputMessageType message into the context if lcm_parser is
         // provided
         if (lcm_parser_ != nullptr) {
@@ -237,8 +304,22 @@ class LcmDrivenLoop {
           diagram_ptr_->Publish(diagram_context);
         }
 
+        if (tracer_ != nullptr) {
+          tracer_->Publish();
+        }
+
         // Clear messages in the current input channel
         name_to_input_sub_map_.at(active_channel_).clear();
+
+        if (is_realtime_ && realtime_options_.record_latency) {
+          if (wakeup_latency_seconds_ >= 0) {
+            wakeup_latency_.Add(wakeup_latency_seconds_);
+            wakeup_latency_seconds_ = -1;
+          }
+          compute_time_.Add(std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - wake_time_)
+                                .count());
+        }
       }
 
       // Update the name of the active channel if there are multiple inputs and
@@ -276,10 +357,80 @@ class LcmDrivenLoop {
       }
       previous_active_channel_name = active_channel_;
     }
+
+    if (is_realtime_ && realtime_options_.record_latency) {
+      for (auto* sub : receive_time_subs) {
+        dynamic_cast<drake::lcm::DrakeLcm*>(drake_lcm_)
+            ->get_lcm_instance()
+            ->unsubscribe(sub);
+      }
+      ReportLatency();
+    }
   };
 
  private:
-  drake::lcm::DrakeLcm* drake_lcm_;
+  /// Handles LCM messages until finished() returns true. Returns false if
+  /// the real-time mode was asked to stop.
+  template <typename F>
+  bool HandleSubscriptionsUntil(F finished) {
+    if (!is_realtime_) {
+      LcmHandleSubscriptionsUntil(drake_lcm_, finished);
+      return true;
+    }
+    auto udp_lcm = dynamic_cast<drake::lcm::DrakeLcm*>(drake_lcm_);
+    if (udp_lcm == nullptr) {
+      // Other transports, such as SharedMemoryLcm, wait on their own
+      const int timeout_millis = realtime_options_.busy_poll ? 0 : 100;
+      while (!finished()) {
+        if (IsStopRequested()) {
+          return false;
+        }
+        if (drake_lcm_->HandleSubscriptions(timeout_millis) > 0) {
+          wake_time_ = std::chrono::steady_clock::now();
+        }
+      }
+      return true;
+    }
+    const int fd = udp_lcm->get_lcm_instance()->getFileno();
+    while (!finished()) {
+      if (IsStopRequested()) {
+        return false;
+      }
+      if (WaitForReadable(fd, realtime_options_.busy_poll)) {
+        wake_time_ = std::chrono::steady_clock::now();
+        drake_lcm_->HandleSubscriptions(0);
+      }
+    }
+    return true;
+  }
+
+  /// Records the wake-up latency of a message of the active input channel,
+  /// from its kernel receive time, in microseconds of the system clock
+  void HandleReceiveTime(const ::lcm::ReceiveBuffer* buffer,
+                         const std::string& channel) {
+    if (channel == active_channel_) {
+      const int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+      wakeup_latency_seconds_ = 1e-6 * (now - buffer->recv_utime);
+    }
+  }
+
+  void ReportLatency() const {
+    wakeup_latency_.PrintSummary(diagram_name_ + " wake-up latency",
+                                 std::cout);
+    compute_time_.PrintSummary(diagram_name_ + " compute time", std::cout);
+    if (!realtime_options_.latency_file.empty()) {
+      std::ofstream out(realtime_options_.latency_file);
+      wakeup_latency_.Write("wake-up latency", out);
+      compute_time_.Write("compute time", out);
+      if (!out) {
+        drake::log()->warn("Could not write " +
+                           realtime_options_.latency_file);
+      }
+    }
+  }
+
+  drake::lcm::DrakeLcmInterface* drake_lcm_;
   drake::systems::Diagram<double>* diagram_ptr_;
   const drake::systems::LeafSystem<double>* lcm_parser_;
   std::unique_ptr<drake::systems::Simulator<double>> simulator_;
@@ -292,6 +443,15 @@ class LcmDrivenLoop {
       name_to_input_sub_map_;
 
   bool is_forced_publish_;
+
+  bool is_realtime_ = false;
+  RealtimeOptions realtime_options_;
+  LatencyHistogram wakeup_latency_;
+  LatencyHistogram compute_time_;
+  std::chrono::steady_clock::time_point wake_time_;
+  double wakeup_latency_seconds_ = -1;
+
+  std::unique_ptr<PipelineTracer> tracer_;
 };
 
 }  // namespace systems
@@ -0,0 +1,38 @@
+#include "systems/framework/pipeline_tracer.h"
+
+#include <chrono>
+
+namespace dairlib {
+namespace systems {
+
+PipelineTracer::PipelineTracer(drake::lcm::DrakeLcmInterface* lcm,
+                               const std::string& stage,
+                               const std::string& channel)
+    : lcm_(lcm), channel_(channel) {
+  trace_.utime = 0;
+  trace_.stage = stage;
+  trace_.receive_time = 0;
+  trace_.publish_time = 0;
+  // The stage is the only variable-length field, so the size is fixed
+  buffer_.resize(trace_.getEncodedSize());
+}
+
+void PipelineTracer::Receive(int64_t utime, int64_t receive_time) {
+  trace_.utime = utime;
+  trace_.receive_time = receive_time;
+}
+
+void PipelineTracer::Publish() {
+  trace_.publish_time = Now();
+  trace_.encode(buffer_.data(), 0, buffer_.size());
+  lcm_->Publish(channel_, buffer_.data(), buffer_.size(), {});
+}
+
+int64_t PipelineTracer::Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dairlib/lcmt_pipeline_trace.hpp"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/lcm/drake_lcm_interface.h"
+
+namespace dairlib {
+namespace systems {
+
+/// PipelineTracer publishes, for one stage of the control pipeline (e.g.
+/// dispatcher_robot_out, a controller or dispatcher_robot_in), the times at
+/// which each message was received and its result published, as
+/// lcmt_pipeline_trace on a side channel. Messages are keyed by the utime of
+/// the robot state that they originate from, so that lcm-logger records the
+/// traces of all stages alongside the messages, and pipeline_latency
+/// reconstructs per-message latencies from the log.
+///
+/// Times are taken from std::chrono::steady_clock, which is CLOCK_MONOTONIC
+/// on Linux and thus comparable between processes of the same machine.
+/// Publishing does not allocate.
+class PipelineTracer {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(PipelineTracer)
+
+  PipelineTracer(drake::lcm::DrakeLcmInterface* lcm, const std::string& stage,
+                 const std::string& channel = "PIPELINE_TRACE");
+
+  /// Records that the message of the given utime is received now
+  void Receive(int64_t utime) { Receive(utime, Now()); }
+
+  /// Records that the message of the given utime was received at
+  /// receive_time, in nanoseconds
+  void Receive(int64_t utime, int64_t receive_time);
+
+  /// Records that the result of the last received message is published now,
+  /// and publishes the trace
+  void Publish();
+
+  /// Current time of std::chrono::steady_clock, in nanoseconds
+  static int64_t Now();
+
+ private:
+  drake::lcm::DrakeLcmInterface* lcm_;
+  std::string channel_;
+  lcmt_pipeline_trace trace_;
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,182 @@
+#include "systems/framework/realtime.h"
+
+#include <alloca.h>
+#include <malloc.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#include "drake/common/text_logging.h"
+
+namespace dairlib {
+namespace systems {
+
+namespace {
+
+std::atomic<bool> stop_requested(false);
+
+void HandleStopSignal(int) {
+  if (stop_requested.exchange(true)) {
+    std::_Exit(1);
+  }
+}
+
+std::string ErrorString(int error) { return std::strerror(error); }
+
+/// Touches every page of a stack allocation of the given size. Not inlined,
+/// so that the allocation is released on return.
+__attribute__((noinline)) void PrefaultStack(size_t bytes) {
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+  for (size_t i = 0; i < bytes; i += page_size) {
+    stack[i] = 0;
+  }
+}
+
+void PrefaultHeap(size_t bytes) {
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  char* heap = static_cast<char*>(malloc(bytes));
+  if (heap == nullptr) {
+    drake::log()->warn("Could not allocate {} bytes to prefault", bytes);
+    return;
+  }
+  for (size_t i = 0; i < bytes; i += page_size) {
+    heap[i] = 0;
+  }
+  // Without trimming or mmap, the pages stay in the heap once freed
+  free(heap);
+}
+
+}  // namespace
+
+void ConfigureRealtimeThread(const RealtimeOptions& options) {
+  if (options.lock_memory) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+      drake::log()->warn("mlockall failed: {}", ErrorString(errno));
+    }
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+  }
+  if (options.prefault_heap_bytes > 0) {
+    PrefaultHeap(options.prefault_heap_bytes);
+  }
+  if (options.prefault_stack_bytes > 0) {
+    PrefaultStack(options.prefault_stack_bytes);
+  }
+
+  if (!options.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : options.cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    int error =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (error != 0) {
+      drake::log()->warn("Could not set the CPU affinity: {}",
+                         ErrorString(error));
+    }
+  }
+
+  if (options.priority > 0) {
+    sched_param param;
+    param.sched_priority = options.priority;
+    int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+      drake::log()->warn("Could not set SCHED_FIFO priority {}: {}",
+                         options.priority, ErrorString(error));
+    }
+  }
+}
+
+bool WaitForReadable(int fd, bool busy_poll, int timeout_ms) {
+  pollfd poll_fd = {fd, POLLIN, 0};
+  if (busy_poll) {
+    while (!IsStopRequested()) {
+      int status = poll(&poll_fd, 1, 0);
+      if (status > 0) {
+        return true;
+      }
+      if (status < 0 && errno != EINTR) {
+        return false;
+      }
+    }
+    return false;
+  }
+  return poll(&poll_fd, 1, timeout_ms) > 0;
+}
+
+void InstallStopSignalHandlers() {
+  stop_requested = false;
+  std::signal(SIGINT, HandleStopSignal);
+  std::signal(SIGTERM, HandleStopSignal);
+}
+
+bool IsStopRequested() { return stop_requested; }
+
+LatencyHistogram::LatencyHistogram(double bin_width, int num_bins)
+    : bin_width_(bin_width), bins_(num_bins, 0) {}
+
+void LatencyHistogram::Add(double duration) {
+  if (count_ == 0 || duration < min_) {
+    min_ = duration;
+  }
+  if (count_ == 0 || duration > max_) {
+    max_ = duration;
+  }
+  count_++;
+  sum_ += duration;
+  double bin = duration / bin_width_;
+  if (bin < static_cast<double>(bins_.size())) {
+    bins_[std::max(0, static_cast<int>(bin))]++;
+  } else {
+    overflow_++;
+  }
+}
+
+double LatencyHistogram::Quantile(double quantile) const {
+  const double target = quantile * count_;
+  int64_t cumulative = 0;
+  for (size_t i = 0; i < bins_.size(); i++) {
+    cumulative += bins_[i];
+    if (cumulative > 0 && cumulative >= target) {
+      return std::min((i + 1) * bin_width_, max_);
+    }
+  }
+  return max_;
+}
+
+void LatencyHistogram::PrintSummary(const std::string& name,
+                                    std::ostream& out) const {
+  out << name << ": " << count_ << " samples" << std::fixed
+      << std::setprecision(1) << ", mean " << 1e6 * mean() << " us, p50 "
+      << 1e6 * Quantile(0.5) << " us, p99 " << 1e6 * Quantile(0.99)
+      << " us, p99.9 " << 1e6 * Quantile(0.999) << " us, max " << 1e6 * max_
+      << " us" << std::defaultfloat << std::endl;
+}
+
+void LatencyHistogram::Write(const std::string& name,
+                             std::ostream& out) const {
+  out << "# " << name << ": upper edge (us), count" << std::endl;
+  for (size_t i = 0; i < bins_.size(); i++) {
+    if (bins_[i] > 0) {
+      out << 1e6 * (i + 1) * bin_width_ << " " << bins_[i] << std::endl;
+    }
+  }
+  if (overflow_ > 0) {
+    out << "inf " << overflow_ << std::endl;
+  }
+}
+
+}  // namespace systems
+}  // namespace dairlib
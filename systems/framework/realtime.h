@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dairlib {
+namespace systems {
+
+/// Options of the real-time mode of a control loop, such as LcmDrivenLoop.
+/// Every option is off by default.
+struct RealtimeOptions {
+  /// SCHED_FIFO priority of the loop thread, from 1 to 99. 0 keeps the
+  /// default scheduler.
+  int priority = 0;
+  /// CPUs the loop thread is pinned to. Empty keeps the default affinity.
+  std::vector<int> cpus;
+  /// Locks all current and future memory of the process in RAM, and keeps
+  /// freed heap memory in the process
+  bool lock_memory = false;
+  /// Sizes of the stack and heap to fault in before the loop starts, so that
+  /// the loop does not page fault on them
+  size_t prefault_stack_bytes = 0;
+  size_t prefault_heap_bytes = 0;
+  /// Spins on the input file descriptor instead of sleeping until a message
+  /// arrives, trading a CPU for the wake-up latency of the scheduler. With a
+  /// priority, the loop should be pinned to a CPU that no other thread of the
+  /// process needs, since it never yields it.
+  bool busy_poll = false;
+  /// Records the wake-up latency and compute time of every iteration
+  bool record_latency = false;
+  /// File to which the latency histograms are written when the loop stops.
+  /// Empty only prints their summaries.
+  std::string latency_file;
+};
+
+/// Applies the priority, affinity, memory locking and prefaulting of options
+/// to the calling thread and process. Failures, typically from missing
+/// privileges (CAP_SYS_NICE, CAP_IPC_LOCK or rtprio and memlock limits), are
+/// logged as warnings and the remaining options are still applied.
+void ConfigureRealtimeThread(const RealtimeOptions& options);
+
+/// Waits until fd is readable, spinning if busy_poll, or sleeping for at most
+/// timeout_ms otherwise. Returns false on timeout or on a signal.
+bool WaitForReadable(int fd, bool busy_poll, int timeout_ms = 100);
+
+/// Installs SIGINT and SIGTERM handlers that request loops to stop, so that
+/// they can report their statistics before exiting. A second signal exits
+/// immediately.
+void InstallStopSignalHandlers();
+
+/// Whether a stop signal was received since InstallStopSignalHandlers()
+bool IsStopRequested();
+
+/// LatencyHistogram counts durations in fixed-width bins without allocating,
+/// so that it can be updated from real-time loops.
+class LatencyHistogram {
+ public:
+  /// @param bin_width Width of the bins, in seconds
+  /// @param num_bins Number of bins, past which durations are counted as
+  ///   overflows
+  explicit LatencyHistogram(double bin_width = 1e-6, int num_bins = 20000);
+
+  /// Adds a duration, in seconds
+  void Add(double duration);
+
+  int64_t count() const { return count_; }
+  double min() const { return min_; }
+  double max() const { return max_; }
+  double mean() const { return count_ ? sum_ / count_ : 0; }
+
+  /// Returns the upper edge of the bin of the given quantile, from 0 to 1,
+  /// bounded by the maximum
+  double Quantile(double quantile) const;
+
+  /// Prints the count, mean, 50th, 99th and 99.9th percentiles and maximum,
+  /// in microseconds
+  void PrintSummary(const std::string& name, std::ostream& out) const;
+
+  /// Writes the upper edge, in microseconds, and count of every nonempty bin,
+  /// one bin per line
+  void Write(const std::string& name, std::ostream& out) const;
+
+ private:
+  double bin_width_;
+  std::vector<int64_t> bins_;
+  int64_t overflow_ = 0;
+  int64_t count_ = 0;
+  double sum_ = 0;
+  double min_ = 0;
+  double max_ = 0;
+};
+
+}  // namespace systems
+}  // namespace dairlib
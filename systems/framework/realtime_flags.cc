@@ -0,0 +1,43 @@
+#include "systems/framework/realtime_flags.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(realtime_priority, 0,
+             "SCHED_FIFO priority of the control loop, from 1 to 99, which "
+             "also locks the memory of the process. 0 keeps the default "
+             "scheduler.");
+DEFINE_int32(realtime_cpu, -1,
+             "CPU to pin the control loop to. Negative keeps the default "
+             "affinity.");
+DEFINE_bool(busy_poll, false,
+            "Spin on the state channel instead of sleeping until a message "
+            "arrives");
+DEFINE_bool(record_latency, false,
+            "Print the wake-up latency and compute time histograms of the "
+            "control loop when it is stopped with SIGINT or SIGTERM");
+DEFINE_string(latency_file, "",
+              "File to write the latency histograms to, with "
+              "--record_latency");
+
+namespace dairlib {
+namespace systems {
+
+std::optional<RealtimeOptions> RealtimeOptionsFromFlags() {
+  if (FLAGS_realtime_priority <= 0 && FLAGS_realtime_cpu < 0 &&
+      !FLAGS_busy_poll && !FLAGS_record_latency) {
+    return std::nullopt;
+  }
+  RealtimeOptions options;
+  options.priority = FLAGS_realtime_priority;
+  options.lock_memory = FLAGS_realtime_priority > 0;
+  if (FLAGS_realtime_cpu >= 0) {
+    options.cpus.push_back(FLAGS_realtime_cpu);
+  }
+  options.busy_poll = FLAGS_busy_poll;
+  options.record_latency = FLAGS_record_latency;
+  options.latency_file = FLAGS_latency_file;
+  return options;
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <optional>
+
+#include "systems/framework/realtime.h"
+
+namespace dairlib {
+namespace systems {
+
+/// Command line flags of the real-time mode of a control loop, shared by the
+/// controllers that link this library: --realtime_priority, --realtime_cpu,
+/// --busy_poll, --record_latency and --latency_file.
+
+/// Returns the RealtimeOptions set by the flags, which lock the memory of the
+/// process along with a real-time priority, or nullopt if no flag requests
+/// the real-time mode.
+std::optional<RealtimeOptions> RealtimeOptionsFromFlags();
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,44 @@
+#include "systems/framework/pipeline_tracer.h"
+
+#include <gtest/gtest.h>
+
+#include "drake/lcm/drake_lcm.h"
+#include "drake/lcm/drake_lcm_interface.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+GTEST_TEST(PipelineTracerTest, PublishesTraces) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  drake::lcm::Subscriber<lcmt_pipeline_trace> sub(&lcm, "TRACE");
+  PipelineTracer tracer(&lcm, "controller", "TRACE");
+
+  tracer.Receive(1000, 5);
+  const int64_t before_publish = PipelineTracer::Now();
+  tracer.Publish();
+  const int64_t after_publish = PipelineTracer::Now();
+  lcm.HandleSubscriptions(100);
+  ASSERT_EQ(sub.count(), 1);
+  EXPECT_EQ(sub.message().utime, 1000);
+  EXPECT_EQ(sub.message().stage, "controller");
+  EXPECT_EQ(sub.message().receive_time, 5);
+  EXPECT_GE(sub.message().publish_time, before_publish);
+  EXPECT_LE(sub.message().publish_time, after_publish);
+
+  // The trace is reused for the next message, received now
+  sub.clear();
+  const int64_t before_receive = PipelineTracer::Now();
+  tracer.Receive(-2000);
+  tracer.Publish();
+  lcm.HandleSubscriptions(100);
+  ASSERT_EQ(sub.count(), 1);
+  EXPECT_EQ(sub.message().utime, -2000);
+  EXPECT_EQ(sub.message().stage, "controller");
+  EXPECT_GE(sub.message().receive_time, before_receive);
+  EXPECT_GE(sub.message().publish_time, sub.message().receive_time);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,79 @@
+#include "systems/framework/realtime.h"
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+GTEST_TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.mean(), 0);
+  EXPECT_EQ(histogram.Quantile(0.5), 0);
+}
+
+GTEST_TEST(LatencyHistogramTest, Add) {
+  // Bins of 1 ms
+  LatencyHistogram histogram(1e-3, 100);
+  for (double duration : {2.5e-3, 0.5e-3, 10.5e-3, 2.2e-3}) {
+    histogram.Add(duration);
+  }
+  EXPECT_EQ(histogram.count(), 4);
+  EXPECT_DOUBLE_EQ(histogram.min(), 0.5e-3);
+  EXPECT_DOUBLE_EQ(histogram.max(), 10.5e-3);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 15.7e-3 / 4);
+
+  std::stringstream written;
+  histogram.Write("test", written);
+  EXPECT_EQ(written.str(),
+            "# test: upper edge (us), count\n"
+            "1000 1\n"
+            "3000 2\n"
+            "11000 1\n");
+}
+
+GTEST_TEST(LatencyHistogramTest, Quantile) {
+  LatencyHistogram histogram(1e-3, 100);
+  // One duration in the middle of every bin
+  for (int i = 0; i < 100; i++) {
+    histogram.Add((i + 0.5) * 1e-3);
+  }
+  // The upper edge of the bin holding the quantile
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.01), 1e-3);
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.5), 50e-3);
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.99), 99e-3);
+  // Bounded by the maximum
+  EXPECT_DOUBLE_EQ(histogram.Quantile(1), 99.5e-3);
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0), 1e-3);
+}
+
+GTEST_TEST(LatencyHistogramTest, Overflow) {
+  LatencyHistogram histogram(1e-3, 10);
+  for (int i = 0; i < 8; i++) {
+    histogram.Add(1.5e-3);
+  }
+  // Past the last bin
+  histogram.Add(20e-3);
+  histogram.Add(0.5);
+  EXPECT_EQ(histogram.count(), 10);
+  EXPECT_DOUBLE_EQ(histogram.max(), 0.5);
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.8), 2e-3);
+  // Quantiles among the overflows are the maximum
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.9), 0.5);
+  EXPECT_DOUBLE_EQ(histogram.Quantile(0.99), 0.5);
+
+  std::stringstream written;
+  histogram.Write("test", written);
+  EXPECT_EQ(written.str(),
+            "# test: upper edge (us), count\n"
+            "2000 8\n"
+            "inf 2\n");
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,28 @@
+#include <iostream>
+
+#include <gflags/gflags.h>
+
+#include "systems/log_parser/lcm_log_index.h"
+
+DEFINE_double(stride, 1.0,
+              "Maximum time, in seconds, between indexed events of a channel");
+
+/// Builds the <log>.idx index of each log given as argument, for random
+/// access through LcmLogReader::ReadRange
+int main(int argc, char* argv[]) {
+  gflags::SetUsageMessage("build_lcm_log_index [--stride=1.0] LOG...");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc < 2) {
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+  for (int i = 1; i < argc; i++) {
+    auto index = dairlib::systems::LcmLogIndex::Build(argv[i], FLAGS_stride);
+    const std::string sidecar =
+        dairlib::systems::LcmLogIndex::SidecarPath(argv[i]);
+    index.WriteToFile(sidecar);
+    std::cout << sidecar << ": " << index.entries().size() << " channels, "
+              << index.end_time() - index.start_time() << " s" << std::endl;
+  }
+  return 0;
+}
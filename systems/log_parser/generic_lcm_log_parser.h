@@ -1,13 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <string>
-#include "drake/lcm/drake_lcm_log.h"
-#include "drake/systems/analysis/simulator.h"
-#include "drake/systems/framework/diagram_builder.h"
-#include "drake/systems/lcm/lcm_log_playback_system.h"
-#include "drake/systems/lcm/lcm_subscriber_system.h"
 
-#include "systems/primitives/vector_aggregator.h"
+#include "systems/framework/timestamped_vector.h"
+#include "systems/log_parser/lcm_log_reader.h"
 
 namespace dairlib {
 namespace multibody {
@@ -28,39 +25,36 @@ namespace multibody {
 /// Output:
 ///   - VectorXd `t` to store time
 ///   - MatrixXd `x` to store the information in the lcm message
+///
+/// Each message is passed directly through `system`, whose first output port
+/// must be a TimestampedVector, with an LcmLogReader. To decode several
+/// channels in one pass over the log, use LcmLogReader directly.
 template <typename T, typename U>
 void parseLcmLog(std::unique_ptr<U> system, std::string file,
                  std::string channel, Eigen::VectorXd* t, Eigen::MatrixXd* x,
                  double duration = 1.0e6) {
-  using drake::systems::lcm::LcmSubscriberSystem;
-
-  drake::lcm::DrakeLcmLog r_log(file, false);
-
-  drake::systems::DiagramBuilder<double> builder;
-
-  builder.AddSystem<drake::systems::lcm::LcmLogPlaybackSystem>(&r_log);
-
-  auto output_sub =
-      builder.AddSystem(LcmSubscriberSystem::Make<T>(channel, &r_log));
-
-  auto output_receiver = builder.AddSystem(std::move(system));
-  builder.Connect(*output_sub, *output_receiver);
-
-  auto output_aggregator = builder.AddSystem<systems::VectorAggregator>(
-      output_receiver->get_output_port(0).size() - 1);
-
-  builder.Connect(*output_receiver, *output_aggregator);
-
-  auto diagram = builder.Build();
-
-  drake::systems::Simulator<double> sim(*diagram);
-
-  sim.AdvanceTo(r_log.GetNextMessageTime() + duration);
-
-  *t = output_aggregator->BuildTimestampVector();
-
-  *x = output_aggregator->BuildMatrixFromVectors();
-  }
-} // multibody
-} //dairlib
-
+  auto context = system->CreateDefaultContext();
+  auto& input_value = system->get_input_port(0).FixValue(context.get(), T());
+  const auto& output_port = system->get_output_port(0);
+
+  systems::LcmLogReader reader(file);
+  reader.AddChannel<T>(
+      channel, output_port.size() - 1,
+      [&](const T& message, double log_time,
+          Eigen::Ref<Eigen::VectorXd> column) {
+        input_value.GetMutableData()->template get_mutable_value<T>() =
+            message;
+        const auto& output =
+            output_port.template Eval<systems::TimestampedVector<double>>(
+                *context);
+        column = output.get_data();
+        return output.get_timestamp();
+      });
+  reader.Read(duration);
+
+  *t = reader.get_times(channel);
+  *x = reader.get_data(channel);
+}
+
+}  // namespace multibody
+}  // namespace dairlib
@@ -0,0 +1,202 @@
+#include "systems/log_parser/lcm_log_index.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <lcm/lcm.h>
+
+namespace dairlib {
+namespace systems {
+
+namespace {
+
+const char kMagic[8] = {'D', 'A', 'I', 'R', 'L', 'I', 'D', 'X'};
+const int64_t kVersion = 1;
+
+int64_t FileSize(const std::string& filepath) {
+  struct stat file_stat;
+  if (stat(filepath.c_str(), &file_stat) < 0) {
+    return -1;
+  }
+  return file_stat.st_size;
+}
+
+void WriteInt64(int64_t value, std::ostream& out) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+int64_t ReadInt64(std::istream& in) {
+  int64_t value;
+  if (!in.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+    throw std::runtime_error("Truncated log index");
+  }
+  return value;
+}
+
+}  // namespace
+
+LcmLogIndex LcmLogIndex::Build(const std::string& log_filepath,
+                               double stride) {
+  lcm_eventlog_t* log = lcm_eventlog_create(log_filepath.c_str(), "r");
+  if (!log) {
+    throw std::runtime_error("Could not open log file: " + log_filepath);
+  }
+
+  LcmLogIndex index;
+  index.stride_ = std::llround(1e6 * stride);
+  bool started = false;
+  while (true) {
+    int64_t offset = ftello(log->f);
+    lcm_eventlog_event_t* event = lcm_eventlog_read_next_event(log);
+    if (!event) {
+      break;
+    }
+    if (!started) {
+      index.start_timestamp_ = event->timestamp;
+      started = true;
+    }
+    index.end_timestamp_ = std::max(index.end_timestamp_, event->timestamp);
+
+    auto& entries = index.entries_[event->channel];
+    if (entries.empty() ||
+        event->timestamp - entries.back().timestamp >= index.stride_) {
+      entries.push_back({event->timestamp, offset});
+    }
+    lcm_eventlog_free_event(event);
+  }
+  index.log_size_ = ftello(log->f);
+  lcm_eventlog_destroy(log);
+  return index;
+}
+
+LcmLogIndex LcmLogIndex::LoadOrBuild(const std::string& log_filepath,
+                                     double stride) {
+  const std::string sidecar = SidecarPath(log_filepath);
+  if (FileSize(sidecar) > 0) {
+    try {
+      LcmLogIndex index = LoadFromFile(sidecar);
+      if (index.log_size_ == FileSize(log_filepath) &&
+          index.stride_ == std::llround(1e6 * stride)) {
+        return index;
+      }
+    } catch (std::exception& e) {
+      std::cerr << "Rebuilding invalid log index " << sidecar << ": "
+                << e.what() << std::endl;
+    }
+  }
+  LcmLogIndex index = Build(log_filepath, stride);
+  try {
+    index.WriteToFile(sidecar);
+  } catch (std::exception& e) {
+    // The index is still usable, e.g. when the log directory is read-only
+    std::cerr << e.what() << std::endl;
+  }
+  return index;
+}
+
+void LcmLogIndex::WriteToFile(const std::string& filepath) const {
+  std::ofstream out(filepath, std::ios_base::binary);
+  if (!out) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  out.write(kMagic, sizeof(kMagic));
+  WriteInt64(kVersion, out);
+  WriteInt64(log_size_, out);
+  WriteInt64(start_timestamp_, out);
+  WriteInt64(end_timestamp_, out);
+  WriteInt64(stride_, out);
+  WriteInt64(entries_.size(), out);
+  for (const auto& [channel, entries] : entries_) {
+    WriteInt64(channel.size(), out);
+    out.write(channel.data(), channel.size());
+    WriteInt64(entries.size(), out);
+    for (const auto& entry : entries) {
+      WriteInt64(entry.timestamp, out);
+      WriteInt64(entry.offset, out);
+    }
+  }
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Could not write file: " + filepath);
+  }
+}
+
+LcmLogIndex LcmLogIndex::LoadFromFile(const std::string& filepath) {
+  std::ifstream in(filepath, std::ios_base::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  char magic[sizeof(kMagic)];
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      ReadInt64(in) != kVersion) {
+    throw std::runtime_error("Not a log index: " + filepath);
+  }
+  LcmLogIndex index;
+  index.log_size_ = ReadInt64(in);
+  index.start_timestamp_ = ReadInt64(in);
+  index.end_timestamp_ = ReadInt64(in);
+  index.stride_ = ReadInt64(in);
+  int64_t num_channels = ReadInt64(in);
+  for (int64_t i = 0; i < num_channels; i++) {
+    int64_t length = ReadInt64(in);
+    if (length < 0 || length > index.log_size_) {
+      throw std::runtime_error("Invalid log index: " + filepath);
+    }
+    std::string channel(length, '\0');
+    in.read(&channel[0], length);
+    int64_t num_entries = ReadInt64(in);
+    if (num_entries < 0 || num_entries > index.log_size_) {
+      throw std::runtime_error("Invalid log index: " + filepath);
+    }
+    auto& entries = index.entries_[channel];
+    entries.resize(num_entries);
+    for (auto& entry : entries) {
+      entry.timestamp = ReadInt64(in);
+      entry.offset = ReadInt64(in);
+    }
+  }
+  return index;
+}
+
+int64_t LcmLogIndex::FindOffset(double time,
+                                const std::vector<std::string>& channels)
+    const {
+  const int64_t timestamp = std::llround(1e6 * time);
+  // Last indexed event before timestamp: events between it and the next
+  // indexed one may be at or after timestamp. A channel without entries,
+  // which only a loaded index can have, has no such event.
+  auto channel_offset = [this, timestamp](const std::vector<Entry>& entries) {
+    if (entries.empty()) {
+      return log_size_;
+    }
+    auto it = std::lower_bound(entries.begin(), entries.end(), timestamp,
+                               [](const Entry& entry, int64_t t) {
+                                 return entry.timestamp < t;
+                               });
+    return (it == entries.begin()) ? it->offset : std::prev(it)->offset;
+  };
+
+  int64_t offset = log_size_;
+  if (channels.empty()) {
+    for (const auto& [channel, entries] : entries_) {
+      offset = std::min(offset, channel_offset(entries));
+    }
+  }
+  for (const auto& channel : channels) {
+    auto it = entries_.find(channel);
+    if (it != entries_.end()) {
+      offset = std::min(offset, channel_offset(it->second));
+    }
+  }
+  return offset;
+}
+
+}  // namespace systems
+}  // namespace dairlib
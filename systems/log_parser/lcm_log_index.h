@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dairlib {
+namespace systems {
+
+/// LcmLogIndex is a sidecar index of an LCM log file, which maps the events
+/// of each channel to their offsets in the file, so that a time window of a
+/// long log can be read without reading the log from its start.
+///
+/// For every channel, the index holds the timestamp and file offset of the
+/// first event, and of the first event at least `stride` seconds after the
+/// previously indexed one. Seeking to time t then lands at most one stride
+/// before the first event at or after t.
+///
+/// The index assumes that events are in timestamp order; logs with
+/// out-of-order messages should first go through log_sequence_rectifier.
+///
+/// Indexes are written next to their log, as <log>.idx, along with the size
+/// of the log, so that an index of a log which has since changed is rebuilt.
+class LcmLogIndex {
+ public:
+  struct Entry {
+    /// Microseconds, as in the log
+    int64_t timestamp;
+    int64_t offset;
+  };
+
+  /// Builds the index of a log in one pass
+  /// @param stride Maximum time, in seconds, between indexed events of a
+  ///   channel
+  /// @throws std::runtime_error if the log cannot be opened
+  static LcmLogIndex Build(const std::string& log_filepath,
+                           double stride = 1.0);
+
+  /// Loads the sidecar index of a log if it exists and matches the log, and
+  /// otherwise builds it and tries to write it
+  static LcmLogIndex LoadOrBuild(const std::string& log_filepath,
+                                 double stride = 1.0);
+
+  static std::string SidecarPath(const std::string& log_filepath) {
+    return log_filepath + ".idx";
+  }
+
+  /// @throws std::runtime_error if unable to write the file
+  void WriteToFile(const std::string& filepath) const;
+
+  /// @throws std::runtime_error if the file is missing or invalid
+  static LcmLogIndex LoadFromFile(const std::string& filepath);
+
+  /// Returns an offset at or before the first event at or after time (in
+  /// seconds) of every given channel, or of all channels if empty. Returns the
+  /// end of the log if there is no such event.
+  int64_t FindOffset(double time,
+                     const std::vector<std::string>& channels = {}) const;
+
+  /// Timestamps of the first and last events, in seconds
+  double start_time() const { return 1e-6 * start_timestamp_; }
+  double end_time() const { return 1e-6 * end_timestamp_; }
+
+  int64_t log_size() const { return log_size_; }
+
+  const std::map<std::string, std::vector<Entry>>& entries() const {
+    return entries_;
+  }
+
+ private:
+  int64_t log_size_ = 0;
+  int64_t start_timestamp_ = 0;
+  int64_t end_timestamp_ = 0;
+  int64_t stride_ = 0;
+  std::map<std::string, std::vector<Entry>> entries_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
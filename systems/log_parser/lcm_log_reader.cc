@@ -0,0 +1,180 @@
+#include "systems/log_parser/lcm_log_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+namespace systems {
+
+using Eigen::Map;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace {
+
+/// Events read before decoding them
+constexpr int kBatchSize = 4096;
+
+}  // namespace
+
+LcmLogReader::LcmLogReader(const std::string& filepath)
+    : log_(lcm_eventlog_create(filepath.c_str(), "r")) {
+  if (!log_) {
+    throw std::runtime_error("Could not open log file: " + filepath);
+  }
+}
+
+LcmLogReader::~LcmLogReader() { lcm_eventlog_destroy(log_); }
+
+void LcmLogReader::AddChannel(const std::string& channel, int size,
+                              Decoder decoder, int expected_messages) {
+  DRAKE_DEMAND(channel_indices_.count(channel) == 0);
+  DRAKE_DEMAND(size >= 0);
+  Channel new_channel;
+  new_channel.name = channel;
+  new_channel.decoder = std::move(decoder);
+  new_channel.times.resize(expected_messages);
+  new_channel.data.resize(size, expected_messages);
+  channel_indices_[channel] = channels_.size();
+  channels_.push_back(std::move(new_channel));
+}
+
+int LcmLogReader::channel_index(const std::string& channel) const {
+  auto it = channel_indices_.find(channel);
+  if (it == channel_indices_.end()) {
+    throw std::out_of_range("Channel " + channel + " was not added");
+  }
+  return it->second;
+}
+
+Map<const VectorXd> LcmLogReader::get_times(const std::string& channel) const {
+  const Channel& c = channels_[channel_index(channel)];
+  return Map<const VectorXd>(c.times.data(), c.num_messages);
+}
+
+Map<const MatrixXd> LcmLogReader::get_data(const std::string& channel) const {
+  const Channel& c = channels_[channel_index(channel)];
+  return Map<const MatrixXd>(c.data.data(), c.data.rows(), c.num_messages);
+}
+
+void LcmLogReader::Read(double duration, int num_threads) {
+  DRAKE_DEMAND(num_threads > 0);
+  int64_t start_timestamp = 0;
+  bool started = false;
+  lcm_eventlog_event_t* event;
+  while ((event = lcm_eventlog_read_next_event(log_)) != nullptr) {
+    if (!started) {
+      start_timestamp = event->timestamp;
+      started = true;
+    }
+    if (1e-6 * (event->timestamp - start_timestamp) > duration) {
+      lcm_eventlog_free_event(event);
+      break;
+    }
+    QueueEvent(*event, num_threads);
+    lcm_eventlog_free_event(event);
+  }
+  DecodeBatch(num_threads);
+}
+
+void LcmLogReader::ReadRange(const LcmLogIndex& index, double start_time,
+                             double end_time, int num_threads) {
+  DRAKE_DEMAND(num_threads > 0);
+  std::vector<std::string> channels;
+  for (const auto& channel : channels_) {
+    channels.push_back(channel.name);
+  }
+  if (fseeko(log_->f, index.FindOffset(start_time, channels), SEEK_SET) != 0) {
+    throw std::runtime_error("Could not seek in log file");
+  }
+
+  const int64_t start_timestamp = std::llround(1e6 * start_time);
+  const int64_t end_timestamp = std::llround(1e6 * end_time);
+  lcm_eventlog_event_t* event;
+  while ((event = lcm_eventlog_read_next_event(log_)) != nullptr) {
+    if (event->timestamp > end_timestamp) {
+      lcm_eventlog_free_event(event);
+      break;
+    }
+    if (event->timestamp >= start_timestamp) {
+      QueueEvent(*event, num_threads);
+    }
+    lcm_eventlog_free_event(event);
+  }
+  DecodeBatch(num_threads);
+}
+
+void LcmLogReader::QueueEvent(const lcm_eventlog_event_t& event,
+                              int num_threads) {
+  auto it = channel_indices_.find(event.channel);
+  if (it != channel_indices_.end()) {
+    // Columns are assigned in log order, and buffers only grow between
+    // batches, while no decoder is running
+    Channel& channel = channels_[it->second];
+    if (channel.num_messages == static_cast<int>(channel.times.size())) {
+      int capacity = std::max<int>(2 * channel.times.size(), 64);
+      channel.times.conservativeResize(capacity);
+      channel.data.conservativeResize(Eigen::NoChange, capacity);
+    }
+    batch_.push_back({it->second, channel.num_messages++,
+                      1e-6 * event.timestamp, arena_.size(), event.datalen});
+    const uint8_t* data = static_cast<const uint8_t*>(event.data);
+    arena_.insert(arena_.end(), data, data + event.datalen);
+  }
+  if (batch_.size() == kBatchSize) {
+    DecodeBatch(num_threads);
+  }
+}
+
+void LcmLogReader::DecodeBatch(int num_threads) {
+  auto decode = [this](const PendingEvent& event) {
+    Channel& channel = channels_[event.channel];
+    channel.times(event.column) = channel.decoder(
+        arena_.data() + event.offset, event.size, event.log_time,
+        channel.data.col(event.column));
+  };
+
+  const int n = batch_.size();
+  num_threads = std::min(num_threads, n / 64 + 1);
+  if (num_threads <= 1) {
+    for (const auto& event : batch_) {
+      decode(event);
+    }
+  } else {
+    // Every event writes its own column, so threads only share the counter
+    std::atomic<int> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&]() {
+        try {
+          for (int i = next++; i < n; i = next++) {
+            decode(batch_[i]);
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          error = std::current_exception();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  batch_.clear();
+  arena_.clear();
+}
+
+}  // namespace systems
+}  // namespace dairlib
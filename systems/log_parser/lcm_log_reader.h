@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <lcm/lcm.h>
+
+#include "drake/common/drake_copyable.h"
+#include "systems/log_parser/lcm_log_index.h"
+
+namespace dairlib {
+namespace systems {
+
+/// LcmLogReader decodes the messages of one or more channels of an LCM log
+/// file in a single pass, without building or simulating a diagram.
+///
+/// Every channel is given a decoder, which writes each message into one
+/// column of a preallocated, column-major buffer and returns its time. The
+/// log is read in batches of events; the events of a batch are then decoded,
+/// optionally on several threads, directly into their columns. Buffers grow
+/// geometrically, so giving the expected number of messages of a channel
+/// avoids any reallocation.
+///
+/// Typical usage:
+///   LcmLogReader reader(filepath);
+///   reader.AddChannel<lcmt_robot_output>("CASSIE_STATE_DISPATCHER", nx,
+///       [](const lcmt_robot_output& msg, double log_time,
+///          Eigen::Ref<Eigen::VectorXd> x) {
+///         x.head(nq) = ...;
+///         return msg.utime * 1e-6;
+///       });
+///   reader.Read();
+///   auto x = reader.get_data("CASSIE_STATE_DISPATCHER");
+class LcmLogReader {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(LcmLogReader)
+
+  /// Decodes the size bytes of an encoded message, logged at log_time
+  /// (seconds), into x and returns the time of the message in seconds
+  using Decoder = std::function<double(const void* data, int size,
+                                       double log_time,
+                                       Eigen::Ref<Eigen::VectorXd> x)>;
+
+  /// @throws std::runtime_error if the log cannot be opened
+  explicit LcmLogReader(const std::string& filepath);
+
+  ~LcmLogReader();
+
+  /// Decodes the messages of channel into vectors of the given size
+  /// @param expected_messages Number of columns to preallocate
+  void AddChannel(const std::string& channel, int size, Decoder decoder,
+                  int expected_messages = 0);
+
+  /// Decodes the messages of channel as lcmtype T, and then into vectors with
+  /// decoder(message, log_time, x), which returns the message time
+  template <typename T>
+  void AddChannel(const std::string& channel, int size,
+                  std::function<double(const T& message, double log_time,
+                                       Eigen::Ref<Eigen::VectorXd> x)>
+                      decoder,
+                  int expected_messages = 0) {
+    AddChannel(
+        channel, size,
+        [decoder, channel](const void* data, int data_size, double log_time,
+                           Eigen::Ref<Eigen::VectorXd> x) {
+          T message;
+          if (message.decode(data, 0, data_size) < 0) {
+            throw std::runtime_error("Failed to decode message on channel " +
+                                     channel);
+          }
+          return decoder(message, log_time, x);
+        },
+        expected_messages);
+  }
+
+  /// Reads and decodes the log from the current position, until its end or
+  /// until duration seconds after the first message read. Decoded messages
+  /// are appended to those of previous calls.
+  /// @param num_threads Number of threads decoding each batch of events. The
+  ///   decoders must then be safe to call concurrently.
+  void Read(double duration = std::numeric_limits<double>::infinity(),
+            int num_threads = 1);
+
+  /// Seeks to start_time using the index of the log, and reads and decodes
+  /// the messages logged between start_time and end_time (seconds, in log
+  /// time). Only the indexed events of the added channels are considered
+  /// when seeking, so the events of other channels are mostly skipped.
+  void ReadRange(const LcmLogIndex& index, double start_time, double end_time,
+                 int num_threads = 1);
+
+  /// Number of decoded messages of channel
+  int num_messages(const std::string& channel) const {
+    return channels_.at(channel_index(channel)).num_messages;
+  }
+
+  /// Times of the decoded messages of channel, in seconds
+  Eigen::Map<const Eigen::VectorXd> get_times(
+      const std::string& channel) const;
+
+  /// Decoded messages of channel, one column per message
+  Eigen::Map<const Eigen::MatrixXd> get_data(const std::string& channel) const;
+
+ private:
+  struct Channel {
+    std::string name;
+    Decoder decoder;
+    int num_messages = 0;
+    Eigen::VectorXd times;
+    Eigen::MatrixXd data;
+  };
+
+  /// An event waiting to be decoded, whose payload is in the batch arena
+  struct PendingEvent {
+    int channel;
+    int column;
+    double log_time;
+    size_t offset;
+    int size;
+  };
+
+  int channel_index(const std::string& channel) const;
+  /// Appends event to the batch if its channel was added, and decodes the
+  /// batch once full
+  void QueueEvent(const lcm_eventlog_event_t& event, int num_threads);
+  void DecodeBatch(int num_threads);
+
+  lcm_eventlog_t* log_;
+  std::vector<Channel> channels_;
+  std::unordered_map<std::string, int> channel_indices_;
+  std::vector<PendingEvent> batch_;
+  std::vector<uint8_t> arena_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,157 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "dairlib/lcmt_pipeline_trace.hpp"
+#include "systems/framework/realtime.h"
+#include "systems/log_parser/lcm_log_reader.h"
+
+DEFINE_string(channel, "PIPELINE_TRACE", "Channel of the pipeline traces");
+DEFINE_string(stages,
+              "dispatcher_robot_out,osc_walking_controller,dispatcher_robot_in",
+              "Comma-separated stages of the pipeline, in order");
+DEFINE_string(output, "",
+              "File to write the latency histograms to. Empty only prints "
+              "their summaries.");
+
+namespace dairlib {
+namespace {
+
+using systems::LatencyHistogram;
+
+/// Receive and publish times of a message through one stage, in nanoseconds
+struct StageTimes {
+  double receive_time;
+  double publish_time;
+};
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/// Reconstructs the latency of every message through the pipeline from the
+/// lcmt_pipeline_trace messages of a log. A message is followed from the
+/// first stage to the next by its utime. Since stages convert utime to
+/// seconds and back, a later stage may see the utime one microsecond lower.
+int DoMain(int argc, char* argv[]) {
+  gflags::SetUsageMessage("pipeline_latency [--stages=...] LOG");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const std::vector<std::string> stages = Split(FLAGS_stages);
+  if (argc != 2 || stages.empty()) {
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+  const int num_stages = stages.size();
+
+  std::unordered_map<std::string, int> stage_indices;
+  for (int i = 0; i < num_stages; i++) {
+    stage_indices[stages[i]] = i;
+  }
+
+  // Decode every trace as (utime, stage index, receive time, publish time)
+  systems::LcmLogReader reader(argv[1]);
+  reader.AddChannel<lcmt_pipeline_trace>(
+      FLAGS_channel, 4,
+      [&stage_indices](const lcmt_pipeline_trace& trace, double log_time,
+                       Eigen::Ref<Eigen::VectorXd> x) {
+        auto it = stage_indices.find(trace.stage);
+        x << trace.utime, (it == stage_indices.end()) ? -1 : it->second,
+            trace.receive_time, trace.publish_time;
+        return log_time;
+      });
+  reader.Read();
+  const auto traces = reader.get_data(FLAGS_channel);
+
+  std::vector<std::unordered_map<int64_t, StageTimes>> stage_times(num_stages);
+  for (int i = 0; i < traces.cols(); i++) {
+    const int stage = traces(1, i);
+    if (stage >= 0) {
+      stage_times[stage][traces(0, i)] = {traces(2, i), traces(3, i)};
+    }
+  }
+
+  // Compute time of every stage, and transport time from every stage to the
+  // next, from publishing its result to the next stage receiving it
+  std::vector<LatencyHistogram> compute(num_stages);
+  std::vector<LatencyHistogram> transport(num_stages);
+  LatencyHistogram end_to_end;
+  std::vector<int> reached(num_stages, 0);
+  for (const auto& [first_utime, first] : stage_times[0]) {
+    int64_t utime = first_utime;
+    const StageTimes* previous = &first;
+    compute[0].Add(1e-9 * (first.publish_time - first.receive_time));
+    reached[0]++;
+    int stage = 1;
+    for (; stage < num_stages; stage++) {
+      auto it = stage_times[stage].find(utime);
+      if (it == stage_times[stage].end()) {
+        it = stage_times[stage].find(utime - 1);
+        if (it == stage_times[stage].end()) {
+          break;
+        }
+      }
+      utime = it->first;
+      const StageTimes& current = it->second;
+      transport[stage].Add(1e-9 *
+                           (current.receive_time - previous->publish_time));
+      compute[stage].Add(1e-9 * (current.publish_time - current.receive_time));
+      reached[stage]++;
+      previous = &current;
+    }
+    if (stage == num_stages) {
+      end_to_end.Add(1e-9 * (previous->publish_time - first.receive_time));
+    }
+  }
+
+  std::cout << traces.cols() << " traces, " << reached[0]
+            << " messages from " << stages[0] << std::endl;
+  std::vector<std::pair<std::string, const LatencyHistogram*>> histograms;
+  for (int i = 0; i < num_stages; i++) {
+    if (i > 0) {
+      histograms.emplace_back(stages[i - 1] + " -> " + stages[i],
+                              &transport[i]);
+    }
+    histograms.emplace_back(stages[i], &compute[i]);
+  }
+  histograms.emplace_back("end to end", &end_to_end);
+  for (const auto& [name, histogram] : histograms) {
+    histogram->PrintSummary(name, std::cout);
+  }
+  for (int i = 1; i < num_stages; i++) {
+    if (reached[i] < reached[i - 1]) {
+      std::cout << reached[i - 1] - reached[i] << " messages of "
+                << stages[i - 1] << " were not traced by " << stages[i]
+                << std::endl;
+    }
+  }
+
+  if (!FLAGS_output.empty()) {
+    std::ofstream out(FLAGS_output);
+    for (const auto& [name, histogram] : histograms) {
+      histogram->Write(name, out);
+    }
+    if (!out) {
+      std::cerr << "Could not write " << FLAGS_output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
@@ -0,0 +1,191 @@
+#include "systems/log_parser/generic_lcm_log_parser.h"
+
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lcm/lcm.h>
+
+#include "dairlib/lcmt_robot_input.hpp"
+#include "systems/framework/timestamped_vector.h"
+#include "systems/log_parser/lcm_log_reader.h"
+
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace multibody {
+namespace {
+
+using drake::systems::Context;
+using std::string;
+using systems::TimestampedVector;
+
+/// Outputs the two efforts of an lcmt_robot_input, stamped with its utime
+class EffortReceiver : public drake::systems::LeafSystem<double> {
+ public:
+  EffortReceiver() {
+    this->DeclareAbstractInputPort("lcmt_robot_input",
+                                   drake::Value<lcmt_robot_input>{});
+    this->DeclareVectorOutputPort(TimestampedVector<double>(2),
+                                  &EffortReceiver::CopyOutput);
+  }
+
+ private:
+  void CopyOutput(const Context<double>& context,
+                  TimestampedVector<double>* output) const {
+    const auto& msg =
+        this->EvalAbstractInput(context, 0)->get_value<lcmt_robot_input>();
+    output->get_mutable_data() << msg.efforts[0], msg.efforts[1];
+    output->set_timestamp(msg.utime * 1.0e-6);
+  }
+};
+
+string TempPath(const string& name) {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? string(directory) + "/" + name : name;
+}
+
+lcmt_robot_input MakeMessage(int64_t utime, double effort) {
+  lcmt_robot_input msg;
+  msg.utime = utime;
+  msg.num_efforts = 2;
+  msg.effort_names = {"a", "b"};
+  msg.efforts = {effort, -effort};
+  return msg;
+}
+
+void WriteEvent(lcm_eventlog_t* log, int64_t timestamp, const string& channel,
+                const lcmt_robot_input& msg) {
+  std::vector<uint8_t> buffer(msg.getEncodedSize());
+  msg.encode(buffer.data(), 0, buffer.size());
+  lcm_eventlog_event_t event{};
+  event.timestamp = timestamp;
+  event.channel = const_cast<char*>(channel.c_str());
+  event.channellen = channel.size();
+  event.data = buffer.data();
+  event.datalen = buffer.size();
+  ASSERT_EQ(lcm_eventlog_write_event(log, &event), 0);
+}
+
+/// Writes 100 events 10 ms apart, alternating between the INPUT and OTHER
+/// channels. Every two consecutive INPUT messages share a utime.
+string WriteLog() {
+  const string filepath = TempPath("generic_lcm_log_parser_test.lcmlog");
+  lcm_eventlog_t* log = lcm_eventlog_create(filepath.c_str(), "w");
+  for (int i = 0; i < 100; i++) {
+    const int64_t timestamp = 1000000 + 10000 * i;
+    if (i % 2 == 0) {
+      const int k = i / 2;
+      WriteEvent(log, timestamp, "INPUT", MakeMessage(1000 * (k / 2), k));
+    } else {
+      WriteEvent(log, timestamp, "OTHER", MakeMessage(-1, -100));
+    }
+  }
+  lcm_eventlog_destroy(log);
+  return filepath;
+}
+
+GTEST_TEST(GenericLcmLogParserTest, ParsesEveryMessageOfTheChannel) {
+  const string filepath = WriteLog();
+  Eigen::VectorXd t;
+  Eigen::MatrixXd x;
+  parseLcmLog<lcmt_robot_input>(std::make_unique<EffortReceiver>(), filepath,
+                                "INPUT", &t, &x);
+
+  // One column per message, including those with a repeated utime
+  ASSERT_EQ(t.size(), 50);
+  ASSERT_EQ(x.rows(), 2);
+  ASSERT_EQ(x.cols(), 50);
+  for (int k = 0; k < 50; k++) {
+    EXPECT_DOUBLE_EQ(t(k), 1e-3 * (k / 2));
+    EXPECT_EQ(x(0, k), k);
+    EXPECT_EQ(x(1, k), -k);
+  }
+
+  // The other channel is parsed separately
+  parseLcmLog<lcmt_robot_input>(std::make_unique<EffortReceiver>(), filepath,
+                                "OTHER", &t, &x);
+  ASSERT_EQ(x.cols(), 50);
+  EXPECT_TRUE((t.array() == -1e-6).all());
+  EXPECT_TRUE((x.row(0).array() == -100).all());
+}
+
+GTEST_TEST(GenericLcmLogParserTest, StopsAfterDuration) {
+  const string filepath = WriteLog();
+  Eigen::VectorXd t;
+  Eigen::MatrixXd x;
+  // Events at 0, 10, ..., 250 ms after the first one
+  parseLcmLog<lcmt_robot_input>(std::make_unique<EffortReceiver>(), filepath,
+                                "INPUT", &t, &x, 0.25);
+  ASSERT_EQ(t.size(), 13);
+  ASSERT_EQ(x.cols(), 13);
+  EXPECT_EQ(x(0, 12), 12);
+}
+
+/// Writes num_events events 1 ms apart, cycling through the channels A, B
+/// and C, and returns the path of the log. The efforts of event i are i and
+/// -i, and its utime is 10 * i.
+string WriteMultiChannelLog(int num_events) {
+  const string filepath = TempPath("generic_lcm_log_parser_test_multi.lcmlog");
+  lcm_eventlog_t* log = lcm_eventlog_create(filepath.c_str(), "w");
+  const std::vector<string> channels = {"A", "B", "C"};
+  for (int i = 0; i < num_events; i++) {
+    WriteEvent(log, 1000000 + 1000 * i, channels[i % 3],
+               MakeMessage(10 * i, i));
+  }
+  lcm_eventlog_destroy(log);
+  return filepath;
+}
+
+/// Reads channels A and B of the log on num_threads threads
+void ReadChannels(const string& filepath, int num_threads,
+                  systems::LcmLogReader* reader) {
+  for (const string channel : {"A", "B"}) {
+    reader->AddChannel<lcmt_robot_input>(
+        channel, 2,
+        [](const lcmt_robot_input& msg, double log_time,
+           Eigen::Ref<Eigen::VectorXd> x) {
+          x << msg.efforts[0], msg.efforts[1];
+          return msg.utime * 1e-6;
+        });
+  }
+  reader->Read(std::numeric_limits<double>::infinity(), num_threads);
+}
+
+GTEST_TEST(GenericLcmLogParserTest, ThreadedMultiChannelRead) {
+  // Longer than several batches of events
+  const int num_events = 3 * 4096 + 100;
+  const string filepath = WriteMultiChannelLog(num_events);
+  systems::LcmLogReader serial(filepath);
+  ReadChannels(filepath, 1, &serial);
+  systems::LcmLogReader threaded(filepath);
+  ReadChannels(filepath, 4, &threaded);
+
+  for (int offset : {0, 1}) {
+    const string channel = offset ? "B" : "A";
+    SCOPED_TRACE(channel);
+    const int num_messages = (num_events - offset + 2) / 3;
+    ASSERT_EQ(serial.num_messages(channel), num_messages);
+    ASSERT_EQ(threaded.num_messages(channel), num_messages);
+    const auto times = threaded.get_times(channel);
+    const auto data = threaded.get_data(channel);
+    for (int k = 0; k < num_messages; k++) {
+      const int i = 3 * k + offset;
+      EXPECT_DOUBLE_EQ(times(k), 1e-5 * i);
+      EXPECT_EQ(data(0, k), i);
+      EXPECT_EQ(data(1, k), -i);
+    }
+    EXPECT_TRUE(threaded.get_times(channel) == serial.get_times(channel));
+    EXPECT_TRUE(threaded.get_data(channel) == serial.get_data(channel));
+  }
+  // Channel C was not added
+  EXPECT_THROW(threaded.num_messages("C"), std::out_of_range);
+}
+
+}  // namespace
+}  // namespace multibody
+}  // namespace dairlib
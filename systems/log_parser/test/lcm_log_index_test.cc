@@ -0,0 +1,192 @@
+#include "systems/log_parser/lcm_log_index.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lcm/lcm.h>
+
+#include "systems/log_parser/lcm_log_reader.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using std::string;
+using std::vector;
+
+string TempPath(const string& name) {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? string(directory) + "/" + name : name;
+}
+
+const vector<string> kChannels = {"A", "B", "C"};
+constexpr int kNumEvents = 3000;
+
+/// Timestamp, in microseconds, of event i
+int64_t EventTimestamp(int i) { return 1000000 + 1000 * i; }
+
+/// Writes kNumEvents events 1 ms apart, cycling through kChannels, whose
+/// payload is their index as a double
+string WriteLog() {
+  const string filepath = TempPath("lcm_log_index_test.lcmlog");
+  lcm_eventlog_t* log = lcm_eventlog_create(filepath.c_str(), "w");
+  for (int i = 0; i < kNumEvents; i++) {
+    double payload = i;
+    const string& channel = kChannels[i % kChannels.size()];
+    lcm_eventlog_event_t event{};
+    event.timestamp = EventTimestamp(i);
+    event.channel = const_cast<char*>(channel.c_str());
+    event.channellen = channel.size();
+    event.data = &payload;
+    event.datalen = sizeof(payload);
+    lcm_eventlog_write_event(log, &event);
+  }
+  lcm_eventlog_destroy(log);
+  return filepath;
+}
+
+/// Adds channels A and B, decoding each event into its index
+void AddChannels(LcmLogReader* reader) {
+  for (const string channel : {"A", "B"}) {
+    reader->AddChannel(channel, 1,
+                       [](const void* data, int size, double log_time,
+                          Eigen::Ref<Eigen::VectorXd> x) {
+                         EXPECT_EQ(size, sizeof(double));
+                         x(0) = *static_cast<const double*>(data);
+                         return log_time;
+                       });
+  }
+}
+
+class LcmLogIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    log_filepath_ = WriteLog();
+    // Several events of every channel between indexed ones
+    index_ = LcmLogIndex::Build(log_filepath_, 0.05);
+  }
+
+  /// Compares ReadRange with a full read of the log, filtered to the window
+  void ExpectRangeMatchesFullRead(double start_time, double end_time) {
+    SCOPED_TRACE("Window [" + std::to_string(start_time) + ", " +
+                 std::to_string(end_time) + "]");
+    LcmLogReader full(log_filepath_);
+    AddChannels(&full);
+    full.Read();
+    LcmLogReader range(log_filepath_);
+    AddChannels(&range);
+    range.ReadRange(index_, start_time, end_time);
+
+    for (const string channel : {"A", "B"}) {
+      vector<double> expected;
+      const auto data = full.get_data(channel);
+      for (int j = 0; j < data.cols(); j++) {
+        const int64_t timestamp = EventTimestamp(data(0, j));
+        if (timestamp >= std::llround(1e6 * start_time) &&
+            timestamp <= std::llround(1e6 * end_time)) {
+          expected.push_back(data(0, j));
+        }
+      }
+      const auto actual = range.get_data(channel);
+      ASSERT_EQ(actual.cols(), static_cast<int>(expected.size()));
+      for (int j = 0; j < actual.cols(); j++) {
+        EXPECT_EQ(actual(0, j), expected[j]);
+        EXPECT_EQ(range.get_times(channel)(j),
+                  1e-6 * EventTimestamp(expected[j]));
+      }
+    }
+  }
+
+  string log_filepath_;
+  LcmLogIndex index_;
+};
+
+TEST_F(LcmLogIndexTest, Build) {
+  EXPECT_EQ(index_.start_time(), 1e-6 * EventTimestamp(0));
+  EXPECT_EQ(index_.end_time(), 1e-6 * EventTimestamp(kNumEvents - 1));
+  ASSERT_EQ(index_.entries().size(), kChannels.size());
+  for (const auto& [channel, entries] : index_.entries()) {
+    ASSERT_FALSE(entries.empty());
+    // Indexed events of a channel are at least one stride apart, and no more
+    // than one stride plus one event period
+    for (size_t i = 1; i < entries.size(); i++) {
+      const int64_t gap = entries[i].timestamp - entries[i - 1].timestamp;
+      EXPECT_GE(gap, 50000);
+      EXPECT_LT(gap, 50000 + 3000);
+      EXPECT_GT(entries[i].offset, entries[i - 1].offset);
+    }
+  }
+}
+
+TEST_F(LcmLogIndexTest, ReadRangeMatchesFullRead) {
+  ExpectRangeMatchesFullRead(1.2345, 2.1);
+  // Bounds on the events of either channel
+  ExpectRangeMatchesFullRead(2.0, 2.0);
+  ExpectRangeMatchesFullRead(1.5, 1.503);
+  // Windows overlapping the start or the end of the log, or outside of it
+  ExpectRangeMatchesFullRead(0, 1.1);
+  ExpectRangeMatchesFullRead(3.9, 5);
+  ExpectRangeMatchesFullRead(5, 6);
+  ExpectRangeMatchesFullRead(0, 10);
+}
+
+TEST_F(LcmLogIndexTest, FileRoundTrip) {
+  const string filepath = TempPath("lcm_log_index_test.idx");
+  index_.WriteToFile(filepath);
+  const LcmLogIndex loaded = LcmLogIndex::LoadFromFile(filepath);
+  EXPECT_EQ(loaded.log_size(), index_.log_size());
+  EXPECT_EQ(loaded.start_time(), index_.start_time());
+  EXPECT_EQ(loaded.end_time(), index_.end_time());
+  ASSERT_EQ(loaded.entries().size(), index_.entries().size());
+  for (const auto& [channel, entries] : index_.entries()) {
+    const auto& loaded_entries = loaded.entries().at(channel);
+    ASSERT_EQ(loaded_entries.size(), entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+      EXPECT_EQ(loaded_entries[i].timestamp, entries[i].timestamp);
+      EXPECT_EQ(loaded_entries[i].offset, entries[i].offset);
+    }
+  }
+  for (double time : {0.0, 1.5, 2.0, 3.9, 5.0}) {
+    EXPECT_EQ(loaded.FindOffset(time), index_.FindOffset(time));
+    EXPECT_EQ(loaded.FindOffset(time, {"B"}), index_.FindOffset(time, {"B"}));
+  }
+
+  // A truncated file is rejected
+  std::ofstream(filepath, std::ios_base::binary) << "DAIRLIDX";
+  EXPECT_THROW(LcmLogIndex::LoadFromFile(filepath), std::runtime_error);
+}
+
+TEST_F(LcmLogIndexTest, ChannelWithoutEntries) {
+  // Only a loaded index can have a channel without entries
+  const string filepath = TempPath("lcm_log_index_test_empty.idx");
+  {
+    std::ofstream out(filepath, std::ios_base::binary);
+    auto write = [&out](int64_t value) {
+      out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    out << "DAIRLIDX";
+    write(1);     // version
+    write(1000);  // log size
+    write(0);     // start timestamp
+    write(0);     // end timestamp
+    write(0);     // stride
+    write(1);     // number of channels
+    write(1);
+    out << "A";
+    write(0);     // number of entries
+  }
+  const LcmLogIndex index = LcmLogIndex::LoadFromFile(filepath);
+  ASSERT_EQ(index.entries().at("A").size(), 0);
+  EXPECT_EQ(index.FindOffset(0), 1000);
+  EXPECT_EQ(index.FindOffset(0, {"A"}), 1000);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <lcm/lcm.h>
+
+#include "dairlib/lcmt_pipeline_trace.hpp"
+
+namespace dairlib {
+namespace {
+
+using std::string;
+
+/// The binary under test, a data dependency of the test
+const char kPipelineLatency[] = "systems/log_parser/pipeline_latency";
+
+string TempPath(const string& name) {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? string(directory) + "/" + name : name;
+}
+
+void WriteTrace(lcm_eventlog_t* log, int64_t utime, const string& stage,
+                int64_t receive_time, int64_t publish_time) {
+  lcmt_pipeline_trace trace;
+  trace.utime = utime;
+  trace.stage = stage;
+  trace.receive_time = receive_time;
+  trace.publish_time = publish_time;
+  std::vector<uint8_t> buffer(trace.getEncodedSize());
+  trace.encode(buffer.data(), 0, buffer.size());
+  lcm_eventlog_event_t event{};
+  // Log times are not used
+  event.timestamp = 1000000;
+  event.channel = const_cast<char*>("PIPELINE_TRACE");
+  event.channellen = 14;
+  event.data = buffer.data();
+  event.datalen = buffer.size();
+  ASSERT_EQ(lcm_eventlog_write_event(log, &event), 0);
+}
+
+/// Runs pipeline_latency on the log and returns what it printed
+string RunPipelineLatency(const string& log_filepath, const string& flags) {
+  const string output = TempPath("pipeline_latency_output.txt");
+  const string command = string(kPipelineLatency) + " " + flags + " " +
+                         log_filepath + " > " + output;
+  EXPECT_EQ(std::system(command.c_str()), 0) << command;
+  std::ifstream file(output);
+  std::stringstream printed;
+  printed << file.rdbuf();
+  return printed.str();
+}
+
+/// Whether printed has a line starting with line
+bool HasLine(const string& printed, const string& line) {
+  return printed.find("\n" + line) != string::npos ||
+         printed.compare(0, line.size(), line) == 0;
+}
+
+GTEST_TEST(PipelineLatencyTest, FollowsMessagesThroughStages) {
+  // Ten messages through stages a, b and c, with times in nanoseconds. Stage
+  // b sees the utime of odd messages one microsecond lower, as stages that
+  // convert it to seconds and back may, and stage c sees the utime of b. The
+  // trace of b is missing for message 8 and the trace of c for message 9.
+  const string log_filepath = TempPath("pipeline_latency_test.lcmlog");
+  lcm_eventlog_t* log = lcm_eventlog_create(log_filepath.c_str(), "w");
+  ASSERT_NE(log, nullptr);
+  for (int k = 0; k < 10; k++) {
+    const int64_t utime = 1000 * k;
+    const int64_t b_utime = (k % 2) ? utime - 1 : utime;
+    const int64_t a_receive = 1000000000000 + 1000000 * k;
+    const int64_t a_publish = a_receive + 100500;
+    const int64_t b_receive = a_publish + 200500;
+    const int64_t b_publish = b_receive + 300500;
+    const int64_t c_receive = b_publish + 50500;
+    const int64_t c_publish = c_receive + 400500;
+    WriteTrace(log, utime, "a", a_receive, a_publish);
+    if (k != 8) {
+      WriteTrace(log, b_utime, "b", b_receive, b_publish);
+    }
+    if (k != 9) {
+      WriteTrace(log, b_utime, "c", c_receive, c_publish);
+    }
+    // Stages that are not given are ignored
+    WriteTrace(log, utime, "other", 0, 0);
+  }
+  lcm_eventlog_destroy(log);
+
+  const string histogram_filepath = TempPath("pipeline_latency.txt");
+  const string printed = RunPipelineLatency(
+      log_filepath, "--stages=a,b,c --output=" + histogram_filepath);
+  EXPECT_TRUE(HasLine(printed, "38 traces, 10 messages from a")) << printed;
+  EXPECT_TRUE(HasLine(printed, "a: 10 samples, mean 100.5 us")) << printed;
+  EXPECT_TRUE(HasLine(printed, "a -> b: 9 samples, mean 200.5 us"))
+      << printed;
+  EXPECT_TRUE(HasLine(printed, "b: 9 samples, mean 300.5 us")) << printed;
+  EXPECT_TRUE(HasLine(printed, "b -> c: 8 samples, mean 50.5 us"))
+      << printed;
+  EXPECT_TRUE(HasLine(printed, "c: 8 samples, mean 400.5 us")) << printed;
+  EXPECT_TRUE(HasLine(printed, "end to end: 8 samples, mean 1052.5 us"))
+      << printed;
+  EXPECT_TRUE(HasLine(printed, "1 messages of a were not traced by b"))
+      << printed;
+  EXPECT_TRUE(HasLine(printed, "1 messages of b were not traced by c"))
+      << printed;
+
+  // Every histogram is written
+  std::ifstream file(histogram_filepath);
+  std::stringstream written;
+  written << file.rdbuf();
+  for (const string name : {"a", "a -> b", "b", "b -> c", "c", "end to end"}) {
+    EXPECT_TRUE(HasLine(written.str(), "# " + name + ": upper edge (us)"))
+        << name;
+  }
+}
+
+GTEST_TEST(PipelineLatencyTest, MatchesOnlyOneMicrosecondLower) {
+  // A utime two microseconds lower is another message
+  const string log_filepath = TempPath("pipeline_latency_test_gap.lcmlog");
+  lcm_eventlog_t* log = lcm_eventlog_create(log_filepath.c_str(), "w");
+  ASSERT_NE(log, nullptr);
+  WriteTrace(log, 1000, "a", 0, 1000);
+  WriteTrace(log, 998, "b", 2000, 3000);
+  lcm_eventlog_destroy(log);
+
+  const string printed = RunPipelineLatency(log_filepath, "--stages=a,b");
+  EXPECT_TRUE(HasLine(printed, "a -> b: 0 samples")) << printed;
+  EXPECT_TRUE(HasLine(printed, "1 messages of a were not traced by b"))
+      << printed;
+}
+
+}  // namespace
+}  // namespace dairlib
@@ -1,5 +1,7 @@
 #include "robot_lcm_systems.h"
 
+#include <stdexcept>
+
 #include "multibody/multibody_utils.h"
 
 namespace dairlib {
@@ -11,25 +13,203 @@ using drake::systems::Context;
 using drake::systems::LeafSystem;
 using Eigen::VectorXd;
 using std::string;
+using std::vector;
 using systems::OutputVector;
 
+namespace {
+
+/// Schema of the efforts of a command
+lcmt_robot_schema MakeCommandSchema(
+    const drake::multibody::MultibodyPlant<double>& plant) {
+  lcmt_robot_schema schema = MakeRobotSchema(plant);
+  schema.num_positions = 0;
+  schema.num_velocities = 0;
+  schema.position_names.clear();
+  schema.velocity_names.clear();
+  schema.fingerprint = RobotSchemaFingerprint(schema);
+  return schema;
+}
+
+/// Index, in messages with the given names, of every element of the plant,
+/// or -1
+/// @throws std::out_of_range if a name is missing from index_map
+vector<int> MakeGather(const vector<string>& names,
+                       const std::map<string, int>& index_map) {
+  vector<int> source(index_map.size(), -1);
+  for (size_t i = 0; i < names.size(); i++) {
+    source[index_map.at(names[i])] = i;
+  }
+  return source;
+}
+
+/// Returns the schema of a schema input port, if connected and of the given
+/// fingerprint, or nullptr
+const lcmt_robot_schema* FindSchema(const drake::AbstractValue* input,
+                                    int64_t fingerprint) {
+  if (input == nullptr) {
+    return nullptr;
+  }
+  const auto& schema = input->get_value<lcmt_robot_schema>();
+  if (schema.fingerprint != fingerprint ||
+      RobotSchemaFingerprint(schema) != fingerprint) {
+    return nullptr;
+  }
+  return &schema;
+}
+
+}  // namespace
+
+int64_t RobotNamesFingerprint(const vector<string>& position_names,
+                              const vector<string>& velocity_names,
+                              const vector<string>& effort_names) {
+  // 64 bit FNV-1a of the names, each followed by a null character
+  uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](const string& name) {
+    for (const char c : name) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    hash *= 1099511628211ull;
+  };
+  for (const auto* names : {&position_names, &velocity_names, &effort_names}) {
+    add(std::to_string(names->size()));
+    for (const auto& name : *names) {
+      add(name);
+    }
+  }
+  return static_cast<int64_t>(hash);
+}
+
+int64_t RobotSchemaFingerprint(const lcmt_robot_schema& schema) {
+  return RobotNamesFingerprint(schema.position_names, schema.velocity_names,
+                               schema.effort_names);
+}
+
+lcmt_robot_schema MakeRobotSchema(
+    const drake::multibody::MultibodyPlant<double>& plant) {
+  lcmt_robot_schema schema;
+  vector<string> state_names = multibody::createStateNameVectorFromMap(plant);
+  schema.position_names.assign(state_names.begin(),
+                               state_names.begin() + plant.num_positions());
+  schema.velocity_names.assign(state_names.begin() + plant.num_positions(),
+                               state_names.end());
+  schema.effort_names = multibody::createActuatorNameVectorFromMap(plant);
+  schema.num_positions = schema.position_names.size();
+  schema.num_velocities = schema.velocity_names.size();
+  schema.num_efforts = schema.effort_names.size();
+  schema.fingerprint = RobotSchemaFingerprint(schema);
+  return schema;
+}
+
+/*--------------------------------------------------------------------------*/
+// methods implementation for RobotMessageLayouts.
+
+RobotMessageLayouts::RobotMessageLayouts(
+    std::map<string, int> position_index_map,
+    std::map<string, int> velocity_index_map,
+    std::map<string, int> effort_index_map)
+    : position_index_map_(std::move(position_index_map)),
+      velocity_index_map_(std::move(velocity_index_map)),
+      effort_index_map_(std::move(effort_index_map)) {}
+
+const RobotMessageLayouts::Layout& RobotMessageLayouts::Get(
+    const vector<string>& position_names,
+    const vector<string>& velocity_names,
+    const vector<string>& effort_names) const {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (last_layout_ != nullptr &&
+        last_layout_->position_names == position_names &&
+        last_layout_->velocity_names == velocity_names &&
+        last_layout_->effort_names == effort_names) {
+      return *last_layout_;
+    }
+  }
+  int64_t fingerprint =
+      RobotNamesFingerprint(position_names, velocity_names, effort_names);
+  const Layout* layout = Find(fingerprint);
+  if (layout == nullptr) {
+    layout = &Add(fingerprint, position_names, velocity_names, effort_names);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  last_layout_ = layout;
+  return *layout;
+}
+
+const RobotMessageLayouts::Layout& RobotMessageLayouts::Get(
+    const lcmt_robot_schema& schema) const {
+  const Layout* layout = Find(schema.fingerprint);
+  if (layout != nullptr) {
+    return *layout;
+  }
+  return Add(schema.fingerprint, schema.position_names,
+             schema.velocity_names, schema.effort_names);
+}
+
+const RobotMessageLayouts::Layout* RobotMessageLayouts::Find(
+    int64_t fingerprint) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = layouts_.find(fingerprint);
+  return (it == layouts_.end()) ? nullptr : &it->second;
+}
+
+const RobotMessageLayouts::Layout& RobotMessageLayouts::Add(
+    int64_t fingerprint, const vector<string>& position_names,
+    const vector<string>& velocity_names,
+    const vector<string>& effort_names) const {
+  Layout layout;
+  layout.num_positions = position_names.size();
+  layout.num_velocities = velocity_names.size();
+  layout.num_efforts = effort_names.size();
+  layout.positions = MakeGather(position_names, position_index_map_);
+  layout.velocities = MakeGather(velocity_names, velocity_index_map_);
+  layout.efforts = MakeGather(effort_names, effort_index_map_);
+  layout.position_names = position_names;
+  layout.velocity_names = velocity_names;
+  layout.effort_names = effort_names;
+  std::lock_guard<std::mutex> lock(mutex_);
+  return layouts_.emplace(fingerprint, std::move(layout)).first->second;
+}
+
+void RobotMessageLayouts::Gather(const vector<int>& source,
+                                 const double* values,
+                                 Eigen::Ref<VectorXd> output) {
+  for (size_t i = 0; i < source.size(); i++) {
+    output(i) = (source[i] < 0) ? 0 : values[source[i]];
+  }
+}
+
 /*--------------------------------------------------------------------------*/
 // methods implementation for RobotOutputReceiver.
 
 RobotOutputReceiver::RobotOutputReceiver(
-    const drake::multibody::MultibodyPlant<double>& plant) {
+    const drake::multibody::MultibodyPlant<double>& plant,
+    RobotMessageFormat format)
+    : layouts_(multibody::makeNameToPositionsMap(plant),
+               multibody::makeNameToVelocitiesMap(plant),
+               multibody::makeNameToActuatorsMap(plant)) {
   num_positions_ = plant.num_positions();
   num_velocities_ = plant.num_velocities();
   num_efforts_ = plant.num_actuators();
-  positionIndexMap_ = multibody::makeNameToPositionsMap(plant);
-  velocityIndexMap_ = multibody::makeNameToVelocitiesMap(plant);
-  effortIndexMap_ = multibody::makeNameToActuatorsMap(plant);
-  this->DeclareAbstractInputPort("lcmt_robot_output",
-                                 drake::Value<dairlib::lcmt_robot_output>{});
-  this->DeclareVectorOutputPort(
-      OutputVector<double>(plant.num_positions(), plant.num_velocities(),
-                           plant.num_actuators()),
-      &RobotOutputReceiver::CopyOutput);
+  OutputVector<double> model_vector(
+      plant.num_positions(), plant.num_velocities(), plant.num_actuators());
+  if (format == RobotMessageFormat::kFull) {
+    this->DeclareAbstractInputPort("lcmt_robot_output",
+                                   drake::Value<dairlib::lcmt_robot_output>{});
+    this->DeclareVectorOutputPort(model_vector,
+                                  &RobotOutputReceiver::CopyOutput);
+  } else {
+    this->DeclareAbstractInputPort(
+        "lcmt_robot_output_compact",
+        drake::Value<dairlib::lcmt_robot_output_compact>{});
+    schema_input_port_ =
+        this->DeclareAbstractInputPort("lcmt_robot_schema",
+                                       drake::Value<lcmt_robot_schema>{})
+            .get_index();
+    this->DeclareVectorOutputPort(model_vector,
+                                  &RobotOutputReceiver::CopyCompactOutput);
+  }
+  // Messages of the same model need no schema
+  layouts_.Get(MakeRobotSchema(plant));
 }
 
 void RobotOutputReceiver::CopyOutput(const Context<double>& context,
@@ -38,20 +218,72 @@ void RobotOutputReceiver::CopyOutput(const Context<double>& context,
   DRAKE_ASSERT(input != nullptr);
   const auto& state_msg = input->get_value<dairlib::lcmt_robot_output>();
 
-  VectorXd positions = VectorXd::Zero(num_positions_);
-  for (int i = 0; i < state_msg.num_positions; i++) {
-    int j = positionIndexMap_.at(state_msg.position_names[i]);
-    positions(j) = state_msg.position[i];
+  const auto& layout = layouts_.Get(
+      state_msg.position_names, state_msg.velocity_names,
+      state_msg.effort_names);
+  RobotMessageLayouts::Gather(layout.positions, state_msg.position.data(),
+                              output->GetMutablePositions());
+  RobotMessageLayouts::Gather(layout.velocities, state_msg.velocity.data(),
+                              output->GetMutableVelocities());
+  if (num_efforts_ > 0) {
+    RobotMessageLayouts::Gather(layout.efforts, state_msg.effort.data(),
+                                output->GetMutableEfforts());
   }
-  VectorXd velocities = VectorXd::Zero(num_velocities_);
-  for (int i = 0; i < state_msg.num_velocities; i++) {
-    int j = velocityIndexMap_.at(state_msg.velocity_names[i]);
-    velocities(j) = state_msg.velocity[i];
+
+  VectorXd imu = VectorXd::Zero(3);
+  if (num_positions_ != num_velocities_) {
+    for (int i = 0; i < 3; ++i) {
+      imu[i] = state_msg.imu_accel[i];
+    }
   }
-  VectorXd efforts = VectorXd::Zero(num_efforts_);
-  for (int i = 0; i < state_msg.num_efforts; i++) {
-    int j = effortIndexMap_.at(state_msg.effort_names[i]);
-    efforts(j) = state_msg.effort[j];
+  output->SetIMUAccelerations(imu);
+  output->set_timestamp(state_msg.utime * 1.0e-6);
+}
+
+void RobotOutputReceiver::CopyCompactOutput(
+    const Context<double>& context, OutputVector<double>* output) const {
+  const drake::AbstractValue* input = this->EvalAbstractInput(context, 0);
+  DRAKE_ASSERT(input != nullptr);
+  const auto& state_msg =
+      input->get_value<dairlib::lcmt_robot_output_compact>();
+
+  // Until the first message, the output is zero as for full messages
+  if (state_msg.num_positions + state_msg.num_velocities +
+          state_msg.num_efforts == 0) {
+    output->SetFromVector(VectorXd::Zero(output->size()));
+    output->set_timestamp(state_msg.utime * 1.0e-6);
+    return;
+  }
+
+  const RobotMessageLayouts::Layout* layout =
+      layouts_.Find(state_msg.schema);
+  if (layout == nullptr) {
+    const lcmt_robot_schema* schema = FindSchema(
+        this->EvalAbstractInput(context, schema_input_port_),
+        state_msg.schema);
+    if (schema == nullptr) {
+      throw std::runtime_error(
+          "Received lcmt_robot_output_compact of unknown schema " +
+          std::to_string(state_msg.schema));
+    }
+    layout = &layouts_.Get(*schema);
+  }
+  if (state_msg.num_positions != layout->num_positions ||
+      state_msg.num_velocities != layout->num_velocities ||
+      (state_msg.num_efforts != 0 &&
+       state_msg.num_efforts != layout->num_efforts)) {
+    throw std::runtime_error(
+        "lcmt_robot_output_compact does not match its schema");
+  }
+  RobotMessageLayouts::Gather(layout->positions, state_msg.position.data(),
+                              output->GetMutablePositions());
+  RobotMessageLayouts::Gather(layout->velocities, state_msg.velocity.data(),
+                              output->GetMutableVelocities());
+  if (num_efforts_ > 0 && state_msg.num_efforts == 0) {
+    output->GetMutableEfforts().setZero();
+  } else if (num_efforts_ > 0) {
+    RobotMessageLayouts::Gather(layout->efforts, state_msg.effort.data(),
+                                output->GetMutableEfforts());
   }
 
   VectorXd imu = VectorXd::Zero(3);
@@ -60,10 +292,6 @@ void RobotOutputReceiver::CopyOutput(const Context<double>& context,
       imu[i] = state_msg.imu_accel[i];
     }
   }
-
-  output->SetPositions(positions);
-  output->SetVelocities(velocities);
-  output->SetEfforts(efforts);
   output->SetIMUAccelerations(imu);
   output->set_timestamp(state_msg.utime * 1.0e-6);
 }
@@ -73,7 +301,8 @@ void RobotOutputReceiver::CopyOutput(const Context<double>& context,
 
 RobotOutputSender::RobotOutputSender(
     const drake::multibody::MultibodyPlant<double>& plant,
-    const bool publish_efforts, const bool publish_imu)
+    const bool publish_efforts, const bool publish_imu,
+    RobotMessageFormat format)
     : publish_efforts_(publish_efforts), publish_imu_(publish_imu) {
   num_positions_ = plant.num_positions();
   num_velocities_ = plant.num_velocities();
@@ -125,7 +354,17 @@ RobotOutputSender::RobotOutputSender(
         this->DeclareVectorInputPort(BasicVector<double>(3)).get_index();
   }
 
-  this->DeclareAbstractOutputPort(&RobotOutputSender::Output);
+  if (format == RobotMessageFormat::kFull) {
+    this->DeclareAbstractOutputPort(&RobotOutputSender::Output);
+  } else {
+    // Messages without efforts share the schema of the plant, so that
+    // receivers of the same model need no schema
+    schema_ = MakeRobotSchema(plant);
+    this->DeclareAbstractOutputPort(&RobotOutputSender::OutputCompact);
+    schema_output_port_ =
+        this->DeclareAbstractOutputPort(&RobotOutputSender::OutputSchema)
+            .get_index();
+  }
 }
 
 /// Populate a state message with all states
@@ -173,17 +412,68 @@ void RobotOutputSender::Output(const Context<double>& context,
   }
 }
 
+/// Populate a compact state message with all states
+void RobotOutputSender::OutputCompact(
+    const Context<double>& context,
+    dairlib::lcmt_robot_output_compact* state_msg) const {
+  const auto state = this->EvalVectorInput(context, state_input_port_);
+
+  state_msg->utime = context.get_time() * 1e6;
+  state_msg->schema = schema_.fingerprint;
+  state_msg->num_positions = num_positions_;
+  state_msg->num_velocities = num_velocities_;
+  state_msg->position.assign(state->get_value().data(),
+                             state->get_value().data() + num_positions_);
+  state_msg->velocity.assign(
+      state->get_value().data() + num_positions_,
+      state->get_value().data() + num_positions_ + num_velocities_);
+
+  if (publish_efforts_) {
+    const auto efforts = this->EvalVectorInput(context, effort_input_port_);
+    state_msg->num_efforts = num_efforts_;
+    state_msg->effort.assign(efforts->get_value().data(),
+                             efforts->get_value().data() + num_efforts_);
+  }
+
+  if (publish_imu_) {
+    const auto imu = this->EvalVectorInput(context, imu_input_port_);
+    for (int i = 0; i < 3; ++i) {
+      state_msg->imu_accel[i] = imu->get_value()[i];
+    }
+  }
+}
+
+void RobotOutputSender::OutputSchema(const Context<double>& context,
+                                     lcmt_robot_schema* schema) const {
+  *schema = schema_;
+}
+
 /*--------------------------------------------------------------------------*/
 // methods implementation for RobotInputReceiver.
 
 RobotInputReceiver::RobotInputReceiver(
-    const drake::multibody::MultibodyPlant<double>& plant) {
+    const drake::multibody::MultibodyPlant<double>& plant,
+    RobotMessageFormat format)
+    : layouts_({}, {}, multibody::makeNameToActuatorsMap(plant)) {
   num_actuators_ = plant.num_actuators();
-  actuatorIndexMap_ = multibody::makeNameToActuatorsMap(plant);
-  this->DeclareAbstractInputPort("lcmt_robot_input",
-                                 drake::Value<dairlib::lcmt_robot_input>{});
-  this->DeclareVectorOutputPort(TimestampedVector<double>(num_actuators_),
-                                &RobotInputReceiver::CopyInputOut);
+  if (format == RobotMessageFormat::kFull) {
+    this->DeclareAbstractInputPort("lcmt_robot_input",
+                                   drake::Value<dairlib::lcmt_robot_input>{});
+    this->DeclareVectorOutputPort(TimestampedVector<double>(num_actuators_),
+                                  &RobotInputReceiver::CopyInputOut);
+  } else {
+    this->DeclareAbstractInputPort(
+        "lcmt_robot_input_compact",
+        drake::Value<dairlib::lcmt_robot_input_compact>{});
+    schema_input_port_ =
+        this->DeclareAbstractInputPort("lcmt_robot_schema",
+                                       drake::Value<lcmt_robot_schema>{})
+            .get_index();
+    this->DeclareVectorOutputPort(TimestampedVector<double>(num_actuators_),
+                                  &RobotInputReceiver::CopyCompactInputOut);
+  }
+  // Commands of the same model need no schema
+  layouts_.Get(MakeCommandSchema(plant));
 }
 
 void RobotInputReceiver::CopyInputOut(const Context<double>& context,
@@ -192,13 +482,47 @@ void RobotInputReceiver::CopyInputOut(const Context<double>& context,
   DRAKE_ASSERT(input != nullptr);
   const auto& input_msg = input->get_value<dairlib::lcmt_robot_input>();
 
-  VectorXd input_vector = VectorXd::Zero(num_actuators_);
+  static const vector<string> no_names;
+  const auto& layout =
+      layouts_.Get(no_names, no_names, input_msg.effort_names);
+  RobotMessageLayouts::Gather(layout.efforts, input_msg.efforts.data(),
+                              output->get_mutable_data());
+  output->set_timestamp(input_msg.utime * 1.0e-6);
+}
 
-  for (int i = 0; i < input_msg.num_efforts; i++) {
-    int j = actuatorIndexMap_.at(input_msg.effort_names[i]);
-    input_vector(j) = input_msg.efforts[i];
+void RobotInputReceiver::CopyCompactInputOut(
+    const Context<double>& context, TimestampedVector<double>* output) const {
+  const drake::AbstractValue* input = this->EvalAbstractInput(context, 0);
+  DRAKE_ASSERT(input != nullptr);
+  const auto& input_msg =
+      input->get_value<dairlib::lcmt_robot_input_compact>();
+
+  // Until the first message, the output is zero as for full messages
+  if (input_msg.num_efforts == 0) {
+    output->SetDataVector(VectorXd::Zero(num_actuators_));
+    output->set_timestamp(input_msg.utime * 1.0e-6);
+    return;
   }
-  output->SetDataVector(input_vector);
+
+  const RobotMessageLayouts::Layout* layout =
+      layouts_.Find(input_msg.schema);
+  if (layout == nullptr) {
+    const lcmt_robot_schema* schema = FindSchema(
+        this->EvalAbstractInput(context, schema_input_port_),
+        input_msg.schema);
+    if (schema == nullptr) {
+      throw std::runtime_error(
+          "Received lcmt_robot_input_compact of unknown schema " +
+          std::to_string(input_msg.schema));
+    }
+    layout = &layouts_.Get(*schema);
+  }
+  if (input_msg.num_efforts != layout->num_efforts) {
+    throw std::runtime_error(
+        "lcmt_robot_input_compact does not match its schema");
+  }
+  RobotMessageLayouts::Gather(layout->efforts, input_msg.efforts.data(),
+                              output->get_mutable_data());
   output->set_timestamp(input_msg.utime * 1.0e-6);
 }
 
@@ -206,7 +530,8 @@ void RobotInputReceiver::CopyInputOut(const Context<double>& context,
 // methods implementation for RobotCommandSender.
 
 RobotCommandSender::RobotCommandSender(
-    const drake::multibody::MultibodyPlant<double>& plant) {
+    const drake::multibody::MultibodyPlant<double>& plant,
+    RobotMessageFormat format) {
   num_actuators_ = plant.num_actuators();
   actuatorIndexMap_ = multibody::makeNameToActuatorsMap(plant);
 
@@ -215,7 +540,15 @@ RobotCommandSender::RobotCommandSender(
   }
 
   this->DeclareVectorInputPort(TimestampedVector<double>(num_actuators_));
-  this->DeclareAbstractOutputPort(&RobotCommandSender::OutputCommand);
+  if (format == RobotMessageFormat::kFull) {
+    this->DeclareAbstractOutputPort(&RobotCommandSender::OutputCommand);
+  } else {
+    schema_ = MakeCommandSchema(plant);
+    this->DeclareAbstractOutputPort(&RobotCommandSender::OutputCompactCommand);
+    schema_output_port_ =
+        this->DeclareAbstractOutputPort(&RobotCommandSender::OutputSchema)
+            .get_index();
+  }
 }
 
 void RobotCommandSender::OutputCommand(
@@ -234,5 +567,25 @@ void RobotCommandSender::OutputCommand(
   }
 }
 
+void RobotCommandSender::OutputCompactCommand(
+    const Context<double>& context,
+    dairlib::lcmt_robot_input_compact* input_msg) const {
+  const TimestampedVector<double>* command =
+      (TimestampedVector<double>*)this->EvalVectorInput(context, 0);
+
+  input_msg->utime = command->get_timestamp() * 1e6;
+  input_msg->schema = schema_.fingerprint;
+  input_msg->num_efforts = num_actuators_;
+  input_msg->efforts.resize(num_actuators_);
+  for (int i = 0; i < num_actuators_; i++) {
+    input_msg->efforts[i] = command->GetAtIndex(i);
+  }
+}
+
+void RobotCommandSender::OutputSchema(const Context<double>& context,
+                                      lcmt_robot_schema* schema) const {
+  *schema = schema_;
+}
+
 }  // namespace systems
 }  // namespace dairlib
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "dairlib/lcmt_robot_input.hpp"
+#include "dairlib/lcmt_robot_input_compact.hpp"
 #include "dairlib/lcmt_robot_output.hpp"
+#include "dairlib/lcmt_robot_output_compact.hpp"
+#include "dairlib/lcmt_robot_schema.hpp"
 #include "systems/framework/output_vector.h"
 #include "systems/framework/timestamped_vector.h"
 
@@ -19,31 +23,137 @@ namespace systems {
 /// LCM messages related to a robot. The classes in this file are based on
 /// acrobot_lcm.h
 
+/// Formats of the robot state and command messages.
+///
+/// kFull messages (lcmt_robot_output, lcmt_robot_input) carry the name of
+/// every position, velocity and effort.
+///
+/// kCompact messages (lcmt_robot_output_compact, lcmt_robot_input_compact)
+/// only carry the values, and the fingerprint of their names. The names are
+/// sent separately as an lcmt_robot_schema, by convention on the channel
+/// <channel>_SCHEMA at a low rate. A receiver only needs the schema if the
+/// sender orders its names differently, e.g. when the sender uses another
+/// model of the robot.
+enum class RobotMessageFormat { kFull, kCompact };
+
+/// Returns the fingerprint of the names of schema, ignoring its fingerprint
+int64_t RobotSchemaFingerprint(const lcmt_robot_schema& schema);
+
+/// Returns the fingerprint of the names of the elements of a message, as in
+/// the schema of the message
+int64_t RobotNamesFingerprint(const std::vector<std::string>& position_names,
+                              const std::vector<std::string>& velocity_names,
+                              const std::vector<std::string>& effort_names);
+
+/// Returns the schema, with its fingerprint, of the positions, velocities and
+/// actuators of plant
+lcmt_robot_schema MakeRobotSchema(
+    const drake::multibody::MultibodyPlant<double>& plant);
+
+/// Layouts of the messages received for a plant, which gather the elements
+/// of messages into the order of the plant.
+///
+/// The layout of every list of names is computed once, and cached by the
+/// fingerprint of the names. Consecutive messages with the same names, as
+/// from a single sender, reuse the last layout after comparing the names,
+/// without hashing them.
+class RobotMessageLayouts {
+ public:
+  struct Layout {
+    /// Number of elements of messages
+    int num_positions;
+    int num_velocities;
+    int num_efforts;
+    /// Index, in messages, of every element of the plant, or -1 if missing
+    std::vector<int> positions;
+    std::vector<int> velocities;
+    std::vector<int> efforts;
+    std::vector<std::string> position_names;
+    std::vector<std::string> velocity_names;
+    std::vector<std::string> effort_names;
+  };
+
+  /// Takes the index, in the plant, of every name. Receivers of commands
+  /// have no positions nor velocities.
+  RobotMessageLayouts(std::map<std::string, int> position_index_map,
+                      std::map<std::string, int> velocity_index_map,
+                      std::map<std::string, int> effort_index_map);
+
+  /// Returns the layout of messages with the given names
+  /// @throws std::out_of_range if a name is not in the plant
+  const Layout& Get(const std::vector<std::string>& position_names,
+                    const std::vector<std::string>& velocity_names,
+                    const std::vector<std::string>& effort_names) const;
+
+  /// Returns the layout of schema, adding it if needed
+  /// @throws std::out_of_range if a name is not in the plant
+  const Layout& Get(const lcmt_robot_schema& schema) const;
+
+  /// Returns the cached layout of fingerprint, or nullptr
+  const Layout* Find(int64_t fingerprint) const;
+
+  /// Sets output(i) to values[source[i]], or to 0 if source[i] is -1
+  static void Gather(const std::vector<int>& source, const double* values,
+                     Eigen::Ref<Eigen::VectorXd> output);
+
+ private:
+  const Layout& Add(int64_t fingerprint,
+                    const std::vector<std::string>& position_names,
+                    const std::vector<std::string>& velocity_names,
+                    const std::vector<std::string>& effort_names) const;
+
+  std::map<std::string, int> position_index_map_;
+  std::map<std::string, int> velocity_index_map_;
+  std::map<std::string, int> effort_index_map_;
+  mutable std::map<int64_t, Layout> layouts_;
+  mutable const Layout* last_layout_ = nullptr;
+  mutable std::mutex mutex_;
+};
+
 /// Receives the output of an LcmSubsriberSystem that subsribes to the
 /// Robot output channel with LCM type lcmt_robot_output, and outputs the
 /// robot states as a OutputVector.
+///
+/// With RobotMessageFormat::kCompact, the input port instead takes
+/// lcmt_robot_output_compact, and get_input_port_schema() optionally takes
+/// the lcmt_robot_schema of the sender.
+///
+/// Messages are decoded with the cached RobotMessageLayouts of their names.
 class RobotOutputReceiver : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotOutputReceiver(
-      const drake::multibody::MultibodyPlant<double>& plant);
+      const drake::multibody::MultibodyPlant<double>& plant,
+      RobotMessageFormat format = RobotMessageFormat::kFull);
+
+  /// Only declared for RobotMessageFormat::kCompact
+  const drake::systems::InputPort<double>& get_input_port_schema() const {
+    return this->get_input_port(schema_input_port_);
+  }
 
  private:
   void CopyOutput(const drake::systems::Context<double>& context,
                   OutputVector<double>* output) const;
+  void CopyCompactOutput(const drake::systems::Context<double>& context,
+                         OutputVector<double>* output) const;
+
   int num_positions_;
   int num_velocities_;
   int num_efforts_;
-  std::map<std::string, int> positionIndexMap_;
-  std::map<std::string, int> velocityIndexMap_;
-  std::map<std::string, int> effortIndexMap_;
+  int schema_input_port_ = -1;
+  RobotMessageLayouts layouts_;
 };
 
 /// Converts a OutputVector object to LCM type lcmt_robot_output
+///
+/// With RobotMessageFormat::kCompact, the output port is instead of type
+/// lcmt_robot_output_compact, and get_output_port_schema() outputs the
+/// lcmt_robot_schema of the messages.
 class RobotOutputSender : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotOutputSender(
       const drake::multibody::MultibodyPlant<double>& plant,
-      const bool publish_efforts = false, const bool publish_imu = false);
+      const bool publish_efforts = false, const bool publish_imu = false,
+      RobotMessageFormat format = RobotMessageFormat::kFull);
 
   const drake::systems::InputPort<double>& get_input_port_state() const {
     return this->get_input_port(state_input_port_);
@@ -57,9 +167,18 @@ class RobotOutputSender : public drake::systems::LeafSystem<double> {
     return this->get_input_port(imu_input_port_);
   }
 
+  /// Only declared for RobotMessageFormat::kCompact
+  const drake::systems::OutputPort<double>& get_output_port_schema() const {
+    return this->get_output_port(schema_output_port_);
+  }
+
  private:
   void Output(const drake::systems::Context<double>& context,
               dairlib::lcmt_robot_output* output) const;
+  void OutputCompact(const drake::systems::Context<double>& context,
+                     dairlib::lcmt_robot_output_compact* output) const;
+  void OutputSchema(const drake::systems::Context<double>& context,
+                    lcmt_robot_schema* schema) const;
 
   int num_positions_;
   int num_velocities_;
@@ -73,41 +192,74 @@ class RobotOutputSender : public drake::systems::LeafSystem<double> {
   int state_input_port_;
   int effort_input_port_;
   int imu_input_port_;
+  int schema_output_port_ = -1;
   bool publish_efforts_;
   bool publish_imu_;
+  lcmt_robot_schema schema_;
 };
 
 /// Receives the output of an LcmSubsriberSystem that subsribes to the
 /// robot input channel with LCM type lcmt_robot_input and outputs the
 /// robot inputs as a TimestampedVector.
+///
+/// With RobotMessageFormat::kCompact, the input port instead takes
+/// lcmt_robot_input_compact, and get_input_port_schema() optionally takes
+/// the lcmt_robot_schema of the sender.
+///
+/// Messages are decoded with the cached RobotMessageLayouts of their names.
 class RobotInputReceiver : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotInputReceiver(
-      const drake::multibody::MultibodyPlant<double>& plant);
+      const drake::multibody::MultibodyPlant<double>& plant,
+      RobotMessageFormat format = RobotMessageFormat::kFull);
+
+  /// Only declared for RobotMessageFormat::kCompact
+  const drake::systems::InputPort<double>& get_input_port_schema() const {
+    return this->get_input_port(schema_input_port_);
+  }
 
  private:
   void CopyInputOut(const drake::systems::Context<double>& context,
                     TimestampedVector<double>* output) const;
+  void CopyCompactInputOut(const drake::systems::Context<double>& context,
+                           TimestampedVector<double>* output) const;
 
   int num_actuators_;
-  std::map<std::string, int> actuatorIndexMap_;
+  int schema_input_port_ = -1;
+  RobotMessageLayouts layouts_;
 };
 
 /// Receives the output of a controller, and outputs it as an LCM
 /// message with type lcm_robot_u. Its output port is usually connected to
 /// an LcmPublisherSystem to publish the messages it generates.
+///
+/// With RobotMessageFormat::kCompact, the output port is instead of type
+/// lcmt_robot_input_compact, and get_output_port_schema() outputs the
+/// lcmt_robot_schema of the messages.
 class RobotCommandSender : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotCommandSender(
-      const drake::multibody::MultibodyPlant<double>& plant);
+      const drake::multibody::MultibodyPlant<double>& plant,
+      RobotMessageFormat format = RobotMessageFormat::kFull);
+
+  /// Only declared for RobotMessageFormat::kCompact
+  const drake::systems::OutputPort<double>& get_output_port_schema() const {
+    return this->get_output_port(schema_output_port_);
+  }
 
  private:
   void OutputCommand(const drake::systems::Context<double>& context,
                      dairlib::lcmt_robot_input* output) const;
+  void OutputCompactCommand(const drake::systems::Context<double>& context,
+                            dairlib::lcmt_robot_input_compact* output) const;
+  void OutputSchema(const drake::systems::Context<double>& context,
+                    lcmt_robot_schema* schema) const;
 
   int num_actuators_;
   std::vector<std::string> ordered_actuator_names_;
   std::map<std::string, int> actuatorIndexMap_;
+  int schema_output_port_ = -1;
+  lcmt_robot_schema schema_;
 };
 
 }  // namespace systems
@@ -0,0 +1,237 @@
+#include "systems/robot_lcm_systems.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "multibody/multibody_utils.h"
+
+#include "drake/math/rigid_transform.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::systems::BasicVector;
+using Eigen::VectorXd;
+
+class RobotLcmSystemsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    drake::multibody::Parser parser(&plant_);
+    parser.AddModelFromFile(
+        FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf"));
+    plant_.WeldFrames(plant_.world_frame(), plant_.GetFrameByName("base"),
+                      drake::math::RigidTransform<double>());
+    plant_.Finalize();
+    nq_ = plant_.num_positions();
+    nv_ = plant_.num_velocities();
+    nu_ = plant_.num_actuators();
+    std::srand(0);
+    x_ = VectorXd::Random(nq_ + nv_);
+    u_ = VectorXd::Random(nu_);
+  }
+
+  /// Decodes a message with the receiver, and with the given schema, if any
+  template <typename Message>
+  const OutputVector<double>& Receive(
+      const RobotOutputReceiver& receiver,
+      drake::systems::Context<double>* context, const Message& msg,
+      const lcmt_robot_schema* schema = nullptr) {
+    receiver.get_input_port(0).FixValue(context, msg);
+    if (schema != nullptr) {
+      receiver.get_input_port_schema().FixValue(context, *schema);
+    }
+    return dynamic_cast<const OutputVector<double>&>(
+        receiver.get_output_port(0).Eval<BasicVector<double>>(*context));
+  }
+
+  void ExpectOutput(const OutputVector<double>& output, double time) {
+    EXPECT_EQ(output.GetPositions(), x_.head(nq_));
+    EXPECT_EQ(output.GetVelocities(), x_.tail(nv_));
+    EXPECT_EQ(output.GetEfforts(), u_);
+    EXPECT_DOUBLE_EQ(output.get_timestamp(), time);
+  }
+
+  /// Decodes a full message one name at a time, through the name to index
+  /// maps of the plant, leaving missing elements at zero
+  VectorXd DecodeByName(const lcmt_robot_output& msg) {
+    const auto positions = multibody::makeNameToPositionsMap(plant_);
+    const auto velocities = multibody::makeNameToVelocitiesMap(plant_);
+    const auto efforts = multibody::makeNameToActuatorsMap(plant_);
+    VectorXd decoded = VectorXd::Zero(nq_ + nv_ + nu_);
+    for (int i = 0; i < msg.num_positions; i++) {
+      decoded(positions.at(msg.position_names[i])) = msg.position[i];
+    }
+    for (int i = 0; i < msg.num_velocities; i++) {
+      decoded(nq_ + velocities.at(msg.velocity_names[i])) = msg.velocity[i];
+    }
+    for (int i = 0; i < msg.num_efforts; i++) {
+      decoded(nq_ + nv_ + efforts.at(msg.effort_names[i])) = msg.effort[i];
+    }
+    return decoded;
+  }
+
+  /// A full message of x_ and u_, with every list of names reversed
+  lcmt_robot_output MakeReversedMessage() {
+    const lcmt_robot_schema schema = MakeRobotSchema(plant_);
+    lcmt_robot_output msg{};
+    msg.utime = 3000000;
+    msg.num_positions = nq_;
+    msg.num_velocities = nv_;
+    msg.num_efforts = nu_;
+    for (int i = nq_ - 1; i >= 0; i--) {
+      msg.position_names.push_back(schema.position_names[i]);
+      msg.position.push_back(x_(i));
+    }
+    for (int i = nv_ - 1; i >= 0; i--) {
+      msg.velocity_names.push_back(schema.velocity_names[i]);
+      msg.velocity.push_back(x_(nq_ + i));
+    }
+    for (int i = nu_ - 1; i >= 0; i--) {
+      msg.effort_names.push_back(schema.effort_names[i]);
+      msg.effort.push_back(u_(i));
+    }
+    return msg;
+  }
+
+  /// Output of the receiver as [q; v; u]
+  VectorXd Decoded(const OutputVector<double>& output) {
+    VectorXd decoded(nq_ + nv_ + nu_);
+    decoded << output.GetPositions(), output.GetVelocities(),
+        output.GetEfforts();
+    return decoded;
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  int nq_;
+  int nv_;
+  int nu_;
+  VectorXd x_;
+  VectorXd u_;
+};
+
+TEST_F(RobotLcmSystemsTest, CompactRoundTrip) {
+  RobotOutputSender sender(plant_, true, false, RobotMessageFormat::kCompact);
+  auto sender_context = sender.CreateDefaultContext();
+  sender_context->SetTime(1.5);
+  sender.get_input_port_state().FixValue(sender_context.get(), x_);
+  sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+  const auto& msg = sender.get_output_port(0).Eval<lcmt_robot_output_compact>(
+      *sender_context);
+  const auto& schema =
+      sender.get_output_port_schema().Eval<lcmt_robot_schema>(
+          *sender_context);
+  EXPECT_EQ(msg.schema, schema.fingerprint);
+  EXPECT_EQ(schema.fingerprint, RobotSchemaFingerprint(schema));
+
+  // A receiver of the same plant needs no schema
+  RobotOutputReceiver receiver(plant_, RobotMessageFormat::kCompact);
+  auto context = receiver.CreateDefaultContext();
+  ExpectOutput(Receive(receiver, context.get(), msg), 1.5);
+}
+
+TEST_F(RobotLcmSystemsTest, CompactPermutedSchema) {
+  // A sender whose model orders every element in reverse
+  lcmt_robot_schema schema = MakeRobotSchema(plant_);
+  std::reverse(schema.position_names.begin(), schema.position_names.end());
+  std::reverse(schema.velocity_names.begin(), schema.velocity_names.end());
+  std::reverse(schema.effort_names.begin(), schema.effort_names.end());
+  schema.fingerprint = RobotSchemaFingerprint(schema);
+  ASSERT_NE(schema.fingerprint, MakeRobotSchema(plant_).fingerprint);
+
+  lcmt_robot_output_compact msg{};
+  msg.utime = 2000000;
+  msg.schema = schema.fingerprint;
+  msg.num_positions = nq_;
+  msg.num_velocities = nv_;
+  msg.num_efforts = nu_;
+  const VectorXd q = x_.head(nq_).reverse();
+  const VectorXd v = x_.tail(nv_).reverse();
+  const VectorXd u = u_.reverse();
+  msg.position.assign(q.data(), q.data() + nq_);
+  msg.velocity.assign(v.data(), v.data() + nv_);
+  msg.effort.assign(u.data(), u.data() + nu_);
+
+  RobotOutputReceiver receiver(plant_, RobotMessageFormat::kCompact);
+  auto context = receiver.CreateDefaultContext();
+  ExpectOutput(Receive(receiver, context.get(), msg, &schema), 2);
+
+  // An unknown fingerprint, with or without a schema of another fingerprint
+  msg.schema = schema.fingerprint + 1;
+  RobotOutputReceiver other_receiver(plant_, RobotMessageFormat::kCompact);
+  auto other_context = other_receiver.CreateDefaultContext();
+  EXPECT_THROW(Receive(other_receiver, other_context.get(), msg),
+               std::runtime_error);
+  EXPECT_THROW(Receive(other_receiver, other_context.get(), msg, &schema),
+               std::runtime_error);
+}
+
+TEST_F(RobotLcmSystemsTest, FullRoundTrip) {
+  RobotOutputSender sender(plant_, true);
+  auto sender_context = sender.CreateDefaultContext();
+  sender_context->SetTime(1.5);
+  sender.get_input_port_state().FixValue(sender_context.get(), x_);
+  sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+  const auto& msg =
+      sender.get_output_port(0).Eval<lcmt_robot_output>(*sender_context);
+
+  RobotOutputReceiver receiver(plant_);
+  auto context = receiver.CreateDefaultContext();
+  ExpectOutput(Receive(receiver, context.get(), msg), 1.5);
+}
+
+TEST_F(RobotLcmSystemsTest, FullPermutedNames) {
+  // Efforts in another order than the plant are read from their own index in
+  // the message
+  const lcmt_robot_output msg = MakeReversedMessage();
+  ASSERT_GT(nu_, 1);
+  RobotOutputReceiver receiver(plant_);
+  auto context = receiver.CreateDefaultContext();
+  const auto& output = Receive(receiver, context.get(), msg);
+  ExpectOutput(output, 3);
+  EXPECT_EQ(Decoded(output), DecodeByName(msg));
+}
+
+TEST_F(RobotLcmSystemsTest, FullMissingElements) {
+  RobotOutputReceiver receiver(plant_);
+  auto context = receiver.CreateDefaultContext();
+
+  // Without efforts
+  lcmt_robot_output msg = MakeReversedMessage();
+  msg.num_efforts = 0;
+  msg.effort_names.clear();
+  msg.effort.clear();
+  VectorXd decoded = Decoded(Receive(receiver, context.get(), msg));
+  EXPECT_EQ(decoded, DecodeByName(msg));
+  EXPECT_TRUE(decoded.tail(nu_).isZero());
+
+  // Without the first position, velocity and effort of the plant, which are
+  // the last of the reversed message
+  msg = MakeReversedMessage();
+  for (auto* names : {&msg.position_names, &msg.velocity_names,
+                      &msg.effort_names}) {
+    names->pop_back();
+  }
+  msg.position.pop_back();
+  msg.velocity.pop_back();
+  msg.effort.pop_back();
+  msg.num_positions--;
+  msg.num_velocities--;
+  msg.num_efforts--;
+  decoded = Decoded(Receive(receiver, context.get(), msg));
+  EXPECT_EQ(decoded, DecodeByName(msg));
+  EXPECT_EQ(decoded(0), 0);
+  EXPECT_EQ(decoded(nq_), 0);
+  EXPECT_EQ(decoded(nq_ + nv_), 0);
+  EXPECT_EQ(decoded.segment(1, nq_ - 1), x_.segment(1, nq_ - 1));
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,239 @@
+#include "systems/trajectory_optimization/dircon/continuation_pipeline.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+namespace {
+
+/// 64-bit FNV-1a, accumulated over successive calls
+class Fnv1aHash {
+ public:
+  void Add(const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      hash_ ^= static_cast<unsigned char>(data[i]);
+      hash_ *= 1099511628211ull;
+    }
+  }
+
+  void Add(const std::string& s) {
+    Add(s.data(), s.size());
+    // Separator, so that ("ab", "c") and ("a", "bc") hash differently
+    Add("", 1);
+  }
+
+  /// Adds the contents of a file. Returns false if it cannot be read.
+  bool AddFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+      file.read(buffer.data(), buffer.size());
+      Add(buffer.data(), file.gcount());
+    }
+    return true;
+  }
+
+  std::string hex() const {
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << hash_;
+    return out.str();
+  }
+
+ private:
+  uint64_t hash_ = 14695981039346656037ull;
+};
+
+bool FileExists(const std::string& filepath) {
+  return std::ifstream(filepath).good();
+}
+
+void CopyFile(const std::string& from, const std::string& to) {
+  std::ifstream src(from, std::ios::binary);
+  std::ofstream dst(to, std::ios::binary);
+  dst << src.rdbuf();
+}
+
+}  // namespace
+
+ContinuationPipeline::ContinuationPipeline(const std::string& cache_prefix,
+                                           const std::string& version)
+    : cache_prefix_(cache_prefix), version_(version) {}
+
+void ContinuationPipeline::SetInitialGuessFile(const std::string& filepath) {
+  initial_guess_file_ = filepath;
+}
+
+void ContinuationPipeline::AddStage(const std::string& name,
+                                    const ContinuationParameters& parameters,
+                                    SolveFunction solve,
+                                    const std::string& output_file) {
+  DRAKE_DEMAND(solve != nullptr);
+  stages_.push_back({name, parameters, std::move(solve), output_file});
+}
+
+void ContinuationPipeline::AddSchedule(const std::string& name,
+                                       const ContinuationParameters& parameters,
+                                       const std::string& scheduled_parameter,
+                                       const std::vector<double>& values,
+                                       SolveFunction solve) {
+  for (int i = 0; i < static_cast<int>(values.size()); i++) {
+    ContinuationParameters stage_parameters = parameters;
+    stage_parameters[scheduled_parameter] = values[i];
+    AddStage(name + "_" + std::to_string(i), stage_parameters, solve);
+  }
+}
+
+std::string ContinuationPipeline::CacheKey(const Stage& stage,
+                                           const std::string& file_in) const {
+  Fnv1aHash hash;
+  hash.Add(version_);
+  hash.Add(stage.name);
+  for (const auto& [key, value] : stage.parameters) {
+    // Hex float, so that the key is exact and independent of locale
+    std::ostringstream value_str;
+    value_str << std::hexfloat << value;
+    hash.Add(key);
+    hash.Add(value_str.str());
+  }
+  if (!file_in.empty() && !hash.AddFile(file_in)) {
+    throw std::runtime_error("ContinuationPipeline: cannot read " + file_in);
+  }
+  return hash.hex();
+}
+
+std::string ContinuationPipeline::Run() {
+  DRAKE_DEMAND(!stages_.empty());
+  stage_files_.clear();
+  num_solved_ = 0;
+
+  std::string file_in = initial_guess_file_;
+  for (const auto& stage : stages_) {
+    std::string file_out =
+        cache_prefix_ + stage.name + "_" + CacheKey(stage, file_in);
+
+    if (FileExists(file_out)) {
+      std::cout << "Stage " << stage.name << ": reusing " << file_out
+                << std::endl;
+    } else {
+      std::cout << "Stage " << stage.name << ": solving" << std::endl;
+      // Solve into a temporary file, so that an interrupted solve never
+      // leaves a partial file in the cache
+      std::string file_tmp = file_out + ".tmp";
+      auto start = std::chrono::steady_clock::now();
+      stage.solve(stage.parameters, file_in, file_tmp);
+      auto finish = std::chrono::steady_clock::now();
+      if (!FileExists(file_tmp) ||
+          std::rename(file_tmp.c_str(), file_out.c_str()) != 0) {
+        throw std::runtime_error("ContinuationPipeline: stage " + stage.name +
+                                 " did not write " + file_tmp);
+      }
+      std::cout << "Stage " << stage.name << ": solved in "
+                << std::chrono::duration<double>(finish - start).count()
+                << "s" << std::endl;
+      num_solved_++;
+    }
+
+    if (!stage.output_file.empty()) {
+      CopyFile(file_out, stage.output_file);
+    }
+    stage_files_.push_back(file_out);
+    file_in = file_out;
+  }
+  return file_in;
+}
+
+int ContinuationPipeline::PruneCache() const {
+  const size_t slash = cache_prefix_.rfind('/');
+  const std::string directory =
+      (slash == std::string::npos) ? "." : cache_prefix_.substr(0, slash + 1);
+  const std::string file_prefix = (slash == std::string::npos)
+                                      ? cache_prefix_
+                                      : cache_prefix_.substr(slash + 1);
+  // Cached files are named prefix + stage name + '_' + a 16-digit key,
+  // followed by ".tmp" while solving
+  auto is_stage_file = [this, &file_prefix](const std::string& name) {
+    for (const auto& stage : stages_) {
+      const std::string stage_prefix = file_prefix + stage.name + "_";
+      if (name.compare(0, stage_prefix.size(), stage_prefix) != 0) {
+        continue;
+      }
+      std::string key = name.substr(stage_prefix.size());
+      if (key.size() == 16 + 4 && key.compare(16, 4, ".tmp") == 0) {
+        key.resize(16);
+      }
+      if (key.size() == 16 &&
+          key.find_first_not_of("0123456789abcdef") == std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+  std::vector<std::string> stale;
+  while (dirent* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    const std::string filepath =
+        (slash == std::string::npos) ? name : directory + name;
+    if (is_stage_file(name) &&
+        std::find(stage_files_.begin(), stage_files_.end(), filepath) ==
+            stage_files_.end()) {
+      stale.push_back(filepath);
+    }
+  }
+  closedir(dir);
+
+  int num_removed = 0;
+  for (const auto& filepath : stale) {
+    if (std::remove(filepath.c_str()) == 0) {
+      num_removed++;
+    }
+  }
+  return num_removed;
+}
+
+std::vector<double> LinearSchedule(double start, double end, int n) {
+  DRAKE_DEMAND(n > 0);
+  if (n == 1) {
+    return {end};
+  }
+  std::vector<double> values(n);
+  for (int i = 0; i < n; i++) {
+    values[i] = start + (end - start) * i / (n - 1);
+  }
+  return values;
+}
+
+std::vector<double> GeometricSchedule(double start, double end, int n) {
+  DRAKE_DEMAND(start > 0 && end > 0);
+  std::vector<double> values =
+      LinearSchedule(std::log(start), std::log(end), n);
+  for (auto& value : values) {
+    value = std::exp(value);
+  }
+  return values;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Named numeric parameters of a continuation stage (cost weights, friction
+/// coefficient, tolerances, ...). Ordered, so that the cache key does not
+/// depend on insertion order.
+using ContinuationParameters = std::map<std::string, double>;
+
+/// ContinuationPipeline runs a sequence of trajectory optimizations, each
+/// warm-started from the saved solution of the previous one, and caches the
+/// saved solution of every stage.
+///
+/// The cache is content-addressed: a stage's output file is named after a hash
+/// of the stage name, its parameters and the contents of its input file. If
+/// that file already exists the stage is skipped. Changing the parameters of
+/// one stage therefore only re-solves that stage and the stages after it;
+/// tweaking the last stage only costs that stage's solve time.
+///
+/// Stages communicate only through files (e.g. DirconTrajectory), so the
+/// pipeline is agnostic to the program being solved. A stage's solve function
+/// must produce the same file for the same parameters and input. Anything else
+/// that changes the result (e.g. an edit to the cost function) should be
+/// reflected in the parameters or in the version passed to the constructor.
+///
+/// Typical usage:
+///   ContinuationPipeline pipeline(FLAGS_data_directory + "cache/");
+///   pipeline.AddStage("in_place", {{"mu", 100}}, solve);
+///   pipeline.AddSchedule("low_mu", {}, "mu", GeometricSchedule(10, 1, 3),
+///                        solve);
+///   std::string final_file = pipeline.Run();
+///   pipeline.PruneCache();
+class ContinuationPipeline {
+ public:
+  /// Solves one stage, reading the initial guess from file_in (empty for a
+  /// first stage without an initial guess file) and writing the solution to
+  /// file_out.
+  using SolveFunction = std::function<void(
+      const ContinuationParameters& parameters, const std::string& file_in,
+      const std::string& file_out)>;
+
+  /// @param cache_prefix Prefix of every cached file, typically a directory
+  ///   ending in '/'
+  /// @param version Mixed into every cache key, to invalidate the cache when
+  ///   the solve functions change
+  explicit ContinuationPipeline(const std::string& cache_prefix,
+                                const std::string& version = "");
+
+  /// Uses an existing file as the input of the first stage
+  void SetInitialGuessFile(const std::string& filepath);
+
+  /// Appends a stage.
+  /// @param output_file If not empty, the solution is also copied here, e.g.
+  ///   to keep the file names expected by other tools.
+  void AddStage(const std::string& name,
+                const ContinuationParameters& parameters, SolveFunction solve,
+                const std::string& output_file = "");
+
+  /// Appends one stage per value of the scheduled parameter, which is
+  /// continued from one stage to the next. Stages are named name_0, name_1...
+  void AddSchedule(const std::string& name,
+                   const ContinuationParameters& parameters,
+                   const std::string& scheduled_parameter,
+                   const std::vector<double>& values, SolveFunction solve);
+
+  /// Runs all stages, reusing cached results where possible. Returns the
+  /// output file of the last stage.
+  std::string Run();
+
+  /// Cached output file of every stage, valid after Run()
+  const std::vector<std::string>& get_stage_files() const {
+    return stage_files_;
+  }
+
+  /// Number of stages that were solved (not reused) in the last Run()
+  int num_solved() const { return num_solved_; }
+
+  /// Removes the cached files of the stages of this pipeline other than those
+  /// of the last Run(), i.e. the solutions of earlier parameters, inputs or
+  /// versions, which otherwise accumulate in the cache. Files of stages with
+  /// other names are kept. Returns the number of removed files.
+  int PruneCache() const;
+
+ private:
+  struct Stage {
+    std::string name;
+    ContinuationParameters parameters;
+    SolveFunction solve;
+    std::string output_file;
+  };
+
+  std::string CacheKey(const Stage& stage, const std::string& file_in) const;
+
+  const std::string cache_prefix_;
+  const std::string version_;
+  std::string initial_guess_file_;
+  std::vector<Stage> stages_;
+  std::vector<std::string> stage_files_;
+  int num_solved_ = 0;
+};
+
+/// n values spaced evenly from start to end, inclusive
+std::vector<double> LinearSchedule(double start, double end, int n);
+
+/// n values spaced evenly in log-space from start to end, inclusive. Both must
+/// be positive.
+std::vector<double> GeometricSchedule(double start, double end, int n);
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
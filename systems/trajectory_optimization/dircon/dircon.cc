@@ -1,9 +1,13 @@
 #include "systems/trajectory_optimization/dircon/dircon.h"
 
+#include <unordered_map>
+
 #include "multibody/kinematic/kinematic_constraints.h"
 #include "multibody/multibody_utils.h"
 #include "systems/trajectory_optimization/dircon/dircon_opt_constraints.h"
 
+#include "drake/common/symbolic_decompose.h"
+
 namespace dairlib {
 namespace systems {
 namespace trajectory_optimization {
@@ -67,10 +71,15 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
       double min_dt = mode.min_T() / (mode.num_knotpoints() - 1);
       double max_dt = mode.max_T() / (mode.num_knotpoints() - 1);
       AddBoundingBoxConstraint(min_dt, max_dt, timestep(mode_start_[i_mode]));
+      // all timesteps must be equal, h_j - h_{j+1} = 0. A single constraint
+      // object is shared by all pairs, avoiding symbolic parsing.
+      auto timestep_constraint =
+          std::make_shared<drake::solvers::LinearEqualityConstraint>(
+              Eigen::RowVector2d(1, -1), VectorXd::Zero(1));
       for (int j = 0; j < mode.num_knotpoints() - 2; j++) {
-        // all timesteps must be equal
-        AddLinearConstraint(timestep(mode_start_[i_mode] + j) ==
-            timestep(mode_start_[i_mode] + j + 1));
+        AddConstraint(timestep_constraint,
+                      {timestep(mode_start_[i_mode] + j),
+                       timestep(mode_start_[i_mode] + j + 1)});
       }
     }
 
@@ -251,12 +260,17 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
         // Add empty decision variables
         impulse_vars_.push_back(NewContinuousVariables(0, ""));
 
-        // Linear equality constraint on velocity variables
+        // Linear equality constraint on velocity variables, v_- - v_+ = 0
+        int n_v = plant_.num_velocities();
         VectorXDecisionVariable pre_impact_velocity =
-            state_vars(i_mode - 1, pre_impact_index)
-                .tail(plant_.num_velocities());
-        AddLinearConstraint(pre_impact_velocity ==
-            post_impact_velocity_vars(i_mode - 1));
+            state_vars(i_mode - 1, pre_impact_index).tail(n_v);
+        MatrixXd A_velocity(n_v, 2 * n_v);
+        A_velocity << MatrixXd::Identity(n_v, n_v),
+            -MatrixXd::Identity(n_v, n_v);
+        AddConstraint(
+            std::make_shared<drake::solvers::LinearEqualityConstraint>(
+                A_velocity, VectorXd::Zero(n_v)),
+            {pre_impact_velocity, post_impact_velocity_vars(i_mode - 1)});
       }
     }
 
@@ -580,6 +594,35 @@ void Dircon<T>::DoAddRunningCost(const drake::symbolic::Expression& g) {
   // g_0*h_0/2.0 + [sum_{i=1...N-2} g_i*(h_{i-1} + h_i)/2.0] +
   // g_{N-1}*h_{N-2}/2.0.
 
+  // If g is a quadratic function of the placeholder state and input, extract
+  // its coefficients once and bind a numerical cost at every knot point.
+  // Otherwise, fall back on substituting the placeholder variables.
+  MatrixXd Q;
+  VectorXd b;
+  double c;
+  if (DecomposeQuadraticRunningCost(g, &Q, &b, &c)) {
+    auto cost_single = std::make_shared<TrapezoidalQuadraticCost>(Q, b, c, 1);
+    auto cost_double = std::make_shared<TrapezoidalQuadraticCost>(Q, b, c, 2);
+    for (int mode = 0; mode < num_modes(); ++mode) {
+      int mode_start = mode_start_[mode];
+      int mode_end = mode_start_[mode] + mode_length(mode);
+      // state_vars() already refers to the post-impact velocity variables at
+      // the first knot point of each mode
+      AddCost(cost_single, {h_vars().segment(mode_start, 1),
+                            state_vars(mode, 0), input_vars(mode, 0)});
+      for (int i = mode_start + 1; i < mode_end - 1; ++i) {
+        AddCost(cost_double,
+                {h_vars().segment(i - 1, 2), state_vars(mode, i - mode_start),
+                 input_vars(mode, i - mode_start)});
+      }
+      AddCost(cost_single,
+              {h_vars().segment(mode_end - 2, 1),
+               state_vars(mode, mode_length(mode) - 1),
+               input_vars(mode, mode_length(mode) - 1)});
+    }
+    return;
+  }
+
   // Here, we add the cost using symbolic expression. The expression is a
   // polynomial of degree 3 which Drake can handle, although the
   // documentation says it only supports up to second order.
@@ -606,34 +649,59 @@ void Dircon<T>::DoAddRunningCost(const drake::symbolic::Expression& g) {
   }
 }
 
+template <typename T>
+bool Dircon<T>::DecomposeQuadraticRunningCost(
+    const drake::symbolic::Expression& g, MatrixXd* Q, VectorXd* b,
+    double* c) const {
+  if (!g.is_polynomial()) {
+    return false;
+  }
+
+  // Placeholder variables, z = [x; u]
+  VectorXDecisionVariable z(num_states() + num_inputs());
+  z << state(), input();
+  std::unordered_map<drake::symbolic::Variable::Id, int> z_index;
+  for (int i = 0; i < z.size(); i++) {
+    z_index.emplace(z(i).get_id(), i);
+  }
+  for (const auto& var : g.GetVariables()) {
+    if (z_index.find(var.get_id()) == z_index.end()) {
+      return false;
+    }
+  }
+
+  const drake::symbolic::Polynomial poly(g, drake::symbolic::Variables(z));
+  if (poly.TotalDegree() > 2) {
+    return false;
+  }
+  *Q = MatrixXd::Zero(z.size(), z.size());
+  *b = VectorXd::Zero(z.size());
+  *c = 0;
+  drake::symbolic::DecomposeQuadraticPolynomial(poly, z_index, Q, b, c);
+  return true;
+}
+
 template<typename T>
 void Dircon<T>::AddVelocityCost(const double velocityCostGain){
-  double n_v = plant_.num_velocities();
+  int n_v = plant_.num_velocities();
 
   // Add velocity cost handling discontinuities
   // Loop through each mode and each knot point and use trapezoidal integration
+  //   h_i/2 * gain * (|v_i|^2 + |v_{i+1}|^2)
+  // The same cost object, with numerical coefficients, is bound at every
+  // interval.
+  auto cost = std::make_shared<TrapezoidalQuadraticCost>(
+      2 * velocityCostGain * MatrixXd::Identity(2 * n_v, 2 * n_v),
+      VectorXd::Zero(2 * n_v), 0, 1);
   for(int mode_index = 0; mode_index < num_modes(); mode_index++){
     for(int knot_index = 0; knot_index < mode_length(mode_index)-1; knot_index++){
-
       // Get lower and upper knot velocities
-      drake::solvers::VectorXDecisionVariable vel  = state_vars(mode_index, knot_index).tail(n_v);
-      drake::solvers::VectorXDecisionVariable vel_up = state_vars(mode_index, knot_index+1).tail(n_v);
-
-      drake::symbolic::Expression hi = timestep(mode_start_[mode_index] + knot_index)[0];
-
-      // Loop through and calculate sum of velocities squared
-      drake::symbolic::Expression vel_sq = 0;
-      drake::symbolic::Expression vel_sq_up = 0;
-      for(int i = 0; i< n_v; i++){
-        vel_sq += vel[i] * vel[i];
-        vel_sq_up += vel_up[i] * vel_up[i];
-      }
-
-      // Add cost
-      AddCost(hi/2.0 * velocityCostGain * (vel_sq + vel_sq_up));
+      AddCost(cost,
+              {timestep(mode_start_[mode_index] + knot_index),
+               state_vars(mode_index, knot_index).tail(n_v),
+               state_vars(mode_index, knot_index + 1).tail(n_v)});
     }
   }
-
 }
 
 template <typename T>
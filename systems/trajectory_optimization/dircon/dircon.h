@@ -267,6 +267,12 @@ class Dircon
       contexts_;
   std::vector<int> mode_start_;
   void DoAddRunningCost(const drake::symbolic::Expression& e) override;
+  // If g is a polynomial of degree at most two in the placeholder state and
+  // input variables, z = [x; u], computes g = 0.5 z^T Q z + b^T z + c and
+  // returns true. Returns false otherwise.
+  bool DecomposeQuadraticRunningCost(const drake::symbolic::Expression& g,
+                                     Eigen::MatrixXd* Q, Eigen::VectorXd* b,
+                                     double* c) const;
   std::vector<drake::solvers::VectorXDecisionVariable> force_vars_;
   std::vector<drake::solvers::VectorXDecisionVariable> collocation_force_vars_;
   std::vector<drake::solvers::VectorXDecisionVariable> collocation_slack_vars_;
@@ -206,6 +206,44 @@ void CachedAccelerationConstraint<T>::EvaluateConstraint(
   }
 }
 
+TrapezoidalQuadraticCost::TrapezoidalQuadraticCost(
+    const MatrixXd& Q, const VectorXd& b, double c, int num_timesteps,
+    const std::string& description)
+    : drake::solvers::Cost(num_timesteps + b.size(), description),
+      Q_(Q),
+      b_(b),
+      c_(c),
+      num_timesteps_(num_timesteps) {
+  DRAKE_DEMAND(Q.rows() == b.size() && Q.cols() == b.size());
+}
+
+void TrapezoidalQuadraticCost::DoEval(const Eigen::Ref<const VectorXd>& x,
+                                      VectorXd* y) const {
+  DoEvalGeneric<double>(x, y);
+}
+
+void TrapezoidalQuadraticCost::DoEval(
+    const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+    drake::AutoDiffVecXd* y) const {
+  DoEvalGeneric<drake::AutoDiffXd>(x, y);
+}
+
+void TrapezoidalQuadraticCost::DoEval(
+    const Eigen::Ref<const VectorX<drake::symbolic::Variable>>& x,
+    VectorX<drake::symbolic::Expression>* y) const {
+  DoEvalGeneric<drake::symbolic::Expression>(
+      x.cast<drake::symbolic::Expression>(), y);
+}
+
+template <typename U>
+void TrapezoidalQuadraticCost::DoEvalGeneric(
+    const Eigen::Ref<const VectorX<U>>& x, VectorX<U>* y) const {
+  const U weight = 0.5 * x.head(num_timesteps_).sum();
+  const VectorX<U> z = x.tail(b_.size());
+  y->resize(1);
+  (*y)(0) = weight * (0.5 * z.dot(Q_.cast<U>() * z) + b_.cast<U>().dot(z) + c_);
+}
+
 DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
     class ::dairlib::systems::trajectory_optimization::QuaternionConstraint)
 DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
@@ -9,6 +9,7 @@
 #include "drake/common/drake_copyable.h"
 #include "drake/common/symbolic.h"
 #include "drake/solvers/constraint.h"
+#include "drake/solvers/cost.h"
 #include "drake/systems/trajectory_optimization/multiple_shooting.h"
 
 namespace dairlib {
@@ -126,6 +127,44 @@ class CachedAccelerationConstraint : public solvers::NonlinearConstraint<T> {
   DynamicsCache<T>* cache_;
 };
 
+/// A running cost of a quadratic function of z, weighted by a sum of timesteps
+///    (h_1 + ... + h_k) / 2 * (0.5 z^T Q z + b^T z + c)
+/// This is the form of a single trapezoidal integration term, and is used
+/// by Dircon to add running costs from numerical coefficients rather than
+/// by symbolic substitution at every knot point.
+///
+/// The decision variables for this cost are, in order, the k timesteps and z.
+class TrapezoidalQuadraticCost : public drake::solvers::Cost {
+ public:
+  /// @param Q The quadratic coefficient matrix (need not be symmetric)
+  /// @param b The linear coefficient vector
+  /// @param c The constant term
+  /// @param num_timesteps The number k of timestep variables
+  TrapezoidalQuadraticCost(const Eigen::MatrixXd& Q, const Eigen::VectorXd& b,
+                           double c, int num_timesteps,
+                           const std::string& description = "");
+
+ protected:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x,
+              Eigen::VectorXd* y) const override;
+
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override;
+
+  void DoEval(
+      const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+      drake::VectorX<drake::symbolic::Expression>* y) const override;
+
+ private:
+  template <typename U>
+  void DoEvalGeneric(const Eigen::Ref<const drake::VectorX<U>>& x,
+                     drake::VectorX<U>* y) const;
+
+  const Eigen::MatrixXd Q_;
+  const Eigen::VectorXd b_;
+  const double c_;
+  const int num_timesteps_;
+};
 
 }  // namespace trajectory_optimization
 }  // namespace systems
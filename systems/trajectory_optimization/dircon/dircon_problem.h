@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/multibody/plant/multibody_plant.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// A complete, self-contained Dircon problem, for drivers that need to build
+/// the same program more than once (e.g. once per thread, or once per mesh).
+///
+/// Members are destroyed in reverse order, so trajopt is released before the
+/// mode sequence, the evaluators and finally the plant it references.
+struct DirconProblem {
+  std::unique_ptr<drake::multibody::MultibodyPlant<double>> plant;
+  /// Anything else that must outlive trajopt (evaluators, evaluator sets,
+  /// modes), e.g. the vectors returned by createSpiritModeSequence
+  std::vector<std::shared_ptr<void>> owned_objects;
+  std::unique_ptr<DirconModeSequence<double>> mode_sequence;
+  /// The program, with all costs, constraints, solver options and a nominal
+  /// initial guess already set
+  std::unique_ptr<Dircon<double>> trajopt;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
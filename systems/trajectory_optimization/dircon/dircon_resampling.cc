@@ -0,0 +1,186 @@
+#include "systems/trajectory_optimization/dircon/dircon_resampling.h"
+
+#include <algorithm>
+
+#include "multibody/multibody_utils.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::AutoDiffXd;
+using drake::solvers::MathematicalProgramResult;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace {
+
+/// Finds the interval k such that breaks(k) <= t <= breaks(k+1), with t
+/// clamped to the range of breaks, and the normalized position s within it.
+void FindInterval(const VectorXd& breaks, double t, int* k, double* s) {
+  int n = breaks.size();
+  t = std::clamp(t, breaks(0), breaks(n - 1));
+  *k = std::upper_bound(breaks.data(), breaks.data() + n, t) - breaks.data() -
+       1;
+  *k = std::clamp(*k, 0, n - 2);
+  double h = breaks(*k + 1) - breaks(*k);
+  *s = (h > 0) ? (t - breaks(*k)) / h : 0;
+}
+
+/// First-order hold evaluation of the sampled columns at time t
+VectorXd InterpolateLinear(const VectorXd& breaks, const MatrixXd& samples,
+                           double t) {
+  if (breaks.size() == 1) {
+    return samples.col(0);
+  }
+  int k;
+  double s;
+  FindInterval(breaks, t, &k, &s);
+  return (1 - s) * samples.col(k) + s * samples.col(k + 1);
+}
+
+/// Cubic Hermite evaluation of the sampled states at time t, matching the
+/// interpolant used by the Dircon collocation constraint
+VectorXd InterpolateCubic(const VectorXd& breaks, const MatrixXd& x,
+                          const MatrixXd& xdot, double t) {
+  if (breaks.size() == 1) {
+    return x.col(0);
+  }
+  int k;
+  double s;
+  FindInterval(breaks, t, &k, &s);
+  double h = breaks(k + 1) - breaks(k);
+  double s2 = s * s;
+  double s3 = s2 * s;
+  return (2 * s3 - 3 * s2 + 1) * x.col(k) +
+         (s3 - 2 * s2 + s) * h * xdot.col(k) +
+         (-2 * s3 + 3 * s2) * x.col(k + 1) + (s3 - s2) * h * xdot.col(k + 1);
+}
+
+}  // namespace
+
+template <typename T>
+void SetResampledInitialGuess(const Dircon<T>& from,
+                              const MathematicalProgramResult& result,
+                              Dircon<T>* to, double dt) {
+  DRAKE_DEMAND(dt >= 0);
+  DRAKE_DEMAND(from.num_modes() == to->num_modes());
+  const int num_modes = to->num_modes();
+  const auto quat_start_indices =
+      multibody::QuaternionStartIndices(to->get_mode(0).plant());
+
+  if (&from == to) {
+    // Start from the previous solution, so that any variable not resampled
+    // below is carried over unchanged.
+    to->SetInitialGuessForAllVariables(
+        result.GetSolution(to->decision_variables()));
+  } else {
+    for (int i_mode = 0; i_mode < num_modes; i_mode++) {
+      to->SetInitialGuess(to->offset_vars(i_mode),
+                          result.GetSolution(from.offset_vars(i_mode)));
+      if (i_mode > 0) {
+        to->SetInitialGuess(to->impulse_vars(i_mode - 1),
+                            result.GetSolution(from.impulse_vars(i_mode - 1)));
+      }
+    }
+  }
+
+  std::vector<MatrixXd> x;
+  std::vector<MatrixXd> xdot;
+  std::vector<VectorXd> breaks;
+  from.GetStateAndDerivativeSamples(result, &x, &xdot, &breaks);
+
+  for (int i_mode = 0; i_mode < num_modes; i_mode++) {
+    const int n_knot_prev = from.mode_length(i_mode);
+    const int n_knot = to->mode_length(i_mode);
+    const int n_lambda = to->get_mode(i_mode).evaluators().count_full();
+    const VectorXd& t_prev = breaks[i_mode];
+
+    // Shifted interval, in the time coordinates of the previous solution
+    double t_start = t_prev(0);
+    double t_end = t_prev(n_knot_prev - 1);
+    if (i_mode == 0) {
+      t_start = std::min(t_start + dt, t_end);
+    }
+    if (i_mode == num_modes - 1) {
+      t_end += dt;
+    }
+    double h = (n_knot > 1) ? (t_end - t_start) / (n_knot - 1) : 0;
+
+    MatrixXd u = from.GetInputSamplesByMode(result, i_mode);
+    MatrixXd lambda = from.GetForceSamplesByMode(result, i_mode);
+
+    for (int j = 0; j < n_knot; j++) {
+      double t = t_start + j * h;
+      VectorXd x_j = InterpolateCubic(t_prev, x[i_mode], xdot[i_mode], t);
+      for (int start : quat_start_indices) {
+        x_j.segment(start, 4).normalize();
+      }
+      // Positions at the first knot of a mode are shared with the last knot
+      // of the previous mode; both are set from (nearly) identical values.
+      to->SetInitialGuess(to->state_vars(i_mode, j), x_j);
+      to->SetInitialGuess(to->input_vars(i_mode, j),
+                          InterpolateLinear(t_prev, u, t));
+      if (n_lambda > 0) {
+        to->SetInitialGuess(to->force_vars(i_mode, j),
+                            InterpolateLinear(t_prev, lambda, t));
+      }
+    }
+    if (n_knot < 2) {
+      continue;
+    }
+
+    for (int j = 0; j < n_knot - 1; j++) {
+      to->SetInitialGuess(to->timestep(to->get_mode_start(i_mode) + j),
+                          VectorXd::Constant(1, h));
+    }
+
+    if (n_knot_prev < 2) {
+      continue;
+    }
+    VectorXd t_col_prev =
+        0.5 * (t_prev.head(n_knot_prev - 1) + t_prev.tail(n_knot_prev - 1));
+    const int n_quat = quat_start_indices.size();
+    if (n_quat > 0) {
+      MatrixXd quat_slack(n_quat, n_knot_prev - 1);
+      for (int j = 0; j < n_knot_prev - 1; j++) {
+        quat_slack.col(j) =
+            result.GetSolution(from.quaternion_slack_vars(i_mode, j));
+      }
+      for (int j = 0; j < n_knot - 1; j++) {
+        double t = t_start + (j + 0.5) * h;
+        to->SetInitialGuess(to->quaternion_slack_vars(i_mode, j),
+                            InterpolateLinear(t_col_prev, quat_slack, t));
+      }
+    }
+
+    if (n_lambda > 0) {
+      MatrixXd lambda_c(n_lambda, n_knot_prev - 1);
+      MatrixXd gamma_c(n_lambda, n_knot_prev - 1);
+      for (int j = 0; j < n_knot_prev - 1; j++) {
+        lambda_c.col(j) =
+            result.GetSolution(from.collocation_force_vars(i_mode, j));
+        gamma_c.col(j) =
+            result.GetSolution(from.collocation_slack_vars(i_mode, j));
+      }
+      for (int j = 0; j < n_knot - 1; j++) {
+        double t = t_start + (j + 0.5) * h;
+        to->SetInitialGuess(to->collocation_force_vars(i_mode, j),
+                            InterpolateLinear(t_col_prev, lambda_c, t));
+        to->SetInitialGuess(to->collocation_slack_vars(i_mode, j),
+                            InterpolateLinear(t_col_prev, gamma_c, t));
+      }
+    }
+  }
+}
+
+template void SetResampledInitialGuess<double>(
+    const Dircon<double>& from, const MathematicalProgramResult& result,
+    Dircon<double>* to, double dt);
+template void SetResampledInitialGuess<AutoDiffXd>(
+    const Dircon<AutoDiffXd>& from, const MathematicalProgramResult& result,
+    Dircon<AutoDiffXd>* to, double dt);
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
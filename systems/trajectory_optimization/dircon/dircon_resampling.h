@@ -0,0 +1,35 @@
+#pragma once
+
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/solvers/mathematical_program_result.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Sets the initial guess of the program `to` by resampling a solution of the
+/// program `from`, optionally shifted forward in time by dt. The two programs
+/// must have the same modes, but may have different numbers of knot points per
+/// mode, and may be the same object.
+///
+/// The knot points of every mode of `to` are spread uniformly over the mode's
+/// duration in the solution. If dt > 0, the first mode is shortened by dt
+/// (down to zero duration) and the last mode is extended by dt, holding the
+/// final sample. States are resampled from the cubic Hermite interpolant that
+/// Dircon uses, with quaternions renormalized, and inputs, forces, collocation
+/// forces and slacks from a first-order hold.
+///
+/// Variables without a time parameterization (impulses, offsets) are copied.
+/// When `from` and `to` are the same program, every other decision variable is
+/// carried over unchanged; otherwise any decision variables added outside of
+/// Dircon keep their current initial guess in `to`.
+template <typename T>
+void SetResampledInitialGuess(
+    const Dircon<T>& from,
+    const drake::solvers::MathematicalProgramResult& result, Dircon<T>* to,
+    double dt = 0);
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
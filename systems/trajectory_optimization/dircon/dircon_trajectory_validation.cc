@@ -0,0 +1,109 @@
+#include "systems/trajectory_optimization/dircon/dircon_trajectory_validation.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "lcm/dircon_saved_trajectory.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using Eigen::VectorXd;
+
+namespace {
+
+/// Regular files in a directory, sorted by name
+std::vector<std::string> ListFiles(const std::string& directory) {
+  std::vector<std::string> files;
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    throw std::runtime_error("Could not open directory: " + directory);
+  }
+  std::string prefix = directory;
+  if (!prefix.empty() && prefix.back() != '/') {
+    prefix += '/';
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string filepath = prefix + entry->d_name;
+    struct stat info;
+    if (stat(filepath.c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+      files.push_back(filepath);
+    }
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+void Validate(const Dircon<double>& trajopt, bool generic_only,
+              TrajectoryValidation* validation) {
+  VectorXd x;
+  try {
+    DirconTrajectory saved_traj(validation->filepath);
+    x = saved_traj.GetDecisionVariables();
+  } catch (std::exception& e) {
+    validation->error = e.what();
+    return;
+  }
+  if (x.size() != trajopt.num_vars()) {
+    validation->error = "The file has " + std::to_string(x.size()) +
+                        " decision variables, the program has " +
+                        std::to_string(trajopt.num_vars());
+    return;
+  }
+  validation->report =
+      solvers::EvaluateConstraintViolations(trajopt, x, generic_only);
+  for (const auto& binding : trajopt.GetAllCosts()) {
+    validation->cost += trajopt.EvalBinding(binding, x)(0);
+  }
+  validation->is_valid = true;
+}
+
+}  // namespace
+
+std::vector<TrajectoryValidation> ValidateDirconTrajectories(
+    const std::string& directory,
+    const std::function<std::unique_ptr<DirconProblem>()>& factory,
+    bool generic_only, int num_threads) {
+  std::vector<std::string> files = ListFiles(directory);
+  std::vector<TrajectoryValidation> validations(files.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    validations[i].filepath = files[i];
+  }
+
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, static_cast<int>(files.size()));
+
+  std::vector<std::unique_ptr<DirconProblem>> problems;
+  for (int t = 0; t < num_threads; t++) {
+    problems.push_back(factory());
+  }
+
+  std::atomic<int> next(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      const Dircon<double>& trajopt = *problems[t]->trajopt;
+      for (int i = next++; i < static_cast<int>(files.size()); i = next++) {
+        Validate(trajopt, generic_only, &validations[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return validations;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "solvers/optimization_utils.h"
+#include "systems/trajectory_optimization/dircon/dircon_problem.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Result of checking one saved DirconTrajectory against a program
+struct TrajectoryValidation {
+  std::string filepath;
+  /// False if the file could not be read, or its decision variables do not
+  /// match the program. The remaining fields are then unset.
+  bool is_valid = false;
+  /// Why the file is not valid
+  std::string error;
+  solvers::ConstraintViolationReport report;
+  double cost = 0;
+};
+
+/// Checks every DirconTrajectory file in a directory against the program built
+/// by factory, evaluating the constraint violations and the total cost at the
+/// saved decision variables.
+///
+/// Files are processed concurrently. Every thread uses its own problem from
+/// the factory, since Dircon constraints cannot be evaluated concurrently on
+/// one program.
+/// @param generic_only If true, only generic (nonlinear) constraints are
+///   checked. Otherwise bounds and linear constraints are checked too.
+/// @param num_threads Non-positive uses the hardware concurrency
+/// @return One entry per file, sorted by file name
+/// @throws std::runtime_error if the directory cannot be opened
+std::vector<TrajectoryValidation> ValidateDirconTrajectories(
+    const std::string& directory,
+    const std::function<std::unique_ptr<DirconProblem>()>& factory,
+    bool generic_only = false, int num_threads = 0);
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,150 @@
+#include "systems/trajectory_optimization/dircon/mesh_refinement_dircon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "multibody/multibody_utils.h"
+#include "systems/trajectory_optimization/dircon/dircon_resampling.h"
+
+#include "drake/solvers/choose_best_solver.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::solvers::MathematicalProgramResult;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+std::vector<VectorXd> EstimateCollocationError(
+    const Dircon<double>& trajopt, const MathematicalProgramResult& result) {
+  std::vector<MatrixXd> x;
+  std::vector<MatrixXd> xdot;
+  std::vector<VectorXd> breaks;
+  trajopt.GetStateAndDerivativeSamples(result, &x, &xdot, &breaks);
+
+  std::vector<VectorXd> error;
+  for (int mode = 0; mode < trajopt.num_modes(); mode++) {
+    const auto& evaluators = trajopt.get_mode(mode).evaluators();
+    const auto& plant = trajopt.get_mode(mode).plant();
+    MatrixXd u = trajopt.GetInputSamplesByMode(result, mode);
+    MatrixXd lambda = trajopt.GetForceSamplesByMode(result, mode);
+
+    const int n_intervals = trajopt.mode_length(mode) - 1;
+    VectorXd error_i = VectorXd::Zero(std::max(n_intervals, 0));
+    for (int j = 0; j < n_intervals; j++) {
+      double h = breaks[mode](j + 1) - breaks[mode](j);
+      if (h <= 0) {
+        continue;
+      }
+      const auto& x0 = x[mode].col(j);
+      const auto& x1 = x[mode].col(j + 1);
+      const auto& xdot0 = xdot[mode].col(j);
+      const auto& xdot1 = xdot[mode].col(j + 1);
+      // The midpoint (s = 0.5) is where the collocation constraint holds
+      for (double s : {0.25, 0.75}) {
+        double s2 = s * s;
+        double s3 = s2 * s;
+        VectorXd x_s = (2 * s3 - 3 * s2 + 1) * x0 +
+                       (s3 - 2 * s2 + s) * h * xdot0 +
+                       (-2 * s3 + 3 * s2) * x1 + (s3 - s2) * h * xdot1;
+        VectorXd xdot_s = (6 * s2 - 6 * s) / h * (x0 - x1) +
+                          (3 * s2 - 4 * s + 1) * xdot0 +
+                          (3 * s2 - 2 * s) * xdot1;
+        VectorXd u_s = (1 - s) * u.col(j) + s * u.col(j + 1);
+        VectorXd lambda_s = (1 - s) * lambda.col(j) + s * lambda.col(j + 1);
+
+        auto context = multibody::createContext<double>(plant, x_s, u_s);
+        VectorXd f = evaluators.CalcTimeDerivativesWithForce(context.get(),
+                                                             lambda_s);
+        error_i(j) =
+            std::max(error_i(j), h * (xdot_s - f).lpNorm<Eigen::Infinity>());
+      }
+    }
+    error.push_back(error_i);
+  }
+  return error;
+}
+
+MeshRefinementDircon::MeshRefinementDircon(
+    ProblemFactory factory, const std::vector<int>& initial_knotpoints,
+    const MeshRefinementOptions& options)
+    : factory_(std::move(factory)),
+      options_(options),
+      knotpoints_(initial_knotpoints) {
+  DRAKE_DEMAND(options_.tolerance > 0);
+  DRAKE_DEMAND(options_.max_growth > 1);
+}
+
+void MeshRefinementDircon::SolveCurrent() {
+  const Dircon<double>& trajopt = *problem_->trajopt;
+  auto solver = drake::solvers::MakeSolver(options_.solver_id);
+  auto start = std::chrono::steady_clock::now();
+  solver->Solve(trajopt, trajopt.initial_guess(), trajopt.solver_options(),
+                &result_);
+  auto finish = std::chrono::steady_clock::now();
+  error_ = EstimateCollocationError(trajopt, result_);
+
+  std::cout << "Mesh [";
+  for (int i = 0; i < static_cast<int>(knotpoints_.size()); i++) {
+    std::cout << (i > 0 ? ", " : "") << knotpoints_[i];
+  }
+  double max_error = 0;
+  for (const auto& error_i : error_) {
+    if (error_i.size() > 0) {
+      max_error = std::max(max_error, error_i.maxCoeff());
+    }
+  }
+  std::cout << "]: "
+            << (result_.is_success() ? "Optimization Success"
+                                     : "Optimization Fail")
+            << ", solve time "
+            << std::chrono::duration<double>(finish - start).count()
+            << "s, max collocation error " << max_error << std::endl;
+}
+
+std::vector<int> MeshRefinementDircon::RefineKnotpoints() const {
+  std::vector<int> knotpoints = knotpoints_;
+  for (int mode = 0; mode < static_cast<int>(knotpoints.size()); mode++) {
+    const int n_intervals = knotpoints[mode] - 1;
+    if (n_intervals < 1 || error_[mode].maxCoeff() <= options_.tolerance) {
+      continue;
+    }
+    double growth = std::pow(error_[mode].maxCoeff() / options_.tolerance,
+                             0.25);
+    growth = std::min(growth, options_.max_growth);
+    int refined_intervals = std::max(
+        n_intervals + 1, static_cast<int>(std::ceil(growth * n_intervals)));
+    knotpoints[mode] = std::min(refined_intervals + 1,
+                                options_.max_knotpoints_per_mode);
+    knotpoints[mode] = std::max(knotpoints[mode], knotpoints_[mode]);
+  }
+  return knotpoints;
+}
+
+const MathematicalProgramResult& MeshRefinementDircon::Solve() {
+  problem_ = factory_(knotpoints_);
+  DRAKE_DEMAND(problem_->trajopt->num_modes() ==
+               static_cast<int>(knotpoints_.size()));
+  SolveCurrent();
+
+  for (int i = 0; i < options_.max_refinements; i++) {
+    std::vector<int> refined = RefineKnotpoints();
+    if (refined == knotpoints_) {
+      break;
+    }
+    auto refined_problem = factory_(refined);
+    SetResampledInitialGuess(*problem_->trajopt, result_,
+                             refined_problem->trajopt.get());
+    problem_ = std::move(refined_problem);
+    knotpoints_ = refined;
+    SolveCurrent();
+  }
+  return result_;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
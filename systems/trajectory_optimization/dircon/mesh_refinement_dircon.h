@@ -0,0 +1,110 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "systems/trajectory_optimization/dircon/dircon_problem.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/solvers/mathematical_program_result.h"
+#include "drake/solvers/snopt_solver.h"
+#include "drake/solvers/solver_id.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Estimates the collocation error of every interval of a Dircon solution.
+///
+/// Dircon only enforces the dynamics at the midpoint of each interval. The
+/// error is estimated from the same cubic Hermite interpolant: at the quarter
+/// points of each interval, the derivative of the interpolant is compared to
+/// the dynamics evaluated on the interpolated state, with a first-order hold
+/// on inputs and forces. The returned estimate for an interval is the largest
+/// such defect, scaled by the interval length, so that it is in units of the
+/// state.
+/// @return One vector per mode, with one entry per interval
+std::vector<Eigen::VectorXd> EstimateCollocationError(
+    const Dircon<double>& trajopt,
+    const drake::solvers::MathematicalProgramResult& result);
+
+struct MeshRefinementOptions {
+  /// Target for the estimated collocation error of every interval
+  double tolerance = 1e-3;
+  /// Maximum number of re-solves on a refined mesh
+  int max_refinements = 4;
+  /// Each refinement multiplies the number of intervals of a mode by at most
+  /// this factor
+  double max_growth = 3;
+  int max_knotpoints_per_mode = 100;
+  drake::solvers::SolverId solver_id = drake::solvers::SnoptSolver::id();
+};
+
+/// MeshRefinementDircon solves a Dircon problem on a coarse mesh, then
+/// repeatedly adds knot points where the collocation error is high and
+/// re-solves, warm-started from the previous solution.
+///
+/// Solving on a coarse mesh first is much cheaper and converges more reliably
+/// from a poor initial guess than solving on the final mesh from the start;
+/// the later, larger solves then start close to the solution.
+///
+/// Dircon requires the knot points of a mode to be evenly spaced, so knot
+/// points are added per mode: every mode whose worst interval exceeds the
+/// tolerance gets more intervals, in proportion to its error assuming the
+/// fourth-order convergence of Hermite-Simpson collocation.
+///
+/// Since knot counts are fixed when a DirconMode is constructed, each mesh is
+/// a new program built by the factory. Decision variables added outside of
+/// Dircon are not warm-started.
+class MeshRefinementDircon {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(MeshRefinementDircon)
+
+  /// Builds the problem, with costs, constraints, solver options and (for the
+  /// first mesh) an initial guess, for the given knot points per mode.
+  using ProblemFactory = std::function<std::unique_ptr<DirconProblem>(
+      const std::vector<int>& num_knotpoints)>;
+
+  /// @param initial_knotpoints The number of knot points of each mode on the
+  ///   coarse mesh
+  MeshRefinementDircon(ProblemFactory factory,
+                       const std::vector<int>& initial_knotpoints,
+                       const MeshRefinementOptions& options);
+
+  /// Solves on successively refined meshes until the error estimate is below
+  /// the tolerance, or no more knot points can be added.
+  const drake::solvers::MathematicalProgramResult& Solve();
+
+  /// The problem for the current (finest) mesh
+  const DirconProblem& get_problem() const { return *problem_; }
+
+  const drake::solvers::MathematicalProgramResult& get_result() const {
+    return result_;
+  }
+
+  /// Knot points per mode of the current mesh
+  const std::vector<int>& get_knotpoints() const { return knotpoints_; }
+
+  /// Error estimate of the current solution, see EstimateCollocationError
+  const std::vector<Eigen::VectorXd>& get_error_estimate() const {
+    return error_;
+  }
+
+ private:
+  void SolveCurrent();
+  /// Returns the refined knot points per mode, equal to the current ones if
+  /// no refinement is needed or possible.
+  std::vector<int> RefineKnotpoints() const;
+
+  ProblemFactory factory_;
+  const MeshRefinementOptions options_;
+  std::vector<int> knotpoints_;
+  std::unique_ptr<DirconProblem> problem_;
+  drake::solvers::MathematicalProgramResult result_;
+  std::vector<Eigen::VectorXd> error_;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
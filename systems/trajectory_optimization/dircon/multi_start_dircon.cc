@@ -0,0 +1,257 @@
+#include "systems/trajectory_optimization/dircon/multi_start_dircon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "lcm/dircon_saved_trajectory.h"
+
+#include "drake/solvers/choose_best_solver.h"
+#include "drake/solvers/ipopt_solver.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::SolutionResult;
+using drake::solvers::SolverOptions;
+using Eigen::VectorXd;
+
+MultiStartDircon::MultiStartDircon(ProblemFactory factory,
+                                   const MultiStartOptions& options)
+    : options_(options) {
+  DRAKE_DEMAND(options_.num_starts > 0);
+  DRAKE_DEMAND(options_.iterations_per_round > 0);
+  int num_workers = options_.num_threads;
+  if (num_workers <= 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_workers = std::min(num_workers, options_.num_starts);
+  for (int i = 0; i < num_workers; i++) {
+    problems_.push_back(factory());
+    DRAKE_DEMAND(problems_.back()->trajopt != nullptr);
+    DRAKE_DEMAND(problems_.back()->trajopt->num_vars() ==
+                 problems_.front()->trajopt->num_vars());
+  }
+}
+
+void MultiStartDircon::InitializeStarts() {
+  const Dircon<double>& trajopt = *problems_.front()->trajopt;
+  results_.clear();
+
+  for (const auto& file : options_.library_files) {
+    if (static_cast<int>(results_.size()) == options_.num_starts) {
+      break;
+    }
+    DirconTrajectory saved_traj(file);
+    VectorXd x = saved_traj.GetDecisionVariables();
+    if (x.size() != trajopt.num_vars()) {
+      std::cerr << "Skipping " << file << ": it has " << x.size()
+                << " decision variables, the program has "
+                << trajopt.num_vars() << std::endl;
+      continue;
+    }
+    MultiStartResult start;
+    start.source = file;
+    start.decision_variables = x;
+    results_.push_back(start);
+  }
+
+  // Variables without an initial guess are NaN, which the solvers treat as 0
+  VectorXd nominal = trajopt.initial_guess();
+  for (int i = 0; i < nominal.size(); i++) {
+    if (std::isnan(nominal(i))) {
+      nominal(i) = 0;
+    }
+  }
+  if (static_cast<int>(results_.size()) < options_.num_starts) {
+    MultiStartResult start;
+    start.source = "nominal";
+    start.decision_variables = nominal;
+    results_.push_back(start);
+  }
+
+  std::mt19937 generator(options_.seed);
+  std::normal_distribution<double> noise(0, options_.perturbation_scale);
+  while (static_cast<int>(results_.size()) < options_.num_starts) {
+    MultiStartResult start;
+    start.source = "perturbed";
+    start.decision_variables = nominal;
+    for (int i = 0; i < nominal.size(); i++) {
+      start.decision_variables(i) +=
+          std::max(1.0, std::abs(nominal(i))) * noise(generator);
+    }
+    results_.push_back(start);
+  }
+}
+
+double MultiStartDircon::ConstraintViolation(const Dircon<double>& trajopt,
+                                             const VectorXd& x) const {
+  double violation = 0;
+  for (const auto& binding : trajopt.GetAllConstraints()) {
+    VectorXd y = trajopt.EvalBinding(binding, x);
+    if (y.hasNaN()) {
+      return std::numeric_limits<double>::infinity();
+    }
+    const VectorXd& lb = binding.evaluator()->lower_bound();
+    const VectorXd& ub = binding.evaluator()->upper_bound();
+    violation = std::max(
+        violation, std::max((lb - y).maxCoeff(), (y - ub).maxCoeff()));
+  }
+  return violation;
+}
+
+void MultiStartDircon::SolveStart(int worker, int start) {
+  const Dircon<double>& trajopt = *problems_[worker]->trajopt;
+  MultiStartResult& status = results_[start];
+
+  SolverOptions solver_options = trajopt.solver_options();
+  solver_options.SetOption(drake::solvers::SnoptSolver::id(),
+                           "Major iterations limit",
+                           options_.iterations_per_round);
+  solver_options.SetOption(drake::solvers::IpoptSolver::id(), "max_iter",
+                           options_.iterations_per_round);
+  // Solver output from concurrent solves would be interleaved
+  solver_options.SetOption(drake::solvers::IpoptSolver::id(), "print_level",
+                           0);
+
+  auto solver = drake::solvers::MakeSolver(options_.solver_id);
+  MathematicalProgramResult result;
+  auto start_time = std::chrono::steady_clock::now();
+  solver->Solve(trajopt, status.decision_variables, solver_options, &result);
+  auto finish_time = std::chrono::steady_clock::now();
+
+  status.decision_variables = result.GetSolution();
+  status.is_success = result.is_success();
+  status.constraint_violation =
+      ConstraintViolation(trajopt, status.decision_variables);
+  status.cost = 0;
+  for (const auto& binding : trajopt.GetAllCosts()) {
+    status.cost += trajopt.EvalBinding(binding, status.decision_variables)(0);
+  }
+  status.rounds++;
+  status.solve_time +=
+      std::chrono::duration<double>(finish_time - start_time).count();
+}
+
+void MultiStartDircon::UpdateBest() {
+  auto is_better = [this](const MultiStartResult& a,
+                          const MultiStartResult& b) {
+    if (a.is_success != b.is_success) {
+      return a.is_success;
+    }
+    if (a.is_success) {
+      return a.cost < b.cost;
+    }
+    double tol = options_.violation_tolerance;
+    if (std::max(a.constraint_violation, tol) !=
+        std::max(b.constraint_violation, tol)) {
+      return a.constraint_violation < b.constraint_violation;
+    }
+    return a.cost < b.cost;
+  };
+  best_index_ = 0;
+  for (int i = 1; i < static_cast<int>(results_.size()); i++) {
+    if (is_better(results_[i], results_[best_index_])) {
+      best_index_ = i;
+    }
+  }
+}
+
+void MultiStartDircon::PrintProgress(int round) const {
+  std::cout << "Multi-start round " << round << ":" << std::endl;
+  for (int i = 0; i < static_cast<int>(results_.size()); i++) {
+    const auto& status = results_[i];
+    std::string state = status.is_success     ? "converged"
+                        : status.is_cancelled ? "cancelled"
+                                              : "running";
+    std::cout << std::setw(4) << i << (i == best_index_ ? " *" : "  ")
+              << std::setw(10) << state << "  violation "
+              << std::setw(12) << status.constraint_violation << "  cost "
+              << std::setw(12) << status.cost << "  time "
+              << std::setw(8) << status.solve_time << "s  ("
+              << status.source << ")" << std::endl;
+  }
+}
+
+int MultiStartDircon::Run() {
+  InitializeStarts();
+
+  for (int round = 0; round < options_.max_rounds; round++) {
+    std::vector<int> active;
+    for (int i = 0; i < static_cast<int>(results_.size()); i++) {
+      if (!results_[i].is_success && !results_[i].is_cancelled) {
+        active.push_back(i);
+      }
+    }
+    if (active.empty()) {
+      break;
+    }
+
+    // Each worker solves on its own problem, pulling starts from a shared
+    // counter. Every start is written by exactly one worker.
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    int num_workers = std::min(static_cast<int>(problems_.size()),
+                               static_cast<int>(active.size()));
+    for (int w = 0; w < num_workers; w++) {
+      workers.emplace_back([this, w, &next, &active]() {
+        for (int i = next++; i < static_cast<int>(active.size());
+             i = next++) {
+          SolveStart(w, active[i]);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    UpdateBest();
+    double best_violation = results_[best_index_].constraint_violation;
+    double threshold = options_.cancel_ratio *
+                       std::max(options_.violation_tolerance, best_violation);
+    for (int i : active) {
+      if (!results_[i].is_success &&
+          results_[i].constraint_violation > threshold) {
+        results_[i].is_cancelled = true;
+      }
+    }
+    PrintProgress(round);
+  }
+
+  UpdateBest();
+  return best_index_;
+}
+
+MathematicalProgramResult MultiStartDircon::GetBestResult() const {
+  const Dircon<double>& trajopt = *problems_.front()->trajopt;
+  const MultiStartResult& best = results_.at(best_index());
+  MathematicalProgramResult result;
+  result.set_decision_variable_index(trajopt.decision_variable_index());
+  result.set_x_val(best.decision_variables);
+  result.set_optimal_cost(best.cost);
+  result.set_solver_id(options_.solver_id);
+  result.set_solution_result(best.is_success
+                                 ? SolutionResult::kSolutionFound
+                                 : SolutionResult::kIterationLimit);
+  return result;
+}
+
+void MultiStartDircon::WriteBestToFile(const std::string& filepath,
+                                       const std::string& name,
+                                       const std::string& description) const {
+  const DirconProblem& problem = *problems_.front();
+  DirconTrajectory saved_traj(*problem.plant, *problem.trajopt,
+                              GetBestResult(), name, description);
+  saved_traj.WriteToFile(filepath);
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "systems/trajectory_optimization/dircon/dircon_problem.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/solvers/mathematical_program_result.h"
+#include "drake/solvers/snopt_solver.h"
+#include "drake/solvers/solver_id.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+struct MultiStartOptions {
+  /// Total number of starts, including those seeded from library_files
+  int num_starts = 8;
+  /// Number of concurrent solves. Non-positive uses the hardware concurrency.
+  int num_threads = 0;
+  /// Each start is solved for at most this many (major) iterations at a time.
+  /// Between rounds, starts that are falling behind are cancelled and the
+  /// rest are warm-started from their last iterate.
+  int iterations_per_round = 100;
+  /// Maximum number of rounds
+  int max_rounds = 10;
+  /// After each round, an unfinished start is cancelled if its constraint
+  /// violation exceeds cancel_ratio times the best violation so far
+  double cancel_ratio = 10;
+  /// Violations below this are treated as equal (feasible) when comparing
+  double violation_tolerance = 1e-6;
+  /// Saved DirconTrajectory files used as initial guesses, one start each.
+  /// Files whose decision variables do not match the program are skipped.
+  std::vector<std::string> library_files;
+  /// Standard deviation of the Gaussian perturbation of the nominal initial
+  /// guess, relative to max(1, |x_i|) for each decision variable
+  double perturbation_scale = 0.05;
+  unsigned int seed = 0;
+  /// The solver must be safe to run concurrently in separate instances. This
+  /// holds for SNOPT, but not for IPOPT when linked against MUMPS.
+  drake::solvers::SolverId solver_id = drake::solvers::SnoptSolver::id();
+};
+
+/// Status of a single start after MultiStartDircon::Run()
+struct MultiStartResult {
+  /// Where the initial guess came from, e.g. "nominal", "perturbed" or the
+  /// library file name
+  std::string source;
+  Eigen::VectorXd decision_variables;
+  double cost = std::numeric_limits<double>::infinity();
+  /// Maximum violation over all constraints
+  double constraint_violation = std::numeric_limits<double>::infinity();
+  bool is_success = false;
+  bool is_cancelled = false;
+  int rounds = 0;
+  /// Total wall time, in seconds, spent solving this start
+  double solve_time = 0;
+};
+
+/// MultiStartDircon solves one Dircon problem from many initial guesses in
+/// parallel and keeps the best solution.
+///
+/// Starts are drawn from saved DirconTrajectory files, then the nominal
+/// initial guess of the program, then random perturbations of it. The starts
+/// are solved in rounds of a limited number of iterations on a pool of
+/// workers, each with its own DirconProblem built by the factory, so that no
+/// plant, context or DynamicsCache is shared between threads. After every
+/// round the progress of each start is printed and starts whose constraint
+/// violation lags far behind the best are cancelled, so that the remaining
+/// compute goes to the promising ones.
+///
+/// The best start is the successful one with the lowest cost, or if none
+/// succeeded, the one with the lowest constraint violation.
+///
+/// Typical usage:
+///   MultiStartDircon runner(&MakeSpiritBoundProblem, options);
+///   runner.Run();
+///   runner.WriteBestToFile(FLAGS_data_directory + "bound", "bound", "");
+class MultiStartDircon {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(MultiStartDircon)
+
+  using ProblemFactory = std::function<std::unique_ptr<DirconProblem>()>;
+
+  /// @param factory Builds an identical problem each call. It is invoked
+  ///   once per worker.
+  MultiStartDircon(ProblemFactory factory, const MultiStartOptions& options);
+
+  /// Solves all starts. Returns the index of the best start.
+  int Run();
+
+  const std::vector<MultiStartResult>& get_results() const { return results_; }
+
+  /// Index of the best start, only valid after Run()
+  int best_index() const {
+    DRAKE_DEMAND(best_index_ >= 0);
+    return best_index_;
+  }
+
+  /// Solution of the best start, expressed in terms of the decision variables
+  /// of get_problem()
+  drake::solvers::MathematicalProgramResult GetBestResult() const;
+
+  /// Saves the best start as a DirconTrajectory
+  void WriteBestToFile(const std::string& filepath, const std::string& name,
+                       const std::string& description) const;
+
+  /// The problem owned by the first worker
+  const DirconProblem& get_problem() const { return *problems_.front(); }
+
+ private:
+  void InitializeStarts();
+  void SolveStart(int worker, int start);
+  double ConstraintViolation(const Dircon<double>& trajopt,
+                             const Eigen::VectorXd& x) const;
+  void UpdateBest();
+  void PrintProgress(int round) const;
+
+  const MultiStartOptions options_;
+  std::vector<std::unique_ptr<DirconProblem>> problems_;
+  std::vector<MultiStartResult> results_;
+  int best_index_ = -1;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
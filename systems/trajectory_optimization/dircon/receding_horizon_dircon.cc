@@ -0,0 +1,83 @@
+#include "systems/trajectory_optimization/dircon/receding_horizon_dircon.h"
+
+#include <chrono>
+
+#include "systems/trajectory_optimization/dircon/dircon_resampling.h"
+
+#include "drake/solvers/choose_best_solver.h"
+#include "drake/solvers/ipopt_solver.h"
+#include "drake/solvers/snopt_solver.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::SolverId;
+using drake::solvers::SolverOptions;
+
+using Eigen::VectorXd;
+
+template <typename T>
+RecedingHorizonDircon<T>::RecedingHorizonDircon(
+    const DirconModeSequence<T>& mode_sequence, const SolverId& solver_id)
+    : trajopt_(std::make_unique<Dircon<T>>(mode_sequence)),
+      solver_(drake::solvers::MakeSolver(solver_id)) {}
+
+template <typename T>
+void RecedingHorizonDircon<T>::SetInitialState(const VectorXd& x0) {
+  DRAKE_DEMAND(x0.size() == trajopt_->num_states());
+  if (initial_state_constraint_) {
+    initial_state_constraint_->evaluator()->set_bounds(x0, x0);
+  } else {
+    initial_state_constraint_ =
+        trajopt_->AddBoundingBoxConstraint(x0, x0, trajopt_->initial_state());
+  }
+}
+
+template <typename T>
+void RecedingHorizonDircon<T>::UpdateBounds(const Binding<Constraint>& binding,
+                                            const VectorXd& lb,
+                                            const VectorXd& ub) {
+  DRAKE_DEMAND(lb.size() == binding.evaluator()->num_constraints());
+  DRAKE_DEMAND(ub.size() == binding.evaluator()->num_constraints());
+  binding.evaluator()->set_bounds(lb, ub);
+}
+
+template <typename T>
+void RecedingHorizonDircon<T>::ShiftInitialGuess(double dt) {
+  ShiftInitialGuess(get_result(), dt);
+}
+
+template <typename T>
+void RecedingHorizonDircon<T>::ShiftInitialGuess(
+    const MathematicalProgramResult& result, double dt) {
+  SetResampledInitialGuess(*trajopt_, result, trajopt_.get(), dt);
+}
+
+template <typename T>
+const MathematicalProgramResult& RecedingHorizonDircon<T>::Solve() {
+  SolverOptions options = trajopt_->solver_options();
+  if (max_iterations_ > 0) {
+    options.SetOption(drake::solvers::SnoptSolver::id(),
+                      "Major iterations limit", max_iterations_);
+    options.SetOption(drake::solvers::IpoptSolver::id(), "max_iter",
+                      max_iterations_);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  solver_->Solve(*trajopt_, trajopt_->initial_guess(), options, &result_);
+  auto finish = std::chrono::high_resolution_clock::now();
+  last_solve_time_ = std::chrono::duration<double>(finish - start).count();
+  num_solves_++;
+  return result_;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
+
+DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
+    class ::dairlib::systems::trajectory_optimization::RecedingHorizonDircon)
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/solvers/mathematical_program_result.h"
+#include "drake/solvers/solver_id.h"
+#include "drake/solvers/solver_interface.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// RecedingHorizonDircon wraps a Dircon program for repeated, warm-started
+/// re-solves, as needed for online (MPC-style) replanning.
+///
+/// The Dircon program, including all of its constraints, contexts and
+/// DynamicsCache objects, is constructed exactly once. Each planning cycle then
+/// only
+///   1. updates the initial state (and any other bounds),
+///   2. time-shifts the previous solution to use as the initial guess, and
+///   3. re-solves, optionally with a cap on the number of iterations.
+///
+/// Typical usage:
+///   RecedingHorizonDircon<double> planner(sequence, IpoptSolver::id());
+///   auto& trajopt = planner.get_mutable_trajopt();
+///   // ... add costs and constraints to trajopt, set an initial guess ...
+///   planner.SetMaxIterations(50);
+///   while (running) {
+///     planner.SetInitialState(x_measured);
+///     const auto& result = planner.Solve();
+///     // ... use result ...
+///     planner.ShiftInitialGuess(dt_replan);
+///   }
+template <typename T>
+class RecedingHorizonDircon {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(RecedingHorizonDircon)
+
+  /// @param mode_sequence The hybrid mode sequence. Must outlive this object.
+  /// @param solver_id The solver used for every solve. The solver is
+  ///   instantiated once, here.
+  RecedingHorizonDircon(const DirconModeSequence<T>& mode_sequence,
+                        const drake::solvers::SolverId& solver_id);
+
+  /// Returns the underlying Dircon program. Costs, constraints, solver options
+  /// and scaling should be added through this before the first Solve().
+  Dircon<T>& get_mutable_trajopt() { return *trajopt_; }
+
+  const Dircon<T>& get_trajopt() const { return *trajopt_; }
+
+  /// Constrains the first knot point to equal x0. The bounding box constraint
+  /// is added on the first call, after which only its bounds are updated.
+  void SetInitialState(const Eigen::VectorXd& x0);
+
+  /// Updates the bounds of a constraint that was previously added to the
+  /// program. This avoids adding a new binding every planning cycle.
+  void UpdateBounds(
+      const drake::solvers::Binding<drake::solvers::Constraint>& binding,
+      const Eigen::VectorXd& lb, const Eigen::VectorXd& ub);
+
+  /// Sets the initial guess to the most recent solution, shifted forward in
+  /// time by dt. See ShiftInitialGuess(result, dt).
+  void ShiftInitialGuess(double dt);
+
+  /// Sets the initial guess to the given solution, shifted forward in time by
+  /// dt. The first mode is shortened by dt (down to zero duration) and the
+  /// last mode is extended by dt, holding the final sample, so that the
+  /// remaining knot points of every mode are spread uniformly over the shifted
+  /// mode. States are resampled from the cubic Hermite interpolant that Dircon
+  /// uses, inputs and forces from a first-order hold. Variables without a
+  /// time parameterization (impulses, offsets) are copied unchanged. See
+  /// SetResampledInitialGuess.
+  /// @param result A solution to this program
+  /// @param dt The time shift, must be non-negative
+  void ShiftInitialGuess(
+      const drake::solvers::MathematicalProgramResult& result, double dt);
+
+  /// Caps the number of (major) iterations for every subsequent solve. Applied
+  /// as "Major iterations limit" for SNOPT and "max_iter" for IPOPT. A
+  /// non-positive value removes the cap, restoring the options set on the
+  /// program itself.
+  void SetMaxIterations(int max_iterations) {
+    max_iterations_ = max_iterations;
+  }
+
+  /// Solves the program from the current initial guess and stores the result.
+  const drake::solvers::MathematicalProgramResult& Solve();
+
+  const drake::solvers::MathematicalProgramResult& get_result() const {
+    DRAKE_DEMAND(num_solves_ > 0);
+    return result_;
+  }
+
+  /// Number of completed calls to Solve()
+  int num_solves() const { return num_solves_; }
+
+  /// Wall time, in seconds, taken by the most recent call to Solve()
+  double last_solve_time() const { return last_solve_time_; }
+
+ private:
+  std::unique_ptr<Dircon<T>> trajopt_;
+  std::unique_ptr<drake::solvers::SolverInterface> solver_;
+  std::optional<drake::solvers::Binding<drake::solvers::BoundingBoxConstraint>>
+      initial_state_constraint_;
+  drake::solvers::MathematicalProgramResult result_;
+  int max_iterations_ = 0;
+  int num_solves_ = 0;
+  double last_solve_time_ = 0;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
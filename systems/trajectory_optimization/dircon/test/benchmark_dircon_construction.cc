@@ -0,0 +1,150 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_utils.h"
+#include "examples/Spirit/spirit_utils.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/multibody/parsing/parser.h"
+
+DEFINE_int32(knots_per_mode, 30, "Number of knot points in every mode");
+DEFINE_int32(reps, 5, "Number of constructions to time per problem");
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using Eigen::Matrix3d;
+using Eigen::Vector3d;
+using systems::trajectory_optimization::Dircon;
+using systems::trajectory_optimization::DirconMode;
+using systems::trajectory_optimization::DirconModeSequence;
+
+typedef std::chrono::steady_clock my_clock;
+
+/// Builds the Dircon program, with a quadratic input cost and velocity cost,
+/// reps times and reports the average construction time.
+void TimeConstruction(const std::string& name,
+                      const DirconModeSequence<double>& sequence, int reps) {
+  double total = 0;
+  int num_vars = 0;
+  for (int i = 0; i < reps; i++) {
+    auto start = my_clock::now();
+    Dircon<double> trajopt(sequence);
+    auto u = trajopt.input();
+    trajopt.AddRunningCost(u.transpose() * u);
+    trajopt.AddVelocityCost(1.0);
+    auto stop = my_clock::now();
+    total += std::chrono::duration<double>(stop - start).count();
+    num_vars = trajopt.num_vars();
+  }
+  std::cout << "(" << name << ") " << sequence.num_modes() << " modes, "
+            << sequence.count_knotpoints() << " knot points, " << num_vars
+            << " decision variables. Construction took " << 1000 * total / reps
+            << " milliseconds on average over " << reps << " reps."
+            << std::endl;
+}
+
+/// Two-mode (left stance, right stance) walking sequence on fixed-spring
+/// Cassie, matching the contacts used by run_dircon_walking
+void BenchmarkCassieWalking(int knots_per_mode, int reps) {
+  MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant, nullptr, true,
+                     "examples/Cassie/urdf/cassie_fixed_springs.urdf", false,
+                     false);
+  plant.Finalize();
+
+  auto left_loop = LeftLoopClosureEvaluator(plant);
+  auto right_loop = RightLoopClosureEvaluator(plant);
+
+  auto left_toe_front = LeftToeFront(plant);
+  auto left_toe_rear = LeftToeRear(plant);
+  auto right_toe_front = RightToeFront(plant);
+  auto right_toe_rear = RightToeRear(plant);
+  multibody::WorldPointEvaluator<double> left_front_eval(
+      plant, left_toe_front.first, left_toe_front.second, Matrix3d::Identity(),
+      Vector3d::Zero(), {1, 2});
+  multibody::WorldPointEvaluator<double> left_rear_eval(
+      plant, left_toe_rear.first, left_toe_rear.second, Matrix3d::Identity(),
+      Vector3d::Zero(), {0, 1, 2});
+  multibody::WorldPointEvaluator<double> right_front_eval(
+      plant, right_toe_front.first, right_toe_front.second,
+      Matrix3d::Identity(), Vector3d::Zero(), {1, 2});
+  multibody::WorldPointEvaluator<double> right_rear_eval(
+      plant, right_toe_rear.first, right_toe_rear.second,
+      Matrix3d::Identity(), Vector3d::Zero(), {0, 1, 2});
+
+  multibody::KinematicEvaluatorSet<double> left_evaluators(plant);
+  left_evaluators.add_evaluator(&left_front_eval);
+  left_evaluators.add_evaluator(&left_rear_eval);
+  left_evaluators.add_evaluator(&left_loop);
+  left_evaluators.add_evaluator(&right_loop);
+  multibody::KinematicEvaluatorSet<double> right_evaluators(plant);
+  right_evaluators.add_evaluator(&right_front_eval);
+  right_evaluators.add_evaluator(&right_rear_eval);
+  right_evaluators.add_evaluator(&left_loop);
+  right_evaluators.add_evaluator(&right_loop);
+
+  DirconMode<double> left_stance(left_evaluators, knots_per_mode, 0.2, 0.5);
+  DirconMode<double> right_stance(right_evaluators, knots_per_mode, 0.2, 0.5);
+  DirconModeSequence<double> sequence(plant);
+  sequence.AddMode(&left_stance);
+  sequence.AddMode(&right_stance);
+
+  TimeConstruction("cassie walking", sequence, reps);
+}
+
+/// Six-mode bound sequence on Spirit, matching run_spirit_bound
+void BenchmarkSpiritBound(int knots_per_mode, int reps) {
+  MultibodyPlant<double> plant(0.0);
+  Parser parser(&plant);
+  parser.AddModelFromFile(
+      FindResourceOrThrow("examples/Spirit/spirit_drake.urdf"));
+  plant.mutable_gravity_field().set_gravity_vector(-9.81 * Vector3d::UnitZ());
+  plant.Finalize();
+
+  ModeSequenceHelper msh;
+  const std::vector<Eigen::Matrix<bool, 1, 4>> contacts = {
+      (Eigen::Matrix<bool, 1, 4>() << true, true, true, true).finished(),
+      (Eigen::Matrix<bool, 1, 4>() << false, true, false, true).finished(),
+      (Eigen::Matrix<bool, 1, 4>() << false, false, false, false).finished(),
+      (Eigen::Matrix<bool, 1, 4>() << false, false, false, false).finished(),
+      (Eigen::Matrix<bool, 1, 4>() << true, false, true, false).finished(),
+      (Eigen::Matrix<bool, 1, 4>() << true, true, true, true).finished()};
+  for (const auto& contact : contacts) {
+    msh.addMode(contact, knots_per_mode, Vector3d::UnitZ(), Vector3d::Zero(),
+                1, 0.02, 1.0);
+  }
+  auto [mode_vector, toe_evals, toe_eval_sets] =
+      createSpiritModeSequence(plant, msh);
+
+  DirconModeSequence<double> sequence(plant);
+  for (auto& mode : mode_vector) {
+    for (int i = 0; i < mode->evaluators().num_evaluators(); i++) {
+      mode->MakeConstraintRelative(i, 0);
+      mode->MakeConstraintRelative(i, 1);
+    }
+    sequence.AddMode(mode.get());
+  }
+
+  TimeConstruction("spirit bound", sequence, reps);
+}
+
+int do_main() {
+  BenchmarkCassieWalking(FLAGS_knots_per_mode, FLAGS_reps);
+  BenchmarkSpiritBound(FLAGS_knots_per_mode, FLAGS_reps);
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  return dairlib::do_main();
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "systems/trajectory_optimization/dircon/mesh_refinement_dircon.h"
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+#include "drake/solvers/solve.h"
+
+DEFINE_double(tolerance, 1e-4, "Collocation error tolerance of the refinement");
+DEFINE_int32(max_knotpoints, 40, "Maximum number of knot points of the mode");
+DEFINE_int32(initial_knotpoints, 4, "Number of knot points of the first mesh");
+
+namespace dairlib {
+namespace {
+
+using systems::trajectory_optimization::MakePlanarWalkerSwingProblem;
+using systems::trajectory_optimization::MeshRefinementDircon;
+using systems::trajectory_optimization::MeshRefinementOptions;
+
+typedef std::chrono::steady_clock my_clock;
+
+/// Times mesh refinement of the planar walker swing against a direct solve
+/// of its final mesh from the straight-line initial guess
+int do_main() {
+  MeshRefinementOptions options;
+  options.tolerance = FLAGS_tolerance;
+  options.max_knotpoints_per_mode = FLAGS_max_knotpoints;
+  options.max_refinements = 10;
+  auto factory = [](const std::vector<int>& num_knotpoints) {
+    return MakePlanarWalkerSwingProblem(num_knotpoints, 1.0);
+  };
+
+  MeshRefinementDircon refinement(factory, {FLAGS_initial_knotpoints},
+                                  options);
+  auto start = my_clock::now();
+  const auto& result = refinement.Solve();
+  auto finish = my_clock::now();
+  const double refinement_time =
+      std::chrono::duration<double>(finish - start).count();
+
+  auto direct = factory(refinement.get_knotpoints());
+  start = my_clock::now();
+  const auto direct_result = drake::solvers::Solve(*direct->trajopt);
+  finish = my_clock::now();
+  const double direct_time =
+      std::chrono::duration<double>(finish - start).count();
+
+  std::cout << "Refinement to " << refinement.get_knotpoints()[0]
+            << " knot points: " << refinement_time << "s ("
+            << (result.is_success() ? "success" : "fail")
+            << "), direct solve: " << direct_time << "s ("
+            << (direct_result.is_success() ? "success" : "fail") << ")"
+            << std::endl;
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  return dairlib::do_main();
+}
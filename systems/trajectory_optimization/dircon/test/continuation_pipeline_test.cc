@@ -0,0 +1,216 @@
+#include "systems/trajectory_optimization/dircon/continuation_pipeline.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using std::string;
+using std::vector;
+
+/// A path in the test's temporary directory, which is empty on every run, so
+/// that the cache starts empty
+string TempPath(const string& name) {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? string(directory) + "/" + name : name;
+}
+
+bool FileExists(const string& filepath) {
+  return std::ifstream(filepath).good();
+}
+
+string ReadFile(const string& filepath) {
+  std::ifstream file(filepath);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/// A stage that records its calls and writes its input followed by its
+/// parameters, so that every output depends on all previous stages
+class ContinuationPipelineTest : public ::testing::Test {
+ protected:
+  ContinuationPipeline::SolveFunction Solve() {
+    return [this](const ContinuationParameters& parameters,
+                  const string& file_in, const string& file_out) {
+      calls_.push_back({parameters, file_in, file_out});
+      std::ofstream file(file_out);
+      if (!file_in.empty()) {
+        file << ReadFile(file_in);
+      }
+      for (const auto& [key, value] : parameters) {
+        file << key << "=" << value << ";";
+      }
+      file << "\n";
+    };
+  }
+
+  /// Builds a pipeline of three stages, with the parameter a of the middle
+  /// one
+  void AddStages(ContinuationPipeline* pipeline, double a) {
+    pipeline->AddStage("first", {{"a", 1}}, Solve());
+    pipeline->AddStage("second", {{"a", a}}, Solve());
+    pipeline->AddStage("third", {{"a", 3}}, Solve(), output_file_);
+  }
+
+  struct Call {
+    ContinuationParameters parameters;
+    string file_in;
+    string file_out;
+  };
+  vector<Call> calls_;
+  const string cache_prefix_ = TempPath("TEST_PIPELINE_CACHE_");
+  const string output_file_ = TempPath("TEST_PIPELINE_OUTPUT");
+};
+
+TEST_F(ContinuationPipelineTest, CacheHitsAndMisses) {
+  ContinuationPipeline pipeline(cache_prefix_, "hits_and_misses");
+  AddStages(&pipeline, 2);
+  const string final_file = pipeline.Run();
+  EXPECT_EQ(pipeline.num_solved(), 3);
+  ASSERT_EQ(calls_.size(), 3);
+  ASSERT_EQ(pipeline.get_stage_files().size(), 3);
+  EXPECT_EQ(final_file, pipeline.get_stage_files().back());
+  // Each stage continues from the cached output of the previous one
+  EXPECT_EQ(calls_[0].file_in, "");
+  EXPECT_EQ(calls_[1].file_in, pipeline.get_stage_files()[0]);
+  EXPECT_EQ(calls_[2].file_in, pipeline.get_stage_files()[1]);
+  EXPECT_EQ(ReadFile(output_file_), ReadFile(final_file));
+
+  // An identical pipeline reuses every stage
+  calls_.clear();
+  ContinuationPipeline same(cache_prefix_, "hits_and_misses");
+  AddStages(&same, 2);
+  EXPECT_EQ(same.Run(), final_file);
+  EXPECT_EQ(same.num_solved(), 0);
+  EXPECT_TRUE(calls_.empty());
+  EXPECT_EQ(same.get_stage_files(), pipeline.get_stage_files());
+
+  // Changing the middle stage re-solves it and the stages after it
+  ContinuationPipeline changed(cache_prefix_, "hits_and_misses");
+  AddStages(&changed, 4);
+  EXPECT_NE(changed.Run(), final_file);
+  EXPECT_EQ(changed.num_solved(), 2);
+  ASSERT_EQ(calls_.size(), 2);
+  EXPECT_EQ(calls_[0].parameters.at("a"), 4);
+  EXPECT_EQ(changed.get_stage_files()[0], pipeline.get_stage_files()[0]);
+  EXPECT_NE(changed.get_stage_files()[1], pipeline.get_stage_files()[1]);
+
+  // So does a different version
+  calls_.clear();
+  ContinuationPipeline other_version(cache_prefix_, "other_version");
+  AddStages(&other_version, 2);
+  other_version.Run();
+  EXPECT_EQ(other_version.num_solved(), 3);
+}
+
+TEST_F(ContinuationPipelineTest, InitialGuessFileIsPartOfTheKey) {
+  const string guess_file = TempPath("TEST_PIPELINE_GUESS");
+  {
+    std::ofstream file(guess_file);
+    file << "guess 0\n";
+  }
+  ContinuationPipeline pipeline(cache_prefix_, "initial_guess");
+  pipeline.SetInitialGuessFile(guess_file);
+  pipeline.AddStage("only", {}, Solve());
+  const string first_file = pipeline.Run();
+  ASSERT_EQ(calls_.size(), 1);
+  EXPECT_EQ(calls_[0].file_in, guess_file);
+
+  {
+    std::ofstream file(guess_file);
+    file << "guess 1\n";
+  }
+  EXPECT_NE(pipeline.Run(), first_file);
+  EXPECT_EQ(pipeline.num_solved(), 1);
+}
+
+TEST_F(ContinuationPipelineTest, ScheduleExpansion) {
+  ContinuationPipeline pipeline(cache_prefix_, "schedule");
+  pipeline.AddSchedule("mu", {{"b", 7}}, "mu", {10, 3, 1}, Solve());
+  pipeline.Run();
+  ASSERT_EQ(calls_.size(), 3);
+  const vector<double> values = {10, 3, 1};
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(calls_[i].parameters.at("mu"), values[i]);
+    EXPECT_EQ(calls_[i].parameters.at("b"), 7);
+    EXPECT_EQ(pipeline.get_stage_files()[i].rfind(
+                  cache_prefix_ + "mu_" + std::to_string(i) + "_", 0),
+              0);
+  }
+
+  EXPECT_EQ(LinearSchedule(0, 1, 3), vector<double>({0, 0.5, 1}));
+  EXPECT_EQ(LinearSchedule(0, 1, 1), vector<double>({1}));
+  const vector<double> geometric = GeometricSchedule(100, 1, 3);
+  ASSERT_EQ(geometric.size(), 3);
+  EXPECT_NEAR(geometric[0], 100, 1e-12);
+  EXPECT_NEAR(geometric[1], 10, 1e-12);
+  EXPECT_NEAR(geometric[2], 1, 1e-12);
+}
+
+TEST_F(ContinuationPipelineTest, SolvesIntoTemporaryFile) {
+  ContinuationPipeline pipeline(cache_prefix_, "temporary");
+  pipeline.AddStage("only", {}, Solve());
+  const string file = pipeline.Run();
+  ASSERT_EQ(calls_.size(), 1);
+  EXPECT_EQ(calls_[0].file_out, file + ".tmp");
+  EXPECT_TRUE(FileExists(file));
+  EXPECT_FALSE(FileExists(file + ".tmp"));
+
+  // A stage that writes nothing leaves nothing in the cache
+  ContinuationPipeline failing(cache_prefix_, "failing");
+  failing.AddStage("only", {},
+                   [](const ContinuationParameters&, const string&,
+                      const string&) {});
+  EXPECT_THROW(failing.Run(), std::runtime_error);
+  ContinuationPipeline retry(cache_prefix_, "failing");
+  retry.AddStage("only", {}, Solve());
+  retry.Run();
+  EXPECT_EQ(retry.num_solved(), 1);
+}
+
+TEST_F(ContinuationPipelineTest, PruneCache) {
+  ContinuationPipeline pipeline(cache_prefix_, "prune");
+  pipeline.AddStage("prune_first", {{"a", 1}}, Solve());
+  pipeline.AddStage("prune_second", {{"a", 2}}, Solve());
+  pipeline.Run();
+  const vector<string> old_files = pipeline.get_stage_files();
+
+  // A stage of another name, which is not pruned
+  ContinuationPipeline other(cache_prefix_, "prune");
+  other.AddStage("prune_other", {{"a", 1}}, Solve());
+  const string other_file = other.Run();
+
+  // Changing the second stage leaves its earlier solution in the cache
+  ContinuationPipeline changed(cache_prefix_, "prune");
+  changed.AddStage("prune_first", {{"a", 1}}, Solve());
+  changed.AddStage("prune_second", {{"a", 3}}, Solve());
+  changed.Run();
+  ASSERT_EQ(changed.get_stage_files()[0], old_files[0]);
+  ASSERT_TRUE(FileExists(old_files[1]));
+  std::ofstream(old_files[1] + ".tmp") << "interrupted";
+
+  EXPECT_EQ(changed.PruneCache(), 2);
+  EXPECT_FALSE(FileExists(old_files[1]));
+  EXPECT_FALSE(FileExists(old_files[1] + ".tmp"));
+  for (const auto& file : changed.get_stage_files()) {
+    EXPECT_TRUE(FileExists(file));
+  }
+  EXPECT_TRUE(FileExists(other_file));
+  EXPECT_EQ(changed.PruneCache(), 0);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
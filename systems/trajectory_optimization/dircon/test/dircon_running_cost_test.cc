@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon/dircon.h"
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+#include "drake/common/symbolic.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::symbolic::Environment;
+using drake::symbolic::Expression;
+using drake::symbolic::Substitution;
+using Eigen::VectorXd;
+
+/// Total cost of the program at its initial guess
+double EvalTotalCost(const Dircon<double>& trajopt) {
+  double total = 0;
+  for (const auto& binding : trajopt.GetAllCosts()) {
+    total += trajopt.EvalBindingAtInitialGuess(binding)(0);
+  }
+  return total;
+}
+
+/// The trapezoidal integral of g over every mode, written out symbolically in
+/// terms of the decision variables, as the placeholder substitution does
+Expression TrapezoidalIntegral(const Dircon<double>& trajopt,
+                               const Expression& g) {
+  Expression integral = 0;
+  int mode_start = 0;
+  for (int mode = 0; mode < trajopt.num_modes(); mode++) {
+    const int n = trajopt.mode_length(mode);
+    for (int j = 0; j < n; j++) {
+      Substitution s;
+      for (int k = 0; k < trajopt.num_states(); k++) {
+        s.emplace(trajopt.state()(k), trajopt.state_vars(mode, j)(k));
+      }
+      for (int k = 0; k < trajopt.num_inputs(); k++) {
+        s.emplace(trajopt.input()(k), trajopt.input_vars(mode, j)(k));
+      }
+      const int i = mode_start + j;
+      Expression weight = 0;
+      if (j > 0) {
+        weight += trajopt.timestep(i - 1)(0) / 2;
+      }
+      if (j < n - 1) {
+        weight += trajopt.timestep(i)(0) / 2;
+      }
+      integral += g.Substitute(s) * weight;
+    }
+    // Consecutive modes share a knot point
+    mode_start += n - 1;
+  }
+  return integral;
+}
+
+using RunningCost =
+    std::function<Expression(const drake::solvers::VectorXDecisionVariable&,
+                             const drake::solvers::VectorXDecisionVariable&)>;
+
+/// A quadratic in x and u with diagonal, cross, linear and constant terms
+Expression Quadratic(const drake::solvers::VectorXDecisionVariable& x,
+                     const drake::solvers::VectorXDecisionVariable& u) {
+  Expression g = 2.0;
+  for (int i = 0; i < x.size(); i++) {
+    g += (i + 1) * (x(i) - 0.1 * i) * (x(i) - 0.1 * i);
+  }
+  for (int i = 0; i < u.size(); i++) {
+    g += 3 * u(i) * u(i) + u(i);
+  }
+  g += x(0) * u(0) - 4 * x(1) * x(x.size() - 1);
+  return g;
+}
+
+/// Compares the running cost added to the program with the symbolic integral,
+/// at a random value of every decision variable. The cost is built from the
+/// placeholder variables of the program it is added to.
+void ExpectRunningCostMatchesIntegral(const RunningCost& running_cost) {
+  // Two modes, so that the second one starts at post-impact velocities
+  auto problem = MakePlanarWalkerSwingProblem({4, 3});
+  auto& trajopt = *problem->trajopt;
+  std::srand(42);
+  const VectorXd z = VectorXd::Random(trajopt.num_vars());
+  trajopt.SetInitialGuessForAllVariables(z);
+  const double base_cost = EvalTotalCost(trajopt);
+
+  const Expression g = running_cost(trajopt.state(), trajopt.input());
+  trajopt.AddRunningCost(g);
+  const double cost = EvalTotalCost(trajopt) - base_cost;
+
+  Environment env;
+  const auto& vars = trajopt.decision_variables();
+  for (int i = 0; i < vars.size(); i++) {
+    env.insert(vars(i), z(i));
+  }
+  const double expected = TrapezoidalIntegral(trajopt, g).Evaluate(env);
+  EXPECT_NEAR(cost, expected, 1e-10 * (1 + std::abs(expected)));
+}
+
+GTEST_TEST(DirconRunningCostTest, QuadraticCostMatchesSymbolicIntegral) {
+  ExpectRunningCostMatchesIntegral(Quadratic);
+}
+
+GTEST_TEST(DirconRunningCostTest, CubicCostMatchesSymbolicIntegral) {
+  // Not quadratic, so added through placeholder substitution
+  ExpectRunningCostMatchesIntegral(
+      [](const drake::solvers::VectorXDecisionVariable& x,
+         const drake::solvers::VectorXDecisionVariable& u) {
+        return Quadratic(x, u) + x(0) * x(0) * x(1);
+      });
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
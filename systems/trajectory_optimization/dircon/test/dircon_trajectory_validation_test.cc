@@ -0,0 +1,88 @@
+#include "systems/trajectory_optimization/dircon/dircon_trajectory_validation.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+#include "lcm/dircon_saved_trajectory.h"
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+#include "drake/solvers/solve.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using std::string;
+
+string TempPath(const string& name) {
+  const char* directory = std::getenv("TEST_TMPDIR");
+  return directory ? string(directory) + "/" + name : name;
+}
+
+std::unique_ptr<DirconProblem> MakeProblem() {
+  return MakePlanarWalkerSwingProblem({5});
+}
+
+GTEST_TEST(DirconTrajectoryValidationTest, ValidAndInvalidFiles) {
+  const string directory = TempPath("dircon_trajectory_validation");
+  mkdir(directory.c_str(), 0755);
+
+  // A solution of the program, and the same solution with a perturbed knot
+  // point, which breaks the dynamics
+  auto problem = MakeProblem();
+  auto result = drake::solvers::Solve(*problem->trajopt);
+  ASSERT_TRUE(result.is_success());
+  const double cost = result.get_optimal_cost();
+  DirconTrajectory(*problem->plant, *problem->trajopt, result, "swing", "")
+      .WriteToFile(directory + "/a_solution");
+  Eigen::VectorXd perturbed = result.GetSolution();
+  const auto x = problem->trajopt->state_vars(0, 2);
+  perturbed(problem->trajopt->FindDecisionVariableIndex(x(0))) += 0.5;
+  result.set_x_val(perturbed);
+  DirconTrajectory(*problem->plant, *problem->trajopt, result, "swing", "")
+      .WriteToFile(directory + "/b_perturbed");
+
+  // A solution of a program with more knot points
+  auto other = MakePlanarWalkerSwingProblem({7});
+  const auto other_result = drake::solvers::Solve(*other->trajopt);
+  DirconTrajectory(*other->plant, *other->trajopt, other_result, "swing", "")
+      .WriteToFile(directory + "/c_other_program");
+
+  // Not a trajectory
+  std::ofstream(directory + "/d_corrupt") << "not a trajectory";
+
+  const auto validations =
+      ValidateDirconTrajectories(directory, MakeProblem, false, 2);
+  ASSERT_EQ(validations.size(), 4);
+  EXPECT_EQ(validations[0].filepath, directory + "/a_solution");
+  EXPECT_TRUE(validations[0].is_valid);
+  EXPECT_TRUE(validations[0].error.empty());
+  EXPECT_TRUE(validations[0].report.is_satisfied(1e-4));
+  EXPECT_NEAR(validations[0].cost, cost, 1e-6);
+
+  EXPECT_TRUE(validations[1].is_valid);
+  EXPECT_GT(validations[1].report.max_violation, 1e-2);
+
+  EXPECT_FALSE(validations[2].is_valid);
+  EXPECT_NE(validations[2].error.find("decision variables"), string::npos)
+      << validations[2].error;
+
+  EXPECT_FALSE(validations[3].is_valid);
+  EXPECT_FALSE(validations[3].error.empty());
+
+  EXPECT_THROW(ValidateDirconTrajectories(directory + "/missing", MakeProblem),
+               std::runtime_error);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
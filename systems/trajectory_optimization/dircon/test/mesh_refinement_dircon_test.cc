@@ -0,0 +1,105 @@
+#include "systems/trajectory_optimization/dircon/mesh_refinement_dircon.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::solvers::MathematicalProgramResult;
+using Eigen::VectorXd;
+
+GTEST_TEST(MeshRefinementDirconTest, ExactTrajectoryHasNoError) {
+  // Without gravity or contact, a uniform translation of the whole walker
+  // satisfies the dynamics, and the cubic interpolant reproduces it exactly
+  auto problem = MakePlanarWalkerSwingProblem({5, 4});
+  const auto& plant = *problem->plant;
+  const auto& trajopt = *problem->trajopt;
+  const auto positions = multibody::makeNameToPositionsMap(plant);
+  const auto velocities = multibody::makeNameToVelocitiesMap(plant);
+  const int nq = plant.num_positions();
+  const double h = 0.1;
+  const double vx = 0.3;
+  const double vz = -0.2;
+
+  VectorXd z = VectorXd::Zero(trajopt.num_vars());
+  for (int i = 0; i < trajopt.N() - 1; i++) {
+    z(trajopt.FindDecisionVariableIndex(trajopt.timestep(i)(0))) = h;
+  }
+  // Consecutive modes share a knot point
+  int mode_start = 0;
+  for (int mode = 0; mode < trajopt.num_modes(); mode++) {
+    for (int j = 0; j < trajopt.mode_length(mode); j++) {
+      const double t = (mode_start + j) * h;
+      const auto x = trajopt.state_vars(mode, j);
+      z(trajopt.FindDecisionVariableIndex(x(positions.at("planar_x")))) =
+          vx * t;
+      z(trajopt.FindDecisionVariableIndex(x(positions.at("planar_z")))) =
+          vz * t;
+      z(trajopt.FindDecisionVariableIndex(
+          x(nq + velocities.at("planar_xdot")))) = vx;
+      z(trajopt.FindDecisionVariableIndex(
+          x(nq + velocities.at("planar_zdot")))) = vz;
+    }
+    mode_start += trajopt.mode_length(mode) - 1;
+  }
+  MathematicalProgramResult result;
+  result.set_decision_variable_index(trajopt.decision_variable_index());
+  result.set_x_val(z);
+
+  const auto error = EstimateCollocationError(trajopt, result);
+  ASSERT_EQ(error.size(), 2);
+  EXPECT_EQ(error[0].size(), 4);
+  EXPECT_EQ(error[1].size(), 3);
+  for (const auto& error_i : error) {
+    EXPECT_LT(error_i.maxCoeff(), 1e-12);
+  }
+
+  // Doubling the velocity of one knot point breaks the dynamics in the two
+  // intervals next to it, and only there
+  z(trajopt.FindDecisionVariableIndex(trajopt.state_vars(0, 2)(
+      nq + velocities.at("planar_xdot")))) = 2 * vx;
+  result.set_x_val(z);
+  const auto perturbed = EstimateCollocationError(trajopt, result);
+  EXPECT_LT(perturbed[0](0), 1e-12);
+  EXPECT_GT(perturbed[0](1), 1e-3);
+  EXPECT_GT(perturbed[0](2), 1e-3);
+  EXPECT_LT(perturbed[0](3), 1e-12);
+  EXPECT_LT(perturbed[1].maxCoeff(), 1e-12);
+}
+
+GTEST_TEST(MeshRefinementDirconTest, RefinementLoop) {
+  MeshRefinementOptions options;
+  options.tolerance = 1e-4;
+  options.max_knotpoints_per_mode = 40;
+  // Enough refinements to reach either the tolerance or the cap
+  options.max_refinements = 10;
+  auto factory = [](const std::vector<int>& num_knotpoints) {
+    return MakePlanarWalkerSwingProblem(num_knotpoints, 1.0);
+  };
+
+  MeshRefinementDircon refinement(factory, {4}, options);
+  const auto& result = refinement.Solve();
+  ASSERT_TRUE(result.is_success());
+
+  // Every refinement adds knot points, until the error is within tolerance
+  // or the cap is reached
+  const int num_knotpoints = refinement.get_knotpoints()[0];
+  EXPECT_GT(num_knotpoints, 4);
+  EXPECT_LE(num_knotpoints, options.max_knotpoints_per_mode);
+  if (num_knotpoints < options.max_knotpoints_per_mode) {
+    EXPECT_LE(refinement.get_error_estimate()[0].maxCoeff(),
+              options.tolerance);
+  }
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
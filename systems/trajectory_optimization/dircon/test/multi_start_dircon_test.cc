@@ -0,0 +1,99 @@
+#include "systems/trajectory_optimization/dircon/multi_start_dircon.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+std::unique_ptr<DirconProblem> MakeProblem() {
+  return MakePlanarWalkerSwingProblem({5});
+}
+
+MultiStartOptions CheapOptions() {
+  MultiStartOptions options;
+  options.num_starts = 4;
+  options.num_threads = 2;
+  options.iterations_per_round = 1;
+  options.max_rounds = 3;
+  options.perturbation_scale = 0.5;
+  return options;
+}
+
+GTEST_TEST(MultiStartDirconTest, RoundsAreCapped) {
+  MultiStartOptions options = CheapOptions();
+  // Never cancel, so that every unfinished start runs until the cap
+  options.cancel_ratio = std::numeric_limits<double>::infinity();
+  MultiStartDircon runner(&MakeProblem, options);
+  const int best = runner.Run();
+  EXPECT_EQ(best, runner.best_index());
+
+  const auto& results = runner.get_results();
+  ASSERT_EQ(results.size(), 4);
+  EXPECT_EQ(results[0].source, "nominal");
+  for (const auto& result : results) {
+    if (&result != &results[0]) {
+      EXPECT_EQ(result.source, "perturbed");
+    }
+    EXPECT_FALSE(result.is_cancelled);
+    EXPECT_GE(result.rounds, 1);
+    EXPECT_LE(result.rounds, options.max_rounds);
+    // Converged starts are not solved again, the others use every round
+    if (!result.is_success) {
+      EXPECT_EQ(result.rounds, options.max_rounds);
+    }
+    EXPECT_GT(result.solve_time, 0);
+  }
+
+  // The best start is the cheapest successful one, or the least violated
+  for (const auto& result : results) {
+    if (results[best].is_success) {
+      if (result.is_success) {
+        EXPECT_GE(result.cost, results[best].cost);
+      }
+    } else {
+      EXPECT_FALSE(result.is_success);
+      EXPECT_GE(std::max(result.constraint_violation,
+                         options.violation_tolerance),
+                std::max(results[best].constraint_violation,
+                         options.violation_tolerance));
+    }
+  }
+}
+
+GTEST_TEST(MultiStartDirconTest, LaggingStartsAreCancelled) {
+  MultiStartOptions options = CheapOptions();
+  // Every unfinished start behind the best after a round is cancelled
+  options.cancel_ratio = 1;
+  options.perturbation_scale = 5;
+  MultiStartDircon runner(&MakeProblem, options);
+  runner.Run();
+
+  const auto& results = runner.get_results();
+  int num_cancelled = 0;
+  int min_cancelled_rounds = options.max_rounds;
+  for (const auto& result : results) {
+    if (result.is_cancelled) {
+      num_cancelled++;
+      min_cancelled_rounds = std::min(min_cancelled_rounds, result.rounds);
+      EXPECT_FALSE(result.is_success);
+      EXPECT_GT(result.constraint_violation, options.violation_tolerance);
+    }
+  }
+  // The perturbed starts lag far behind the nominal one after one iteration,
+  // and are not solved again once cancelled
+  EXPECT_GT(num_cancelled, 0);
+  EXPECT_LT(min_cancelled_rounds, options.max_rounds);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
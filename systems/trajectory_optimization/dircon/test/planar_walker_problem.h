@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/find_resource.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/multibody_utils.h"
+#include "systems/trajectory_optimization/dircon/dircon_problem.h"
+
+#include "drake/common/trajectories/piecewise_polynomial.h"
+#include "drake/math/rigid_transform.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// A cheap Dircon problem for tests: the PlanarWalker, without gravity or
+/// contacts, swinging its hip from rest at zero to rest at hip_angle.
+///
+/// Every mode is a flight mode lasting mode_duration, so mode transitions
+/// carry post-impact velocity variables but no impact. The program has a
+/// quadratic running cost on the input and a straight-line initial guess.
+/// @param num_knotpoints The number of knot points of each mode
+/// @param constrain_initial_state Whether to fix the initial state at zero
+inline std::unique_ptr<DirconProblem> MakePlanarWalkerSwingProblem(
+    const std::vector<int>& num_knotpoints, double hip_angle = 0.5,
+    double mode_duration = 0.5, bool constrain_initial_state = true) {
+  auto problem = std::make_unique<DirconProblem>();
+  problem->plant = std::make_unique<drake::multibody::MultibodyPlant<double>>(
+      0.0);
+  auto& plant = *problem->plant;
+  drake::multibody::Parser parser(&plant);
+  parser.AddModelFromFile(
+      FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf"));
+  plant.WeldFrames(plant.world_frame(), plant.GetFrameByName("base"),
+                   drake::math::RigidTransform<double>());
+  plant.mutable_gravity_field().set_gravity_vector(Eigen::Vector3d::Zero());
+  plant.Finalize();
+
+  auto evaluators =
+      std::make_shared<multibody::KinematicEvaluatorSet<double>>(plant);
+  problem->owned_objects.push_back(evaluators);
+  problem->mode_sequence = std::make_unique<DirconModeSequence<double>>(plant);
+  for (int n : num_knotpoints) {
+    auto mode = std::make_shared<DirconMode<double>>(*evaluators, n,
+                                                     mode_duration,
+                                                     mode_duration);
+    problem->owned_objects.push_back(mode);
+    problem->mode_sequence->AddMode(mode.get());
+  }
+  problem->trajopt = std::make_unique<Dircon<double>>(*problem->mode_sequence);
+  auto& trajopt = *problem->trajopt;
+
+  const int nq = plant.num_positions();
+  const int nx = nq + plant.num_velocities();
+  Eigen::VectorXd x0 = Eigen::VectorXd::Zero(nx);
+  Eigen::VectorXd xf = x0;
+  const int hip = multibody::makeNameToPositionsMap(plant).at("hip_pin");
+  xf(hip) = hip_angle;
+  if (constrain_initial_state) {
+    trajopt.AddBoundingBoxConstraint(x0, x0, trajopt.initial_state());
+  }
+  trajopt.AddBoundingBoxConstraint(hip_angle, hip_angle,
+                                   trajopt.final_state()(hip));
+  trajopt.AddBoundingBoxConstraint(Eigen::VectorXd::Zero(nx - nq),
+                                   Eigen::VectorXd::Zero(nx - nq),
+                                   trajopt.final_state().tail(nx - nq));
+
+  auto u = trajopt.input();
+  trajopt.AddRunningCost(u.transpose() * u);
+
+  const double duration = mode_duration * num_knotpoints.size();
+  Eigen::MatrixXd states(nx, 2);
+  states << x0, xf;
+  trajopt.SetInitialTrajectory(
+      drake::trajectories::PiecewisePolynomial<double>::ZeroOrderHold(
+          Eigen::Vector2d(0, duration),
+          Eigen::MatrixXd::Zero(plant.num_actuators(), 2)),
+      drake::trajectories::PiecewisePolynomial<double>::FirstOrderHold(
+          Eigen::Vector2d(0, duration), states));
+  return problem;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
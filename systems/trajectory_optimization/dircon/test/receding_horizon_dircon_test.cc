@@ -0,0 +1,128 @@
+#include "systems/trajectory_optimization/dircon/receding_horizon_dircon.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon/test/planar_walker_problem.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/solvers/snopt_solver.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::CompareMatrices;
+using Eigen::VectorXd;
+
+class RecedingHorizonDirconTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Only the plant and the mode sequence are used, the planner builds its
+    // own program
+    problem_ = MakePlanarWalkerSwingProblem({6});
+    planner_ = std::make_unique<RecedingHorizonDircon<double>>(
+        *problem_->mode_sequence, drake::solvers::SnoptSolver::id());
+    auto& trajopt = planner_->get_mutable_trajopt();
+    auto u = trajopt.input();
+    trajopt.AddRunningCost(u.transpose() * u);
+    // Both programs are built from the same sequence, so their decision
+    // variables are in the same order
+    trajopt.SetInitialGuessForAllVariables(problem_->trajopt->initial_guess());
+    num_states_ = trajopt.num_states();
+  }
+
+  int CountInitialStateBindings() const {
+    const auto& trajopt = planner_->get_trajopt();
+    int count = 0;
+    for (const auto& binding : trajopt.bounding_box_constraints()) {
+      if (binding.variables().size() == num_states_ &&
+          binding.variables()(0).equal_to(trajopt.initial_state()(0))) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  std::unique_ptr<DirconProblem> problem_;
+  std::unique_ptr<RecedingHorizonDircon<double>> planner_;
+  int num_states_;
+};
+
+TEST_F(RecedingHorizonDirconTest, SetInitialStateUpdatesBoundsInPlace) {
+  const auto& trajopt = planner_->get_trajopt();
+  const int num_constraints = trajopt.GetAllConstraints().size();
+
+  const VectorXd x0 = VectorXd::LinSpaced(num_states_, 0, 0.1);
+  planner_->SetInitialState(x0);
+  EXPECT_EQ(trajopt.GetAllConstraints().size(), num_constraints + 1);
+  ASSERT_EQ(CountInitialStateBindings(), 1);
+  const auto binding = trajopt.bounding_box_constraints().back();
+  EXPECT_TRUE(CompareMatrices(binding.evaluator()->lower_bound(), x0));
+  EXPECT_TRUE(CompareMatrices(binding.evaluator()->upper_bound(), x0));
+
+  const VectorXd x1 = -x0;
+  planner_->SetInitialState(x1);
+  EXPECT_EQ(trajopt.GetAllConstraints().size(), num_constraints + 1);
+  EXPECT_EQ(CountInitialStateBindings(), 1);
+  // The same evaluator now holds the new bounds
+  EXPECT_TRUE(CompareMatrices(binding.evaluator()->lower_bound(), x1));
+  EXPECT_TRUE(CompareMatrices(binding.evaluator()->upper_bound(), x1));
+}
+
+TEST_F(RecedingHorizonDirconTest, ShiftInitialGuessByOneWindow) {
+  // A guess with a known state trajectory: the hip angle equals the time
+  auto& trajopt = planner_->get_mutable_trajopt();
+  const int hip = multibody::makeNameToPositionsMap(*problem_->plant)
+                      .at("hip_pin");
+  const int hipdot = problem_->plant->num_positions() +
+                     multibody::makeNameToVelocitiesMap(*problem_->plant)
+                         .at("hip_pindot");
+  const int num_knotpoints = trajopt.mode_length(0);
+  const double h = 0.5 / (num_knotpoints - 1);
+  drake::solvers::MathematicalProgramResult result;
+  result.set_decision_variable_index(trajopt.decision_variable_index());
+  VectorXd z = VectorXd::Zero(trajopt.num_vars());
+  for (int i = 0; i < num_knotpoints; i++) {
+    const auto x = trajopt.state_vars(0, i);
+    z(trajopt.FindDecisionVariableIndex(x(hip))) = i * h;
+    // A constant velocity, so that the interpolant is linear in the hip angle
+    z(trajopt.FindDecisionVariableIndex(x(hipdot))) = 1;
+  }
+  for (int i = 0; i < num_knotpoints - 1; i++) {
+    z(trajopt.FindDecisionVariableIndex(trajopt.timestep(i)(0))) = h;
+  }
+  result.set_x_val(z);
+
+  // Shifting by one interval moves every knot point to the next one, and
+  // holds the last
+  planner_->ShiftInitialGuess(result, h);
+  const VectorXd guess = trajopt.initial_guess();
+  for (int i = 0; i < num_knotpoints; i++) {
+    const int knot =
+        trajopt.FindDecisionVariableIndex(trajopt.state_vars(0, i)(hip));
+    EXPECT_NEAR(guess(knot), std::min(i + 1, num_knotpoints - 1) * h, 1e-10);
+  }
+}
+
+TEST_F(RecedingHorizonDirconTest, RepeatedSolvesKeepOneBinding) {
+  planner_->SetMaxIterations(5);
+  VectorXd x0 = VectorXd::Zero(num_states_);
+  for (int i = 0; i < 3; i++) {
+    x0(0) = 0.01 * i;
+    planner_->SetInitialState(x0);
+    planner_->Solve();
+    EXPECT_EQ(planner_->num_solves(), i + 1);
+    EXPECT_EQ(CountInitialStateBindings(), 1);
+    planner_->ShiftInitialGuess(0.1);
+  }
+  EXPECT_GT(planner_->last_solve_time(), 0);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib